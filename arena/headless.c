@@ -0,0 +1,310 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include "utilities/text.h"
+#include "assembler/assembly.h"
+#include "assembler/assemble.h"
+#include "parser/parse.h"
+#include "arena/simulation.h"
+#include "arena/map.h"
+#include "arena/replay.h"
+#include "arena/snapshot.h"
+
+#define DEFAULT_MAX_TICKS (SIMULATION_DEFAULT_TICKS_PER_SECOND * 60 * 5)
+
+
+bool tryLoadProgram(const char* filePath, uint8_t* memoryOut, TextContents* textOut);
+bool tryLoadMap(const char* filePath, ArenaMap* mapOut);
+bool tryParseTickCount(const char* arg, uint64_t* ticksOut);
+const char* getBattleEndReasonName(BattleEndReason reason);
+void printUsage(const char* programName);
+
+
+Simulation simulation;
+ArenaMap map;
+Replay replay;
+ReplayRecorder replayRecorder;
+ReplayPlayer replayPlayer;
+
+
+int main(int argc, char* argv[]) {
+  // Get command line arguments
+  const char* assemblyFilePaths[SIMULATION_MAX_ROBOTS] = { 0 };
+  size_t assemblyFileCount = 0;
+  uint64_t maxTicks = DEFAULT_MAX_TICKS;
+  uint64_t stallWindowTicks = SIMULATION_DEFAULT_STALL_WINDOW_TICKS;
+  uint64_t instructionsPerPhysicsStep = SIMULATION_DEFAULT_INSTRUCTIONS_PER_PHYSICS_STEP;
+  bool useFixedPoint = false;
+  const char* mapFilePath = NULL;
+  const char* outputMapFilePath = NULL;
+  const char* recordFilePath = NULL;
+  const char* replayFilePath = NULL;
+  const char* resumeFilePath = NULL;
+  const char* checkpointFilePath = NULL;
+  uint64_t checkpointIntervalTicks = 0;
+  uint64_t stopTick = 0;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--max-ticks") == 0 && i + 1 < argc) {
+      if (!tryParseTickCount(argv[++i], &maxTicks)) {
+        printUsage(argv[0]);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--stall-ticks") == 0 && i + 1 < argc) {
+      if (!tryParseTickCount(argv[++i], &stallWindowTicks)) {
+        printUsage(argv[0]);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--physics-ratio") == 0 && i + 1 < argc) {
+      if (!tryParseTickCount(argv[++i], &instructionsPerPhysicsStep) || instructionsPerPhysicsStep == 0 || instructionsPerPhysicsStep > UINT_MAX) {
+        printUsage(argv[0]);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--map") == 0 && i + 1 < argc) {
+      mapFilePath = argv[++i];
+    } else if (strcmp(argv[i], "--write-map") == 0 && i + 1 < argc) {
+      outputMapFilePath = argv[++i];
+    } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      recordFilePath = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      replayFilePath = argv[++i];
+    } else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+      resumeFilePath = argv[++i];
+    } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+      checkpointFilePath = argv[++i];
+    } else if (strcmp(argv[i], "--checkpoint-ticks") == 0 && i + 1 < argc) {
+      if (!tryParseTickCount(argv[++i], &checkpointIntervalTicks)) {
+        printUsage(argv[0]);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--stop-at") == 0 && i + 1 < argc) {
+      if (!tryParseTickCount(argv[++i], &stopTick)) {
+        printUsage(argv[0]);
+        return 1;
+      }
+    } else if (strcmp(argv[i], "--fixed-point") == 0) {
+      useFixedPoint = true;
+    } else if (argv[i][0] != '-' && assemblyFileCount < SIMULATION_MAX_ROBOTS) {
+      assemblyFilePaths[assemblyFileCount++] = argv[i];
+    } else {
+      printUsage(argv[0]);
+      return 1;
+    }
+  }
+  if (resumeFilePath != NULL) {
+    if (assemblyFileCount != 0 || mapFilePath != NULL || outputMapFilePath != NULL || recordFilePath != NULL || replayFilePath != NULL) {
+      printUsage(argv[0]);
+      return 1;
+    }
+  } else if (replayFilePath != NULL) {
+    if (assemblyFileCount != 0 || mapFilePath != NULL || outputMapFilePath != NULL || recordFilePath != NULL) {
+      printUsage(argv[0]);
+      return 1;
+    }
+  } else if (assemblyFileCount != SIMULATION_MAX_ROBOTS && (outputMapFilePath == NULL || assemblyFileCount != 0)) {
+    printUsage(argv[0]);
+    return 1;
+  }
+
+  // Load the map
+  if (mapFilePath != NULL) {
+    if (!tryLoadMap(mapFilePath, &map)) {
+      return 1;
+    }
+  } else {
+    map = InitDefaultArenaMap();
+  }
+
+  // Convert the map to its binary form with a prebaked index instead of running a battle, if requested
+  if (outputMapFilePath != NULL) {
+    if (!map.hasDistanceField) {
+      BakeArenaMapDistanceField(&map);
+    }
+    if (!TrySaveArenaMapBinary(&map, outputMapFilePath)) {
+      fprintf(stderr, "Failed to write map file %s.\n", outputMapFilePath);
+      return 1;
+    }
+    if (assemblyFileCount == 0) {
+      return 0;
+    }
+  }
+
+  // Setup simulation. Battles are stepped as fast as possible, so the timer runs on a virtual clock.
+  simulation = (Simulation){
+    .host.timer = InitTimerWithSource(0, 0, InitVirtualTimeSource()),
+    .physicsWorld.useFixedPoint = useFixedPoint,
+    .physicsWorld.useContinuousCollision = true,
+    .physicsWorld.useStaticDistanceField = true,
+    .instructionsPerPhysicsStep = (unsigned int)instructionsPerPhysicsStep,
+    .maxTicks = maxTicks,
+    .stallWindowTicks = stallWindowTicks,
+  };
+
+  // Resume a saved battle or play back a recorded battle instead of running new programs, if requested
+  if (resumeFilePath != NULL) {
+    const char* snapshotError;
+    if (!TryLoadSimulationSnapshot(resumeFilePath, &simulation, &snapshotError)) {
+      fprintf(stderr, "Failed to load snapshot file %s: %s.\n", resumeFilePath, snapshotError);
+      return 1;
+    }
+  } else if (replayFilePath != NULL) {
+    const char* replayError;
+    if (!TryLoadReplay(replayFilePath, &replay, &replayError)) {
+      fprintf(stderr, "Failed to load replay file %s: %s.\n", replayFilePath, replayError);
+      return 1;
+    }
+    ApplyReplayToSimulation(&replay, &simulation);
+    replayPlayer = InitReplayPlayer(&replay);
+    simulation.host.replayPlayer = &replayPlayer;
+  } else {
+    ApplyArenaMapToSimulation(&map, &simulation);
+  }
+  if (recordFilePath != NULL) {
+    InitReplay(&replay, &simulation, &map);
+    replayRecorder = InitReplayRecorder(&replay);
+    simulation.host.replayRecorder = &replayRecorder;
+  }
+
+  // Load assembly programs into robot memory
+  for (size_t i = 0; i < assemblyFileCount; i++) {
+    TextContents text;
+    if (!tryLoadProgram(assemblyFilePaths[i], simulation.robots[i].processState.memory, &text)) {
+      return 1;
+    }
+    bool success = recordFilePath == NULL || TrySetReplayProgramText(&replay, i, &text);
+    DestroyTextContents(&text);
+    if (!success) {
+      fprintf(stderr, "Failed to initialize replay.\n");
+      return 1;
+    }
+  }
+
+  // Run the battle to completion or the requested stopping point, saving checkpoints along the way.
+  // A resumed simulation was already prepared before it was saved.
+  if (resumeFilePath == NULL) {
+    PrepSimulation(&simulation);
+  }
+  unsigned int maxResolverIterations = 0;
+  while (!simulation.battleEnded && (stopTick == 0 || simulation.tickCount < stopTick)) {
+    StepSimulation(&simulation);
+    if (simulation.physicsWorld.resolverIterations > maxResolverIterations) {
+      maxResolverIterations = simulation.physicsWorld.resolverIterations;
+    }
+    if (checkpointFilePath != NULL && checkpointIntervalTicks > 0 && simulation.tickCount % checkpointIntervalTicks == 0
+        && !TrySaveSimulationSnapshot(&simulation, checkpointFilePath)) {
+      fprintf(stderr, "Failed to write snapshot file %s.\n", checkpointFilePath);
+      return 1;
+    }
+  }
+  if (checkpointFilePath != NULL && !TrySaveSimulationSnapshot(&simulation, checkpointFilePath)) {
+    fprintf(stderr, "Failed to write snapshot file %s.\n", checkpointFilePath);
+    return 1;
+  }
+
+  // Report the outcome
+  if (!simulation.battleEnded) {
+    printf("Result: undecided\n");
+  } else if (simulation.battleDrawn) {
+    printf("Result: draw\n");
+  } else {
+    printf("Result: robot %zu wins\n", simulation.winningRobotIndex + 1);
+  }
+  printf("Reason: %s\n", getBattleEndReasonName(simulation.battleEndReason));
+  printf("Ticks: %llu\n", (unsigned long long)simulation.tickCount);
+  for (size_t i = 0; i < simulation.robotCount; i++) {
+    printf("Robot %zu energy: %d\n", i + 1, simulation.robots[i].energyRemaining);
+  }
+  printf("Max resolver iterations: %u\n", maxResolverIterations);
+
+  // Save the recorded battle
+  if (recordFilePath != NULL) {
+    FinishReplayRecording(&replayRecorder, &simulation);
+    if (replayRecorder.hasFailed || !TrySaveReplay(&replay, recordFilePath)) {
+      fprintf(stderr, "Failed to write replay file %s.\n", recordFilePath);
+      return 1;
+    }
+  }
+  DestroyReplay(&replay);
+
+  return 0;
+}
+
+
+bool tryLoadProgram(const char* filePath, uint8_t* memoryOut, TextContents* textOut) {
+  TextContents text;
+  if (!TryInitTextContentsFromFile(filePath, &text)) {
+    fprintf(stderr, "Failed to read assembly file %s.\n", filePath);
+    return false;
+  }
+
+  AssemblyProgram program;
+  ParsingErrorList parsingErrors = { 0 };
+  if (!TryParseAssemblyProgram(&text, &program, &parsingErrors)) {
+    fprintf(stderr, "Failed to parse assembly file %s:\n", filePath);
+    for (size_t i = 0; i < parsingErrors.errorCount; i++) {
+      fprintf(stderr, "Line %zu, column %zu: %s.\n",
+        parsingErrors.errors[i].sourceSpan.start.line + 1,
+        parsingErrors.errors[i].sourceSpan.start.column + 1,
+        parsingErrors.errors[i].message);
+    }
+    DestroyTextContents(&text);
+    return false;
+  }
+
+  AssemblingError assemblingError = { 0 };
+  bool success = TryAssembleProgram(&text, &program, memoryOut, &assemblingError);
+  if (!success) {
+    fprintf(stderr, "Failed to assemble assembly file %s:\nLine %zu, column %zu: %s.\n", filePath,
+      assemblingError.sourceSpan.start.line + 1,
+      assemblingError.sourceSpan.start.column + 1,
+      assemblingError.message);
+  }
+
+  DestroyAssemblyProgram(&program);
+  if (success) {
+    *textOut = text;
+  } else {
+    DestroyTextContents(&text);
+  }
+  return success;
+}
+
+bool tryLoadMap(const char* filePath, ArenaMap* mapOut) {
+  ArenaMapError mapError;
+  if (!TryLoadArenaMap(filePath, mapOut, &mapError)) {
+    if (mapError.line > 0) {
+      fprintf(stderr, "Failed to load map file %s:\nLine %zu: %s.\n", filePath, mapError.line, mapError.message);
+    } else {
+      fprintf(stderr, "Failed to load map file %s: %s.\n", filePath, mapError.message);
+    }
+    return false;
+  }
+  return true;
+}
+
+bool tryParseTickCount(const char* arg, uint64_t* ticksOut) {
+  char* end;
+  unsigned long long ticks = strtoull(arg, &end, 10);
+  if (*arg == '\0' || *end != '\0') {
+    return false;
+  }
+  *ticksOut = ticks;
+  return true;
+}
+
+const char* getBattleEndReasonName(BattleEndReason reason) {
+  switch (reason) {
+    case BATTLE_END_ELIMINATION: return "elimination";
+    case BATTLE_END_TICK_LIMIT: return "tick limit";
+    case BATTLE_END_STALL: return "stall";
+    default: return "none";
+  }
+}
+
+void printUsage(const char* programName) {
+  fprintf(stderr, "Usage: %s <assembly file A> <assembly file B> [--map <map file>] [--max-ticks <n>] [--stall-ticks <n>] [--physics-ratio <n>] [--fixed-point] [--record <replay file>]\n", programName);
+  fprintf(stderr, "       %s --replay <replay file>\n", programName);
+  fprintf(stderr, "       %s --resume <snapshot file>\n", programName);
+  fprintf(stderr, "Any run also accepts [--stop-at <tick>] [--checkpoint <snapshot file>] [--checkpoint-ticks <n>]\n");
+  fprintf(stderr, "       %s [--map <map file>] --write-map <binary map file>\n", programName);
+}
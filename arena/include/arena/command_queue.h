@@ -0,0 +1,64 @@
+#pragma once
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The number of commands that a command queue can hold. Must be a power of two.
+#define SIMULATION_COMMAND_QUEUE_CAPACITY 64
+
+
+// The kinds of command that can be sent to the thread running a simulation.
+typedef enum {
+  SIMULATION_COMMAND_SET_SPEED,      // Changes the simulation's speed to ticksPerSec.
+  SIMULATION_COMMAND_STEP,           // Advances the simulation by stepCount steps, regardless of its speed.
+  SIMULATION_COMMAND_SEEK,           // Moves the simulation along its timeline by tickOffset steps.
+  SIMULATION_COMMAND_RELOAD_PROGRAM, // Replaces a program's memory image and restarts the processors running it.
+  SIMULATION_COMMAND_RESET,          // Restarts the battle from the beginning.
+  SIMULATION_COMMAND_SET_USER_KEYS,  // Changes the keys held by the user to userKeys.
+} SimulationCommandKind;
+
+// A command sent to the thread running a simulation, to be applied between steps.
+typedef struct {
+  // The kind of the command.
+  SimulationCommandKind kind;
+  union {
+    // The new speed (kind == SIMULATION_COMMAND_SET_SPEED)
+    int64_t ticksPerSec;
+    // The number of steps to advance (kind == SIMULATION_COMMAND_STEP)
+    uint64_t stepCount;
+    // The number of steps to move forward, or back if negative (kind == SIMULATION_COMMAND_SEEK)
+    int64_t tickOffset;
+    // The program to load (kind == SIMULATION_COMMAND_RELOAD_PROGRAM)
+    struct {
+      // The index of the program to replace, as numbered by the sender. Every robot running it is reloaded.
+      size_t programIndex;
+      // The program's memory image of MEMORY_SIZE bytes, allocated with malloc. Freed by the thread that pops it.
+      uint8_t* memory;
+    } reload;
+    // The SimulationUserKey flags of the keys held (kind == SIMULATION_COMMAND_SET_USER_KEYS)
+    unsigned int userKeys;
+  };
+} SimulationCommand;
+
+// A bounded queue that passes commands from one producing thread to one consuming thread without locking.
+typedef struct {
+  // The ring of commands, indexed by push and pop counts modulo the capacity.
+  SimulationCommand commands[SIMULATION_COMMAND_QUEUE_CAPACITY];
+  // The number of commands pushed so far. Only written by the producer.
+  _Atomic size_t pushCount;
+  // The number of commands popped so far. Only written by the consumer.
+  _Atomic size_t popCount;
+} SimulationCommandQueue;
+
+
+// Initializes an empty command queue.
+void InitSimulationCommandQueue(SimulationCommandQueue* queue);
+
+// Attempts to add a command to the back of the queue. Must only be called from the producing thread.
+// Returns false without adding the command if the queue is full.
+bool TryPushSimulationCommand(SimulationCommandQueue* queue, SimulationCommand command);
+
+// Attempts to take the command at the front of the queue. Must only be called from the consuming thread.
+// If successful, outputs the command and returns true. Otherwise, returns false if the queue is empty.
+bool TryPopSimulationCommand(SimulationCommandQueue* queue, SimulationCommand* commandOut);
@@ -0,0 +1,120 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Fixed-point arithmetic used by the deterministic simulation mode.
+// Every operation is implemented with integer arithmetic, so results are bit-identical on every target.
+
+// The number of fractional bits in a fixed-point number.
+#define FIXED_FRACTION_BITS 16
+
+// A signed fixed-point number with 16 integer bits and 16 fractional bits (Q16.16).
+typedef int32_t Fixed;
+
+#define FIXED_ONE      ((Fixed)1 << FIXED_FRACTION_BITS)
+#define FIXED_MAX      INT32_MAX
+#define FIXED_EPSILON  ((Fixed)1)
+#define FIXED_PI       ((Fixed)205887)
+#define FIXED_TWO_PI   ((Fixed)411775)
+#define FIXED_SQRT1_2  ((Fixed)46341)
+
+// A two-dimensional vector of fixed-point numbers.
+typedef struct {
+  Fixed x, y;
+} FixedVector2;
+
+// Converts a floating-point number to fixed-point, truncating towards zero. Saturates to +/-FIXED_MAX if the value
+// is out of range, and converts NaN to zero.
+static inline Fixed FixedFromFloat(float value) {
+  float scaled = value * (float)FIXED_ONE;
+  if (scaled >= 2147483648.0f) { return FIXED_MAX; }
+  if (scaled <= -2147483648.0f) { return -FIXED_MAX; }
+  if (scaled != scaled) { return 0; }
+  return (Fixed)scaled;
+}
+
+// Converts a fixed-point number to the nearest floating-point number.
+static inline float FixedToFloat(Fixed value) {
+  return (float)value / (float)FIXED_ONE;
+}
+
+// Converts an integer to fixed-point.
+static inline Fixed FixedFromInt(int32_t value) {
+  return (Fixed)(value * FIXED_ONE);
+}
+
+// Multiplies two fixed-point numbers.
+static inline Fixed FixedMul(Fixed a, Fixed b) {
+  return (Fixed)(((int64_t)a * b) >> FIXED_FRACTION_BITS);
+}
+
+// Divides two fixed-point numbers. Saturates to +/-FIXED_MAX if b is zero or the result would overflow.
+static inline Fixed FixedDiv(Fixed a, Fixed b) {
+  if (b == 0) { return a < 0 ? -FIXED_MAX : FIXED_MAX; }
+  int64_t result = ((int64_t)a * FIXED_ONE) / b;
+  if (result > FIXED_MAX) { return FIXED_MAX; }
+  if (result < -FIXED_MAX) { return -FIXED_MAX; }
+  return (Fixed)result;
+}
+
+// Computes the absolute value of a fixed-point number.
+static inline Fixed FixedAbs(Fixed value) {
+  return value < 0 ? -value : value;
+}
+
+// Computes the square of a fixed-point number with 32 fractional bits, which cannot overflow.
+static inline int64_t FixedSquareWide(Fixed value) {
+  return (int64_t)value * value;
+}
+
+// Computes the square root of a non-negative number with 32 fractional bits (as returned by FixedSquareWide).
+// Returns the result as a fixed-point number, saturating to FIXED_MAX.
+Fixed FixedSqrtWide(int64_t value);
+
+// Computes the sine of an angle in radians.
+Fixed FixedSin(Fixed angle);
+
+// Computes the cosine of an angle in radians.
+Fixed FixedCos(Fixed angle);
+
+// Wraps an angle in radians into the range [0, 2*pi).
+Fixed FixedWrapAngle(Fixed angle);
+
+
+// Converts a floating-point vector to fixed-point.
+static inline FixedVector2 FixedVector2FromFloat(float x, float y) {
+  return (FixedVector2){ FixedFromFloat(x), FixedFromFloat(y) };
+}
+
+// Adds two fixed-point vectors.
+static inline FixedVector2 FixedVector2Add(FixedVector2 a, FixedVector2 b) {
+  return (FixedVector2){ a.x + b.x, a.y + b.y };
+}
+
+// Subtracts two fixed-point vectors.
+static inline FixedVector2 FixedVector2Subtract(FixedVector2 a, FixedVector2 b) {
+  return (FixedVector2){ a.x - b.x, a.y - b.y };
+}
+
+// Scales a fixed-point vector.
+static inline FixedVector2 FixedVector2Scale(FixedVector2 v, Fixed scale) {
+  return (FixedVector2){ FixedMul(v.x, scale), FixedMul(v.y, scale) };
+}
+
+// Computes the dot product of two fixed-point vectors.
+static inline Fixed FixedVector2Dot(FixedVector2 a, FixedVector2 b) {
+  return (Fixed)(((int64_t)a.x * b.x + (int64_t)a.y * b.y) >> FIXED_FRACTION_BITS);
+}
+
+// Computes the squared length of a fixed-point vector with 32 fractional bits.
+static inline int64_t FixedVector2LengthSqrWide(FixedVector2 v) {
+  return FixedSquareWide(v.x) + FixedSquareWide(v.y);
+}
+
+// Rotates a fixed-point vector by the angle whose cosine and sine are given.
+static inline FixedVector2 FixedVector2RotateCosSin(FixedVector2 v, Fixed cosAngle, Fixed sinAngle) {
+  return (FixedVector2){
+    (Fixed)(((int64_t)v.x * cosAngle - (int64_t)v.y * sinAngle) >> FIXED_FRACTION_BITS),
+    (Fixed)(((int64_t)v.x * sinAngle + (int64_t)v.y * cosAngle) >> FIXED_FRACTION_BITS),
+  };
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "arena/physics.h"
+#include "arena/simulation.h"
+
+#define MAP_MAX_OBSTACLES (MAX_PHYSICS_BODIES - SIMULATION_MAX_ROBOTS)
+#define MAP_MAX_SPAWNS 16
+
+// The first bytes of every binary map file.
+#define MAP_BINARY_MAGIC "EMAP"
+// The version of the binary map format written by TrySaveArenaMapBinary.
+#define MAP_BINARY_VERSION 2
+
+extern const char MAP_FILE_UNREADABLE[];
+extern const char MAP_FILE_TRUNCATED[];
+extern const char MAP_UNSUPPORTED_VERSION[];
+extern const char MAP_INVALID_LINE[];
+extern const char MAP_INVALID_NUMBER[];
+extern const char MAP_INVALID_BOUNDARY[];
+extern const char MAP_INVALID_OBSTACLE[];
+extern const char MAP_TOO_MANY_OBSTACLES[];
+extern const char MAP_TOO_MANY_SPAWNS[];
+extern const char MAP_TOO_FEW_SPAWNS[];
+extern const char MAP_SPAWN_OUT_OF_BOUNDS[];
+extern const char MAP_INVALID_INDEX[];
+extern const char MAP_INDEX_MISMATCH[];
+
+// A static obstacle placed in a map.
+typedef struct {
+  // The position of the obstacle in world-space coordinates.
+  Vector2 position;
+  // The rotation of the obstacle in radians.
+  float rotation;
+  // The obstacle's collider.
+  PhysicsCollider collider;
+} MapObstacle;
+
+// A point at which a robot starts a battle.
+typedef struct {
+  // The position of the robot in world-space coordinates.
+  Vector2 position;
+  // The rotation of the robot in radians.
+  float rotation;
+} MapSpawn;
+
+// The layout of an arena.
+typedef struct {
+  // The boundary in which robots are confined.
+  Rectangle boundary;
+
+  // The number of obstacles in the map.
+  unsigned int obstacleCount;
+  // The array of obstacles in the map.
+  MapObstacle obstacles[MAP_MAX_OBSTACLES];
+
+  // The number of spawn points in the map. Robots are placed at the first spawn points in order.
+  unsigned int spawnCount;
+  // The array of spawn points in the map.
+  MapSpawn spawns[MAP_MAX_SPAWNS];
+
+  // Whether distanceField holds a prebaked index of the map's static geometry.
+  bool hasDistanceField;
+  // The distance field for the boundary and obstacles, as baked by BakeArenaMapDistanceField.
+  PhysicsDistanceField distanceField;
+} ArenaMap;
+
+// An error that occurred while loading a map.
+typedef struct {
+  // The message describing the error. Should be a string with a static lifetime.
+  const char* message;
+  // The line of a text map at which the error occurred, starting from 1, or 0 if the error isn't tied to a line.
+  size_t line;
+} ArenaMapError;
+
+
+// Gets the map used when no other map is given: a square arena with two walls and a spawn point on each side.
+ArenaMap InitDefaultArenaMap(void);
+
+// Attempts to load a map from the binary or text file at the given path, telling them apart by the binary magic.
+// The file is mapped into memory rather than read where the platform supports it, so that a large prebaked index
+// is loaded with a single copy. If successful, outputs the map and returns true.
+// Otherwise, outputs the cause through error and returns false.
+bool TryLoadArenaMap(const char* filePath, ArenaMap* mapOut, ArenaMapError* error);
+
+// Attempts to parse a map from its text form. Each non-empty line that isn't a '#' comment is one of:
+//   boundary <x> <y> <width> <height>
+//   rectangle <x> <y> <width> <height> [<rotation in degrees>]
+//   circle <x> <y> <radius>
+//   spawn <x> <y> [<rotation in degrees>]
+// If successful, outputs the map and returns true. Otherwise, outputs the cause through error and returns false.
+bool TryParseArenaMapText(const char* text, size_t length, ArenaMap* mapOut, ArenaMapError* error);
+
+// Attempts to read a map from its binary form. An index is used as stored, and the map is rejected if the geometry
+// hash in its header does not match the boundary and obstacles it was read with.
+// If successful, outputs the map and returns true. Otherwise, outputs the cause through error and returns false.
+bool TryReadArenaMapBinary(const uint8_t* bytes, size_t length, ArenaMap* mapOut, ArenaMapError* error);
+
+// Attempts to write a map in its binary form to the file at the given path, including its index if it has one.
+// Returns whether the file was written successfully.
+bool TrySaveArenaMapBinary(const ArenaMap* map, const char* filePath);
+
+// Attempts to write a map in its binary form to the current position of an open file, including its index if it has one.
+// Returns whether the map was written successfully.
+bool TryWriteArenaMapBinary(const ArenaMap* map, FILE* file);
+
+// Bakes the map's boundary and obstacles into its distance field, so that saving it also saves the index.
+void BakeArenaMapDistanceField(ArenaMap* map);
+
+// Sets the boundary of the simulation's physics world and adds the map's obstacles and a robot at each of the first
+// SIMULATION_MAX_ROBOTS spawn points. If the map has an index and the world uses a static distance field, the index
+// is used as the world's field so that PrepSimulation doesn't need to bake it.
+void ApplyArenaMapToSimulation(const ArenaMap* map, Simulation* simulation);
@@ -1,7 +1,10 @@
 #pragma once
+#include <stdint.h>
 #include <raylib.h>
 
 #define MAX_PHYSICS_BODIES 16
+#define MAX_PHYSICS_CONTACTS (MAX_PHYSICS_BODIES * (MAX_PHYSICS_BODIES - 1) / 2)
+#define PHYSICS_DISTANCE_FIELD_MAX_CELLS 64
 
 // A kind of physics collider.
 typedef enum {
@@ -27,6 +30,9 @@ typedef struct {
   PhysicsCollider collider;
   // Whether or not the body is static (i.e., unaffected by other bodies).
   bool isStatic;
+  // Whether or not the body is asleep (i.e., at rest and not touching anything), which lets StepPhysicsWorld skip
+  // it until it is given a velocity or another body collides with it.
+  bool isAsleep;
 
   // The position of the body in world-space coordinates.
   Vector2 position;
@@ -39,16 +45,84 @@ typedef struct {
   float angularVelocity;
 } PhysicsBody;
 
+// A contact between a pair of physics bodies.
+typedef struct {
+  // Whether the bodies collided during the last step.
+  bool isActive;
+  // The direction in which the first body of the pair was last found to be penetrating the second.
+  Vector2 normal;
+} PhysicsContact;
+
+// A coarse grid of distances to the static geometry of a physics world (its boundary and static bodies), which lets
+// collision checks and raycasts skip static geometry that is out of reach without testing it exactly.
+typedef struct {
+  // Whether the field holds the current static geometry. Cleared whenever a static body is changed.
+  bool isBaked;
+  // The world-space position of the first grid node.
+  Vector2 origin;
+  // The distance between neighboring grid nodes along each axis.
+  float cellSize;
+  // The number of grid nodes along the x axis.
+  unsigned int columnCount;
+  // The number of grid nodes along the y axis.
+  unsigned int rowCount;
+  // The signed distance from each grid node to the nearest static surface in row-major order,
+  // which is negative inside static bodies and outside the boundary.
+  float distances[(PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1) * (PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1)];
+} PhysicsDistanceField;
+
 // A physics world containing zero or more bodies.
 typedef struct {
   // The boundary in which physics bodies are confined.
   Rectangle boundary;
+  // Whether to simulate the world using fixed-point arithmetic, which produces bit-identical results on every target.
+  // Body state is still stored as floating-point numbers, but is converted to and from fixed-point for each operation.
+  bool useFixedPoint;
+  // Whether dynamic circular bodies are swept along their displacement each step so that they stop at and slide
+  // along the world boundary and static rectangular bodies instead of tunneling through them at large time steps.
+  // Not supported in fixed-point worlds.
+  bool useContinuousCollision;
+  // Whether the static geometry should be baked into staticDistanceField once it is in place, so that bodies and rays
+  // far from any static surface skip testing it. Results are unchanged. Not supported in fixed-point worlds.
+  bool useStaticDistanceField;
   
   // The number of physics bodies being simulated.
   unsigned int bodyCount;
   // The array of physics bodies being simulated.
   PhysicsBody bodies[MAX_PHYSICS_BODIES];
+
+  // The contacts between each pair of bodies as of the last step, indexed by GetPhysicsContactIndex.
+  // Pairs that were in contact are resolved first in the next step, since they are the most likely to still be.
+  PhysicsContact contacts[MAX_PHYSICS_CONTACTS];
+  // The number of resolver iterations used in the last step, including the final iteration that found nothing left to resolve.
+  unsigned int resolverIterations;
+
+  // The distance field for the static geometry, if baked by BakePhysicsDistanceField.
+  PhysicsDistanceField staticDistanceField;
+
+  // A counter that is incremented whenever any body is added, moved, or rotated.
+  uint64_t version;
+  // The value of version when each body was last added, moved, or rotated.
+  uint64_t bodyVersions[MAX_PHYSICS_BODIES];
 } PhysicsWorld;
 
+// Gets the index into PhysicsWorld.contacts of the contact between the bodies with the given indices, where bodyIndexA < bodyIndexB.
+unsigned int GetPhysicsContactIndex(unsigned int bodyIndexA, unsigned int bodyIndexB);
+
 // Simulates the given physics world for a single step.
 void StepPhysicsWorld(PhysicsWorld* world, double deltaTimeSeconds);
+
+// Bakes the world's boundary and static bodies into its distance field. The field is cleared when a static body is
+// changed through MarkPhysicsBodyChanged, and must be baked again if the boundary changes. Does nothing in fixed-point worlds.
+void BakePhysicsDistanceField(PhysicsWorld* world);
+
+// Gets a lower bound on the distance from the given position to the nearest static surface of the world, using its
+// distance field. Returns zero or less if the position may be touching static geometry or the field is not baked.
+float GetPhysicsStaticDistanceBound(const PhysicsWorld* world, Vector2 position);
+
+// Gets the radius of the smallest circle around a body's position that contains its collider.
+float GetPhysicsBodyBoundingRadius(const PhysicsBody* body);
+
+// Records that a body was added or modified outside of StepPhysicsWorld by incrementing the world's version,
+// wakes the body if it is asleep, and clears the world's distance field if the body is static.
+void MarkPhysicsBodyChanged(PhysicsWorld* world, unsigned int bodyIndex);
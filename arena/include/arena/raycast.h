@@ -1,4 +1,5 @@
 #pragma once
+#include <stddef.h>
 #include "arena/physics.h"
 
 // The type of intersection that occurred as the result of a raycast.
@@ -20,4 +21,10 @@ typedef struct {
   int bodyIndex;
 } RaycastResult;
 
+// Computes the nearest intersection between a ray and the bodies or boundary of a physics world.
 RaycastResult ComputeRaycast(const PhysicsWorld* world, Vector2 origin, Vector2 direction);
+
+// Computes the nearest intersection for each ray in a batch, as if by calling ComputeRaycast once per ray.
+// Rays are intersected with each body several at a time using SIMD lanes where the target supports them.
+// The origins, directions, and resultsOut arrays must each contain rayCount elements.
+void ComputeRaycastBatch(const PhysicsWorld* world, size_t rayCount, const Vector2* origins, const Vector2* directions, RaycastResult* resultsOut);
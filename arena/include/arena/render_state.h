@@ -0,0 +1,128 @@
+#pragma once
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "processor/instruction.h"
+#include "arena/simulation.h"
+
+// The number of render states in a render state buffer: one being written, one being read, and one waiting between.
+#define RENDER_STATE_BUFFER_COUNT 3
+// Set in a render state buffer's shared index when the state there was published after the reader last acquired one.
+#define RENDER_STATE_FRESH_FLAG 0x80000000u
+// The largest number of ticks between two states that are interpolated. States further apart, such as either side of
+// a seek, are jumped between.
+#define RENDER_STATE_MAX_INTERPOLATED_TICKS (SIMULATION_DEFAULT_TICKS_PER_SECOND / 2)
+
+
+// The parts of a robot needed to draw it and its state panel.
+typedef struct {
+  // The position of the robot's body in world-space coordinates.
+  Vector2 position;
+  // The rotation of the robot's body in radians.
+  float rotation;
+
+  // The amount of energy that the robot has left.
+  int energyRemaining;
+  // The number of simulation steps until the robot's weapon is ready to use.
+  int weaponCooldownRemaining;
+  // The start and end points of the robot's last weapon fire.
+  struct {
+    Vector2 start, end;
+  } lastWeaponFire;
+  // The start and end points of the robot's last sensor reading.
+  struct {
+    Vector2 start, end;
+  } lastSensorReading;
+
+  // The registers of the robot's processor.
+  RegistersState registers;
+  // The instruction at the robot's instruction pointer.
+  Instruction nextInstruction;
+} RobotRenderState;
+
+// An immutable copy of the parts of a simulation needed to draw it, taken at the end of an update.
+typedef struct {
+  // The number of steps simulated when the state was captured.
+  uint64_t tickCount;
+  // The simulation's speed when the state was captured.
+  int64_t ticksPerSec;
+
+  // The boundary in which the physics bodies are confined.
+  Rectangle boundary;
+  // The number of physics bodies.
+  unsigned int bodyCount;
+  // A copy of each physics body.
+  PhysicsBody bodies[MAX_PHYSICS_BODIES];
+
+  // The number of robots.
+  size_t robotCount;
+  // Each robot as it should be drawn.
+  RobotRenderState robots[SIMULATION_MAX_ROBOTS];
+
+  // Whether or not the battle has ended.
+  bool battleEnded;
+  // If battleEnded is true, the way the battle ended.
+  BattleEndReason battleEndReason;
+  // If battleEnded is true, whether the battle ended without a winner.
+  bool battleDrawn;
+  // If battleEnded is true and battleDrawn is false, the index of the winning robot.
+  size_t winningRobotIndex;
+} RenderState;
+
+// A triple buffer through which one thread publishes render states and another thread reads the latest one, without
+// either thread waiting on the other. The writer always has a state of its own to fill in, the reader keeps the state
+// it acquired until it acquires another, and the third state holds whichever state was published last.
+typedef struct {
+  // The states being exchanged.
+  RenderState states[RENDER_STATE_BUFFER_COUNT];
+  // The index of the state between the writer and the reader, combined with RENDER_STATE_FRESH_FLAG.
+  _Atomic uint32_t sharedIndex;
+  // The index of the state owned by the writer.
+  uint32_t writeIndex;
+  // The index of the state owned by the reader.
+  uint32_t readIndex;
+} RenderStateBuffer;
+
+// The two most recent states that a reader has seen, between which it draws the simulation so that motion stays
+// smooth however rarely states are published.
+typedef struct {
+  // The state drawn when the latest state was acquired, which the drawn state moves on from.
+  RenderState previous;
+  // The latest state acquired from the buffer.
+  RenderState latest;
+  // The reader's time, in nanoseconds, when the latest state was acquired.
+  int64_t latestTime;
+} RenderStateHistory;
+
+
+// Initializes an empty render state buffer, in which every state reads as a simulation with no bodies.
+void InitRenderStateBuffer(RenderStateBuffer* buffer);
+
+// Copies the parts of the simulation needed to draw it into the buffer's writer-owned state, and publishes it as the
+// latest state. Must only be called from the writing thread.
+void PublishRenderState(RenderStateBuffer* buffer, const Simulation* simulation);
+
+// Gets the latest published state, which stays unchanged until the next call. Must only be called from the reading
+// thread.
+const RenderState* AcquireRenderState(RenderStateBuffer* buffer);
+
+// Attempts to acquire a state published since the reader last acquired one. If there is one, outputs it and returns
+// true. Otherwise, leaves stateOut unchanged and returns false. Must only be called from the reading thread.
+bool TryAcquireNewRenderState(RenderStateBuffer* buffer, const RenderState** stateOut);
+
+// Initializes an empty render state history, in which both states read as a simulation with no bodies.
+void InitRenderStateHistory(RenderStateHistory* history);
+
+// Acquires the latest published state from the buffer at the reader's given time in nanoseconds. If it is new, the
+// state drawn at that time becomes the previous state. Must only be called from the reading thread.
+void UpdateRenderStateHistory(RenderStateHistory* history, RenderStateBuffer* buffer, int64_t time);
+
+// Outputs the state to draw at the reader's given time in nanoseconds. Body and robot positions and rotations are
+// interpolated from the previous state towards the latest one at the simulation's speed, and everything else is taken
+// from whichever of the two is nearer. Outputs the latest state when the two aren't from the same continuous stretch
+// of the battle, or when the simulation is paused.
+void InterpolateRenderState(const RenderStateHistory* history, int64_t time, RenderState* stateOut);
+
+// Copies the parts of the simulation needed to draw it into a render state.
+void CaptureRenderState(const Simulation* simulation, RenderState* stateOut);
@@ -0,0 +1,116 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "utilities/text.h"
+#include "arena/robot.h"
+#include "arena/simulation.h"
+#include "arena/map.h"
+
+// The first bytes of every replay file.
+#define REPLAY_MAGIC "ERPL"
+// The version of the replay format written by TrySaveReplay.
+#define REPLAY_VERSION 1
+
+extern const char REPLAY_FILE_UNREADABLE[];
+extern const char REPLAY_FILE_TRUNCATED[];
+extern const char REPLAY_UNSUPPORTED_VERSION[];
+extern const char REPLAY_INVALID_SETTINGS[];
+extern const char REPLAY_INVALID_MAP[];
+extern const char REPLAY_OUT_OF_MEMORY[];
+
+// A recording of a battle that holds only what crosses the boundary between robot processors and the world:
+// the settings and map the battle started from, and the controls written by each robot on every step.
+// The programs are kept for reference only, since replaying a battle doesn't run them.
+typedef struct {
+  // The number of robots in the battle.
+  unsigned int robotCount;
+  // The simulation settings that affect the outcome of the battle.
+  unsigned int instructionsPerPhysicsStep;
+  uint64_t maxTicks;
+  uint64_t stallWindowTicks;
+  bool useFixedPoint;
+  bool useContinuousCollision;
+  // The map the battle was fought on, without its index.
+  ArenaMap map;
+
+  // The source text of each robot's program, or NULL if it isn't known.
+  char* programTexts[SIMULATION_MAX_ROBOTS];
+  // The length of each robot's program text.
+  size_t programTextLengths[SIMULATION_MAX_ROBOTS];
+
+  // The number of steps that were recorded.
+  uint64_t tickCount;
+  // The way the battle ended, or BATTLE_END_NONE if it was still going when the recording finished.
+  BattleEndReason battleEndReason;
+
+  // The recorded controls. Each change to the controls is stored as the number of steps without a change
+  // before it, followed by a bit mask of the control bytes that changed and the difference in each of them.
+  uint8_t* controlStream;
+  // The number of bytes in controlStream.
+  size_t controlStreamLength;
+  // The number of bytes allocated for controlStream.
+  size_t controlStreamCapacity;
+} Replay;
+
+// The state of a replay being recorded.
+typedef struct ReplayRecorder {
+  // The replay being recorded.
+  Replay* replay;
+  // The controls as of the last change written to the replay.
+  RobotControls lastControls[SIMULATION_MAX_ROBOTS];
+  // The number of steps since the last change written to the replay.
+  uint64_t unchangedTickCount;
+  // Whether the replay ran out of memory, in which case it can't be saved.
+  bool hasFailed;
+} ReplayRecorder;
+
+// The state of a replay being played back.
+typedef struct ReplayPlayer {
+  // The replay being played back.
+  const Replay* replay;
+  // The offset of the next change in the replay's control stream.
+  size_t streamOffset;
+  // Whether the step count before the next change has been read.
+  bool hasPendingChange;
+  // The number of steps left before the next change, if hasPendingChange.
+  uint64_t ticksUntilChange;
+  // The controls as of the last change that was played back.
+  RobotControls controls[SIMULATION_MAX_ROBOTS];
+} ReplayPlayer;
+
+
+// Initializes an empty replay with the settings and robot count of a simulation and the map it was set up from.
+void InitReplay(Replay* replayOut, const Simulation* simulation, const ArenaMap* map);
+
+// Destroys a replay, freeing its programs and control stream.
+void DestroyReplay(Replay* replay);
+
+// Attempts to store a copy of the given program source text in a replay. Returns false if out of memory.
+bool TrySetReplayProgramText(Replay* replay, size_t robotIndex, const TextContents* programText);
+
+// Attempts to save a replay to the file at the given path. Returns whether the file was written successfully.
+bool TrySaveReplay(const Replay* replay, const char* filePath);
+
+// Attempts to load a replay from the file at the given path.
+// If successful, outputs the replay and returns true. Otherwise, outputs the cause through error and returns false.
+bool TryLoadReplay(const char* filePath, Replay* replayOut, const char** error);
+
+// Applies a replay's settings and map to an empty simulation, so that it matches the one that was recorded.
+void ApplyReplayToSimulation(const Replay* replay, Simulation* simulation);
+
+// Initializes a recorder that appends to the given empty replay.
+ReplayRecorder InitReplayRecorder(Replay* replay);
+
+// Appends the controls applied by each robot during a step to the recorder's replay.
+void RecordReplayTick(ReplayRecorder* recorder, const RobotControls* controls);
+
+// Stores the outcome of the recorded battle in the recorder's replay.
+void FinishReplayRecording(ReplayRecorder* recorder, const Simulation* simulation);
+
+// Initializes a player for the given replay.
+ReplayPlayer InitReplayPlayer(const Replay* replay);
+
+// Outputs the controls for each robot for the next step of the replay. Once every recorded step has been played
+// back, the last controls are repeated.
+void ReadReplayTick(ReplayPlayer* player, RobotControls* controlsOut);
@@ -1,14 +1,66 @@
 #pragma once
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <raylib.h>
 #include "processor/process.h"
 #include "arena/physics.h"
+#include "arena/raycast.h"
 
 #define ROBOT_RADIUS                50.0
 #define ROBOT_INITIAL_ENERGY        4000000
 #define ROBOT_WEAPON_COOLDOWN_STEPS 2048
+#define ROBOT_SCAN_MAX_RAYS         64
 
 
+// The inputs and outputs of a robot's last sensor raycast, used to skip raycasts that can't change the result.
+typedef struct {
+  // Whether the cache holds a previous reading.
+  bool isValid;
+  // The physics world version at which the reading was last known to be up to date.
+  uint64_t worldVersion;
+  // The sensor direction control used for the reading.
+  unsigned char sensorDirection;
+  // The ray used for the reading.
+  Vector2 rayOrigin, rayDirection;
+  // The distance along the ray beyond which other bodies can't affect the reading.
+  float relevantDistance;
+  // The index of the body that was detected, or -1 if no body was detected.
+  int detectedBodyIndex;
+  // The values written to the robot's sensor memory.
+  unsigned char distanceValue, kindValue;
+} RobotSensorCache;
+
+// The inputs and outputs of each ray of a robot's last scan, used to recast only the rays that moved bodies can affect.
+typedef struct {
+  // Whether the cache holds a previous scan.
+  bool isValid;
+  // The physics world version at which the scan was last known to be up to date.
+  uint64_t worldVersion;
+  // The number of rays in the scan.
+  unsigned char rayCount;
+  // The ray used for each reading.
+  Vector2 rayOrigins[ROBOT_SCAN_MAX_RAYS], rayDirections[ROBOT_SCAN_MAX_RAYS];
+  // The distance along each ray beyond which other bodies can't affect its reading.
+  float relevantDistances[ROBOT_SCAN_MAX_RAYS];
+  // The index of the body detected by each ray, or -1 if no body was detected.
+  int detectedBodyIndices[ROBOT_SCAN_MAX_RAYS];
+  // The values written to the robot's scan memory for each ray.
+  unsigned char distanceValues[ROBOT_SCAN_MAX_RAYS], kindValues[ROBOT_SCAN_MAX_RAYS];
+} RobotScanCache;
+
+// The values of a robot's control memory, which is the only way that a robot's program affects the world.
+typedef struct {
+  // The movement control, as a signed byte.
+  unsigned char move;
+  // The rotation control, as a signed byte.
+  unsigned char rotate;
+  // The weapon control.
+  unsigned char weapon;
+  // The sensor direction control, in 256ths of a full turn relative to the robot's rotation.
+  unsigned char sensorDirection;
+} RobotControls;
+
 typedef struct {
   // The index of the physics body representing this robot.
   size_t physicsBodyIndex;
@@ -28,21 +80,57 @@ typedef struct {
     Vector2 start, end;
   } lastSensorReading;
 
+  // The inputs and outputs of the robot's last sensor raycast.
+  RobotSensorCache sensorCache;
+  // The inputs and outputs of the robot's last scan.
+  RobotScanCache scanCache;
+
   // The state of the robot's processor.
   struct ProcessState processState;
 } Robot;
 
-// A callback to be invoked when a robot's weapon hits a physics body.
+// A hit by a robot's weapon on a physics body, to be resolved once every robot's controls have been applied.
 typedef struct {
-  void* context;
-  void (*func)(void* context, size_t physicsBodyIndex, int damageAmount);
-} WeaponDamageCallback;
+  // Whether the robot's weapon hit a body.
+  bool isHit;
+  // The index of the physics body that was hit, if isHit.
+  size_t physicsBodyIndex;
+  // The amount of energy the hit takes from the body's robot, if isHit.
+  int damageAmount;
+} WeaponHit;
 
 // Initializes a robot.
 Robot InitRobot(size_t physicsBodyIndex);
 
-// Steps the robot's internal simulation.
-void ApplyRobotControls(Robot* robot, PhysicsWorld* physicsWorld, WeaponDamageCallback weaponDamageCallback);
+// Reads the robot's controls from its control memory.
+RobotControls ReadRobotControls(const Robot* robot);
 
-// Updates the robot's sensor.
+// Writes the given controls to the robot's control memory.
+void WriteRobotControls(Robot* robot, RobotControls controls);
+
+// Steps the robot's internal simulation with the given controls, outputting any body hit by its weapon instead of
+// damaging it. Only modifies the robot and its own physics body, so robots can apply their controls in parallel.
+void ApplyRobotControls(Robot* robot, PhysicsWorld* physicsWorld, RobotControls controls, WeaponHit* weaponHitOut);
+
+// Updates the robot's sensor and scan.
 void UpdateRobotSensor(Robot* robot, PhysicsWorld* physicsWorld);
+
+// Computes the origin and direction of the robot's sensor ray from its pose and sensor direction control.
+void GetRobotSensorRay(const Robot* robot, const PhysicsWorld* physicsWorld, Vector2* originOut, Vector2* directionOut);
+
+// Rewrites the robot's previous sensor reading if no change to the physics world or sensor direction
+// since that reading could affect it. Returns true if successful, or false if a new raycast is required.
+bool TryReuseRobotSensorReading(Robot* robot, const PhysicsWorld* physicsWorld);
+
+// Updates the robot's sensor with the result of a raycast along the ray given by GetRobotSensorRay.
+void ApplyRobotSensorReading(Robot* robot, const PhysicsWorld* physicsWorld, Vector2 rayOrigin, Vector2 rayDirection, RaycastResult result);
+
+// Finds the rays of the robot's scan whose previous readings can't be reused, and rewrites the reused readings to the
+// robot's scan memory. A scan casts the number of rays given by the robot's scan control, evenly spaced around it.
+// When only other bodies have moved, just the rays in the angular sectors they cover need to be cast again.
+// Outputs the index, origin and direction of each ray to cast, which can hold up to ROBOT_SCAN_MAX_RAYS rays,
+// and returns the number of rays.
+size_t GetRobotScanRays(Robot* robot, const PhysicsWorld* physicsWorld, unsigned char* rayIndicesOut, Vector2* originsOut, Vector2* directionsOut);
+
+// Updates the robot's scan with the results of raycasts along the rays given by GetRobotScanRays.
+void ApplyRobotScanReadings(Robot* robot, const PhysicsWorld* physicsWorld, size_t rayCount, const unsigned char* rayIndices, const Vector2* origins, const Vector2* directions, const RaycastResult* results);
@@ -7,7 +7,65 @@
 
 #define SIMULATION_MAX_ROBOTS 2
 #define SIMULATION_DEFAULT_TICKS_PER_SECOND 1024
+#define SIMULATION_DEFAULT_STALL_WINDOW_TICKS (SIMULATION_DEFAULT_TICKS_PER_SECOND * 10)
+#define SIMULATION_DEFAULT_INSTRUCTIONS_PER_PHYSICS_STEP 4
+// The timer rate at which the simulation steps as fast as it can rather than following its timer.
+#define SIMULATION_MAX_SPEED_TICKS_PER_SECOND INT64_MAX
+#define SIMULATION_DEFAULT_MAX_SPEED_SLICE_NANOSECONDS 2000000
+#define SIMULATION_DEFAULT_ROBOTS_PER_TASK 1
 
+struct ThreadPool;
+struct ReplayRecorder;
+struct ReplayPlayer;
+struct Timeline;
+
+
+// The way a battle ended.
+typedef enum {
+  BATTLE_END_NONE,        // The battle has not ended.
+  BATTLE_END_ELIMINATION, // One or fewer robots are left standing.
+  BATTLE_END_TICK_LIMIT,  // The battle reached its maximum number of steps.
+  BATTLE_END_STALL,       // No robot's pose, energy or processor state changed over the stall window.
+} BattleEndReason;
+
+// The keys that the user can hold to override the controls of the first robot.
+typedef enum {
+  SIMULATION_USER_KEY_FORWARD  = 1 << 0, // Moves forward at full speed.
+  SIMULATION_USER_KEY_BACKWARD = 1 << 1, // Moves backward at full speed.
+  SIMULATION_USER_KEY_RIGHT    = 1 << 2, // Rotates right at full speed.
+  SIMULATION_USER_KEY_LEFT     = 1 << 3, // Rotates left at full speed.
+  SIMULATION_USER_KEY_FIRE     = 1 << 4, // Fires the weapon at full power.
+} SimulationUserKey;
+
+
+// The parts of a simulation that belong to the process running it rather than to its battle. They are kept when the
+// battle is replaced, such as when it restarts, resumes from a snapshot or seeks to a keyframe.
+typedef struct {
+  // Timer for tracking elapsed simulation time, where each tick represents a simulation step.
+  Timer timer;
+  // Whether a simulation step should occur on the next iteration regardless of how much time has elapsed.
+  bool forceStep;
+  // The time that each update spends stepping at maximum speed, in nanoseconds on the timer's clock.
+  // Zero is treated as SIMULATION_DEFAULT_MAX_SPEED_SLICE_NANOSECONDS.
+  int64_t maxSpeedSliceNanoseconds;
+  // The SimulationUserKey flags of the keys held by the user, which override the controls of the first robot.
+  unsigned int heldUserKeys;
+
+  // An optional recorder to which the controls applied on every step are appended.
+  struct ReplayRecorder* replayRecorder;
+  // An optional player from which the controls for every step are read instead of running the robot processors.
+  // While a replay is playing, keyboard overrides are ignored.
+  struct ReplayPlayer* replayPlayer;
+  // An optional timeline to which a keyframe is added every time the step count reaches a multiple of its interval.
+  struct Timeline* timeline;
+
+  // An optional thread pool used to run the per-robot phases of each step in parallel.
+  // If NULL, every phase runs on the thread updating the simulation.
+  struct ThreadPool* threadPool;
+  // The number of consecutive robots handled by each task of a per-robot phase. The results are the same for any
+  // number. Zero is treated as SIMULATION_DEFAULT_ROBOTS_PER_TASK.
+  size_t robotsPerTask;
+} SimulationHost;
 
 // The state of a simulation.
 typedef struct {
@@ -18,15 +76,45 @@ typedef struct {
   size_t robotCount;
   // The array of robots being simulated.
   Robot robots[SIMULATION_MAX_ROBOTS];
-  // Whether or not the battle has ended (one or fewer robots left standing).
+  // The number of steps simulated so far. Each step executes one instruction in every robot's processor.
+  uint64_t tickCount;
+  // The number of steps per physics step, with each physics step covering the time of all of its steps.
+  // Zero is treated as one.
+  unsigned int instructionsPerPhysicsStep;
+  // The number of steps after which the battle ends and is decided by remaining energy, or zero for no limit.
+  uint64_t maxTicks;
+  // The number of steps without any change in robot poses, energy or processor state after which the battle ends
+  // and is decided by remaining energy, or zero to disable stall detection.
+  uint64_t stallWindowTicks;
+
+  // Whether or not the battle has ended.
   bool battleEnded;
-  // If battleEnded is true, the index of the last surviving robot; otherwise, undefined.
-  size_t lastSurvivingRobotIndex;
+  // If battleEnded is true, the way the battle ended; otherwise, BATTLE_END_NONE.
+  BattleEndReason battleEndReason;
+  // If battleEnded is true, whether the battle ended without a winner.
+  bool battleDrawn;
+  // If battleEnded is true and battleDrawn is false, the index of the winning robot; otherwise, undefined.
+  size_t winningRobotIndex;
 
-  // Timer for tracking elapsed simulation time, where each tick represents a simulation step.
-  Timer timer;
-  // Whether a simulation step should occur on the next iteration regardless of how much time has elapsed.
-  bool forceStep;
+  // The step at which the current stall window started.
+  uint64_t stallWindowStartTick;
+  // A hash of the robot poses and energy since the start of the current stall window.
+  uint64_t stallPoseEnergyHash;
+  // Whether stallStateHash holds the robot state at the start of the current stall window.
+  bool isStallStateHashValid;
+  // A hash of the robot registers, memory, weapon cooldowns and velocities at the start of the current stall window,
+  // if isStallStateHashValid.
+  uint64_t stallStateHash;
+
+  // The weapon hit made by each robot during the current step, resolved once every robot's controls have been applied.
+  WeaponHit weaponHits[SIMULATION_MAX_ROBOTS];
+  // The index of the robot represented by each physics body, or -1 if the body isn't a robot.
+  int robotIndicesByBody[MAX_PHYSICS_BODIES];
+  // The controls applied by each robot during the most recent step.
+  RobotControls robotControls[SIMULATION_MAX_ROBOTS];
+
+  // The parts of the simulation that belong to the running process.
+  SimulationHost host;
 } Simulation;
 
 
@@ -39,5 +127,13 @@ void AddObstacleToSimulation(Simulation* simulation, Vector2 position, float rot
 // Prepares the simulation for the first update given the current set of robots and obstacles.
 void PrepSimulation(Simulation* simulation);
 
-// Updates the simulation by advancing the appropriate number of steps.
+// Updates the simulation by advancing the appropriate number of steps. At maximum speed, steps until the time slice
+// has passed instead, or for host.timer.maxTicks steps if the timer's clock is virtual and can't measure the slice.
 void UpdateSimulation(Simulation* simulation);
+
+// Advances the simulation by exactly one step, regardless of its timer.
+void StepSimulation(Simulation* simulation);
+
+// Replaces the battle in a simulation with a copy of the given one, or with an empty battle if it is NULL, keeping the
+// simulation's host.
+void ReplaceSimulationBattle(Simulation* simulation, const Simulation* battle);
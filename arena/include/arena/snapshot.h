@@ -0,0 +1,35 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "arena/simulation.h"
+
+// The first bytes of every snapshot file.
+#define SNAPSHOT_MAGIC "ESNP"
+// The version of the snapshot format written by TrySaveSimulationSnapshot.
+#define SNAPSHOT_VERSION 2
+// The size of the pages in which robot memory is stored. Pages that are entirely zero are left out.
+#define SNAPSHOT_PAGE_SIZE 256
+
+extern const char SNAPSHOT_FILE_UNREADABLE[];
+extern const char SNAPSHOT_FILE_TRUNCATED[];
+extern const char SNAPSHOT_UNSUPPORTED_VERSION[];
+extern const char SNAPSHOT_INCOMPATIBLE_LAYOUT[];
+extern const char SNAPSHOT_INVALID_STATE[];
+extern const char SNAPSHOT_OUT_OF_MEMORY[];
+
+
+// Attempts to save the full state of a simulation to the file at the given path, so that it can be resumed later.
+// The simulation is stored in its in-memory layout, followed by the non-zero pages of each robot's memory.
+// Returns whether the file was written successfully.
+bool TrySaveSimulationSnapshot(const Simulation* simulation, const char* filePath);
+
+// Attempts to load a simulation from the snapshot file at the given path. The file is mapped into memory rather than
+// read where the platform supports it. Snapshots can only be loaded by a build with the same simulation layout.
+// The simulation's host is kept, so anything attached to it should be reset for the loaded battle.
+// If successful, outputs the simulation and returns true.
+// Otherwise, leaves the simulation unchanged, outputs the cause through error and returns false.
+bool TryLoadSimulationSnapshot(const char* filePath, Simulation* simulation, const char** error);
+
+// Attempts to read a simulation from the bytes of a snapshot file, in the same way as TryLoadSimulationSnapshot.
+bool TryReadSimulationSnapshot(const uint8_t* bytes, size_t length, Simulation* simulation, const char** error);
@@ -0,0 +1,56 @@
+#pragma once
+#include <pthread.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define THREAD_POOL_MAX_THREADS 16
+
+
+// A function that runs one task out of a batch submitted to a thread pool.
+typedef void (*ThreadPoolTaskFunc)(void* context, size_t taskIndex);
+
+// A set of persistent threads that run batches of independent tasks, with the submitting thread joining in.
+typedef struct ThreadPool {
+  // A mutex protecting interactions with the pool state.
+  pthread_mutex_t stateMutex;
+  // Signaled when a new batch of tasks is submitted or the pool is stopping.
+  pthread_cond_t tasksAvailable;
+  // Signaled when the last task of the current batch finishes.
+  pthread_cond_t tasksFinished;
+
+  // The number of threads started by the pool, not including the submitting thread.
+  size_t threadCount;
+  // The pool's threads.
+  pthread_t threads[THREAD_POOL_MAX_THREADS];
+  // Whether the pool's threads should stop.
+  bool shouldStop;
+
+  // Incremented each time a batch is submitted, so that threads can tell a new batch from a spurious wakeup.
+  uint64_t batchGeneration;
+  // The function run for each task in the current batch.
+  ThreadPoolTaskFunc taskFunc;
+  // The pointer passed to each task in the current batch.
+  void* taskContext;
+  // The number of tasks in the current batch.
+  size_t taskCount;
+  // The index of the next task in the current batch that has not been claimed by a thread.
+  size_t nextTaskIndex;
+  // The number of tasks in the current batch that have not finished.
+  size_t unfinishedTaskCount;
+} ThreadPool;
+
+
+// Attempts to initialize a thread pool and start its threads. At most THREAD_POOL_MAX_THREADS threads are started.
+// If successful, returns true. Otherwise, returns false.
+bool TryInitThreadPool(ThreadPool* pool, size_t threadCount);
+
+// Stops the pool's threads and cleans up any system resources.
+void DestroyThreadPool(ThreadPool* pool);
+
+// Gets a thread count that leaves one hardware thread for the submitting thread.
+size_t GetDefaultThreadPoolThreadCount(void);
+
+// Runs taskFunc for every task index in [0, taskCount) across the pool's threads and the calling thread.
+// Returns once every task has finished, so consecutive calls act as barriers between phases.
+void RunThreadPoolTasks(ThreadPool* pool, size_t taskCount, ThreadPoolTaskFunc taskFunc, void* taskContext);
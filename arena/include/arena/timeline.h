@@ -0,0 +1,72 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "arena/simulation.h"
+#include "arena/replay.h"
+
+#define TIMELINE_MAX_KEYFRAMES 4096
+// The size of the pages in which changes to robot memory are stored between keyframes.
+#define TIMELINE_PAGE_SIZE 256
+#define TIMELINE_DEFAULT_INTERVAL_TICKS SIMULATION_DEFAULT_TICKS_PER_SECOND
+#define TIMELINE_DEFAULT_MEMORY_CAP_BYTES (64 * 1024 * 1024)
+
+
+// The state of a simulation at one step, stored relative to the next keyframe.
+typedef struct {
+  // The step at which the keyframe was taken.
+  uint64_t tickCount;
+  // The simulation without its robot memory, static distance field or host, along with the state of any replay player.
+  uint8_t* state;
+  // The number of pages of robot memory that differ between this keyframe and the next one.
+  size_t changedPageCount;
+  // The index of each of those pages, counting across the memory of every robot in order.
+  uint32_t* changedPageIndices;
+  // The contents of each of those pages as of this keyframe.
+  uint8_t* changedPages;
+} TimelineKeyframe;
+
+// A bounded history of a simulation that can be used to seek back to earlier steps. A keyframe is taken every
+// intervalTicks steps, and each keyframe holds only the pages of robot memory that change before the next one,
+// with the newest keyframe's memory kept in full. The oldest keyframes are dropped to stay under the memory cap.
+typedef struct Timeline {
+  // The number of steps between keyframes.
+  uint64_t intervalTicks;
+  // The number of bytes that keyframes may take before the oldest ones are dropped.
+  size_t memoryCapBytes;
+  // The number of bytes taken by keyframes.
+  size_t memoryUsedBytes;
+
+  // The index of the oldest keyframe in the ring of keyframes.
+  size_t firstKeyframeIndex;
+  // The number of keyframes in the ring.
+  size_t keyframeCount;
+  // The ring of keyframes, from oldest to newest starting at firstKeyframeIndex.
+  TimelineKeyframe keyframes[TIMELINE_MAX_KEYFRAMES];
+  // The robot memory as of the newest keyframe.
+  uint8_t* latestMemory;
+} Timeline;
+
+
+// Attempts to initialize an empty timeline with the given keyframe interval and memory cap.
+// Returns true if successful, or false if out of memory.
+bool TryInitTimeline(Timeline* timelineOut, uint64_t intervalTicks, size_t memoryCapBytes);
+
+// Destroys a timeline, freeing its keyframes.
+void DestroyTimeline(Timeline* timeline);
+
+// Drops every keyframe from a timeline, such as when the simulation it follows is restarted.
+void ClearTimeline(Timeline* timeline);
+
+// Adds a keyframe of the simulation's current state if it's newer than the newest keyframe, dropping the oldest
+// keyframes as needed to stay within the memory cap. Keyframes that can't be allocated are skipped.
+void CaptureTimelineKeyframe(Timeline* timeline, const Simulation* simulation);
+
+// Gets the earliest step that the timeline can seek to, or UINT64_MAX if it has no keyframes.
+uint64_t GetTimelineStartTick(const Timeline* timeline);
+
+// Attempts to move the simulation to the given step. Earlier steps are reached by restoring the newest keyframe
+// before them and simulating forward, which drops every keyframe after it. The simulation's host is kept, and a
+// replay being recorded is marked as failed since it can't be rewound.
+// Returns false without changing the simulation if the step is before the oldest keyframe.
+bool TrySeekTimeline(Timeline* timeline, Simulation* simulation, uint64_t tick);
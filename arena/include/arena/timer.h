@@ -1,22 +1,88 @@
 #pragma once
-#include <time.h>
 #include <stdint.h>
 
+#define TIMER_NANOSECONDS_PER_SECOND 1000000000
+
+// The kinds of clock that a timer can read the time from.
+typedef enum TimeSourceKind {
+  // The system's monotonic clock, which follows wall time and never jumps when the system time is changed.
+  TIME_SOURCE_MONOTONIC,
+  // A clock that only moves when it is advanced with AdvanceTimeSource.
+  TIME_SOURCE_VIRTUAL,
+  // A clock that moves forward by a fixed step each time it is read.
+  TIME_SOURCE_FIXED_STEP,
+} TimeSourceKind;
+
+// A clock that reports time in nanoseconds.
+typedef struct TimeSource {
+  TimeSourceKind kind;
+  // The current time of a virtual or fixed-step clock.
+  int64_t nanoseconds;
+  // The number of nanoseconds that a fixed-step clock moves forward on each reading.
+  int64_t stepNanoseconds;
+} TimeSource;
+
 // A timer used to track the passage of time.
 typedef struct Timer {
   int64_t ticksPerSec; // The number of ticks that should pass in one second.
-  int64_t maxTicks; // The maximum number of ticks the timer can hold.
+  int64_t maxTicks; // The maximum number of ticks the timer can hold. Ticks that would pass it are dropped.
+  TimeSource source; // The clock that the timer reads the time from.
 
-  clock_t _lastClock; // The clock reading when the timer was last updated.
+  int64_t _epochTime; // The time at which the timer started counting ticks at its current rate.
+  int64_t _epochTicksPerSec; // The rate at which ticks have been counted since the epoch.
+  int64_t _epochTicks; // The number of ticks that have passed between the epoch and the last update.
+  int64_t _lastTime; // The time when the timer was last updated.
   int64_t _lastTicks; // The tick count when the timer was last updated.
-  int64_t _lastRemainder; // The remainder of the last timer update.
 } Timer;
 
-// Initializes the timer such that the number of ticks elapsed is zero.
+// Measures the rate at which a count of ticks advances, averaged over windows of time.
+typedef struct TickRateMeter {
+  TimeSource source; // The clock that the meter reads the time from.
+  int64_t windowNanoseconds; // The length of the windows over which the rate is averaged.
+  double ticksPerSec; // The rate over the most recent complete window, or zero before the first one completes.
+
+  int64_t _windowStartTime; // The time at which the current window started.
+  uint64_t _windowStartTicks; // The tick count when the current window started.
+} TickRateMeter;
+
+// Initializes a time source that reads the system's monotonic clock.
+TimeSource InitMonotonicTimeSource();
+
+// Initializes a time source at time zero that only moves when advanced.
+TimeSource InitVirtualTimeSource();
+
+// Initializes a time source at time zero that moves forward by the given number of nanoseconds on each reading.
+TimeSource InitFixedStepTimeSource(int64_t stepNanoseconds);
+
+// Reads the current time of a time source in nanoseconds.
+int64_t ReadTimeSource(TimeSource* source);
+
+// Moves a virtual or fixed-step time source forward by the given number of nanoseconds.
+void AdvanceTimeSource(TimeSource* source, int64_t nanoseconds);
+
+// Initializes the timer on the monotonic clock such that the number of ticks elapsed is zero.
 Timer InitTimer(int64_t ticksPerSec, int64_t maxTicks);
 
-// Gets the current number of ticks elapsed, up to timer.maxTicks.
+// Initializes the timer on the given time source such that the number of ticks elapsed is zero.
+Timer InitTimerWithSource(int64_t ticksPerSec, int64_t maxTicks, TimeSource source);
+
+// Gets the current number of ticks elapsed, up to timer.maxTicks. Ticks are counted from the time the timer started
+// running at its current rate, so no time is lost to rounding however often the timer is updated.
 int64_t GetTimerTicks(Timer* timer);
 
 // Adds the specified number of ticks to the timer.
 void AddTimerTicks(Timer* timer, int64_t ticks);
+
+// Changes the number of ticks that should pass in one second. Ticks that passed at the old rate are kept.
+void SetTimerTicksPerSec(Timer* timer, int64_t ticksPerSec);
+
+// Gets the number of nanoseconds from the timer's last update until it will hold a tick, zero if it already does,
+// or -1 if it is stopped.
+int64_t GetTimerNanosecondsUntilTick(const Timer* timer);
+
+// Initializes a tick rate meter whose first window starts now at the given tick count.
+TickRateMeter InitTickRateMeter(int64_t windowNanoseconds, TimeSource source, uint64_t tickCount);
+
+// Records the current tick count, measuring the rate if the current window has passed. A count lower than the one at
+// the start of the window, such as after seeking back, starts a new window without measuring.
+void UpdateTickRateMeter(TickRateMeter* meter, uint64_t tickCount);
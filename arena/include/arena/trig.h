@@ -0,0 +1,17 @@
+#pragma once
+
+// Fast trigonometry used by the arena simulation in place of libm's sin and cos.
+
+// The number of discrete directions that can be looked up with GetDirectionSinCos.
+#define TRIG_DIRECTION_COUNT 256
+
+// Computes the sine and cosine of an angle in radians using polynomial kernels.
+// Accurate to within a few units in the last place of a float for angles of moderate magnitude.
+void FastSinCos(float angle, float* sinOut, float* cosOut);
+
+// Gets the sine and cosine of a direction given in 256ths of a full turn from a precomputed table.
+// The results are the nearest floats to the exact values.
+void GetDirectionSinCos(unsigned char direction, float* sinOut, float* cosOut);
+
+// Computes the sine and cosine of the sum of an angle in radians and a direction in 256ths of a full turn.
+void FastSinCosWithDirection(float angle, unsigned char direction, float* sinOut, float* cosOut);
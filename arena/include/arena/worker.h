@@ -5,24 +5,31 @@
 
 // A worker that executes a function in a loop until it is told to stop.
 typedef struct Worker {
-  // A mutex protecting interactions with the worker state.
+  // A mutex protecting interactions with the worker state, held by the worker thread while it runs a step.
   pthread_mutex_t stateMutex;
+  // A mutex protecting the worker's wake and stop flags, which is never held for long.
+  pthread_mutex_t wakeMutex;
+  // A condition signaled when the worker should stop waiting and run its next step.
+  pthread_cond_t wakeCondition;
   // The worker's thread.
   pthread_t thread;
   // Whether the worker thread has been started.
   bool isThreadValid;
   // Whether the worker should stop.
   bool shouldStop;
+  // Whether the worker has been woken since it last started a step.
+  bool isWakePending;
 
-  // The function to execute on each step.
-  void (*onStep)(void* state);
+  // The function to execute on each step. Returns the number of nanoseconds to wait before the next step,
+  // zero to run it immediately, or a negative number to wait until the worker is woken.
+  int64_t (*onStep)(void* state);
   // The pointer to the state structure expected by the worker function.
   void* state;
 } Worker;
 
 // Attempts to initialize a worker. Does not start the worker thread.
 // If successful, returns true. Otherwise, returns false.
-bool TryInitWorker(Worker* worker, void (*onStep)(void* state), void* state);
+bool TryInitWorker(Worker* worker, int64_t (*onStep)(void* state), void* state);
 
 // Destroys the worker (including stopping the worker thread) and cleans up any system resources.
 void DestroyWorker(Worker* worker);
@@ -32,3 +39,7 @@ void StartWorker(Worker* worker);
 
 // Stops and cleans up the worker thread if it is running.
 void StopWorker(Worker* worker);
+
+// Wakes the worker thread if it is waiting, so that it runs its next step immediately.
+// Should be called after changing the state in a way that affects the worker. Doesn't need stateMutex to be held.
+void WakeWorker(Worker* worker);
@@ -1,7 +1,9 @@
 #include <stdlib.h>
 #include <stdio.h>
+#include <stdarg.h>
 #include <math.h>
 #include <limits.h>
+#include <stdatomic.h>
 #include <raylib.h>
 #include "utilities/file.h"
 #include "utilities/text.h"
@@ -9,13 +11,21 @@
 #include "assembler/assemble.h"
 #include "parser/parse.h"
 #include "processor/instruction.h"
+#include "arena/command_queue.h"
 #include "arena/simulation.h"
+#include "arena/map.h"
+#include "arena/render_state.h"
+#include "arena/replay.h"
+#include "arena/timeline.h"
+#include "arena/trig.h"
 
 #if defined(PLATFORM_WEB)
   #include <emscripten.h>
 #else
   #include <pthread.h>
   #include "arena/worker.h"
+  #include "arena/thread_pool.h"
+  #include "utilities/file_watch.h"
   #define USE_SIMULATION_WORKER
 #endif
 
@@ -32,15 +42,10 @@
 #define BACKGROUND_COLOR WHITE
 #define LAYER_COUNT 6
 
-#define ARENA_WIDTH 1000.0
-#define ARENA_HEIGHT 1000.0
 #define ARENA_BORDER_THICKNESS 4
 #define ARENA_MARGIN 10
 #define ARENA_MIN_SCREEN_SIZE 100
 
-#define OBSTACLE_WIDTH (ROBOT_RADIUS)
-#define OBSTACLE_HEIGHT (ARENA_HEIGHT / 2)
-
 #define CONTROLS_HEIGHT 60
 
 #define STATE_PANEL_WIDTH 250
@@ -59,6 +64,28 @@
 
 #define SHADOW_BLUR_SIZE 10
 
+#define TICK_RATE_WINDOW_NANOSECONDS 500000000
+
+#define FRAME_RATE 60
+// The speed, as a multiple of normal, above which frames are drawn less often to leave the CPU to the simulation.
+// Motion that fast can't be followed anyway.
+#define FAST_SIMULATION_SPEED 8
+#define FAST_SIMULATION_FRAME_RATE 30
+// The rate at which the arena is redrawn at fast speeds. The user interface is still redrawn on every frame.
+#define FAST_SIMULATION_ARENA_FRAME_RATE 10
+// The time between render states published by a running simulation. The renderer interpolates between them, so
+// publishing more often than frames are drawn only adds work.
+#define RENDER_STATE_PUBLISH_INTERVAL_NANOSECONDS (TIMER_NANOSECONDS_PER_SECOND / FRAME_RATE)
+
+// The number of battles that can be shown at once, each in its own tile of the arena view.
+#define MAX_MATCHES 16
+#define MAX_PROGRAMS (MAX_MATCHES + 1)
+
+// The longest that the program reloader waits for a change before checking whether it should stop.
+#define PROGRAM_RELOAD_WAIT_MS 250
+// The time for which a successful program reload is shown.
+#define PROGRAM_RELOAD_MESSAGE_SECONDS 3.0
+
 const Color SHADOW_TINT = { .r = 255, .g = 255, .b = 255, .a = 96 };
 const Color ROBOT_COLORS[] = {
   PURPLE,
@@ -66,28 +93,91 @@ const Color ROBOT_COLORS[] = {
 };
 
 
-bool TryParseAndAssembleProgram(const TextContents* programText, AssemblyProgram* assemblyProgramOut, uint8_t* memoryOut);
+// A battle shown in one tile of the arena view.
+typedef struct {
+  // The battle's simulation.
+  Simulation simulation;
+  // The history of the battle that can be seeked back through.
+  Timeline timeline;
+  // The buffer through which states of the battle are handed to the renderer.
+  RenderStateBuffer renderStateBuffer;
+  // The time at which the simulation last published a state.
+  int64_t lastPublishTime;
+  // The states that the renderer draws between, which only the renderer touches.
+  RenderStateHistory renderStateHistory;
+  // The state drawn in the current frame.
+  RenderState renderState;
+  // The index of the program run by each robot.
+  size_t programIndices[SIMULATION_MAX_ROBOTS];
+} Match;
+
+
+bool TryParseAndAssembleProgram(const TextContents* programText, AssemblyProgram* assemblyProgramOut, uint8_t* memoryOut, char* errorMsgOut, size_t errorMsgSize);
+void UpdateMatchesWithCommands();
+void UpdateMatch(Match* match);
+void UpdateMatchTask(void* context, size_t taskIndex);
+void ApplySimulationCommand(SimulationCommand command);
+void ApplySimulationCommandToMatch(Match* match, SimulationCommand command);
+void RestartBattle(Match* match);
+unsigned int GetHeldUserKeys();
+
+#ifdef USE_SIMULATION_WORKER
+// Updates the matches from the worker thread, returning how long the worker can wait before the next update.
+int64_t UpdateMatchesFromWorker(void* state);
+// Waits for the watched program files to change, then assembles them and hands them to the simulation worker.
+int64_t ReloadChangedPrograms(void* state);
+void ReloadProgramFile(size_t programIndex, const char* filePath, Worker* simulationWorker);
+void SetProgramReloadMessage(bool isError, const char* format, ...);
+#endif
 
 #if defined(PLATFORM_WEB)
 EM_JS(int, GetCanvasWidth, (), { return canvasElement.offsetWidth * (window.devicePixelRatio || 1); });
 EM_JS(int, GetCanvasHeight, (), { return canvasElement.offsetHeight * (window.devicePixelRatio || 1); });
 #endif
 void UpdateDpiAndMinWindowSize();
+Rectangle GetMatchTileRect(Rectangle area, size_t matchIndex);
+Camera2D GetArenaCamera(Rectangle boundary, Rectangle screenRect);
 
-void DrawArenaForeground();
-void DrawRobot(const PhysicsWorld* physicsWorld, const Robot* robot, Color baseColor, unsigned int layer);
+void DrawArenaForeground(Rectangle boundary);
+void DrawRobot(const RobotRenderState* robot, Color baseColor, unsigned int layer);
 void DrawStaticBody(const PhysicsBody* body, unsigned int layer);
-void DrawSimSpeed(int64_t ticksPerSec, Vector2 position);
+void DrawSimSpeed(int64_t ticksPerSec, double achievedTicksPerSec, Vector2 position);
+void DrawFrameLoad(double renderLoad, int frameRate, double simulationLoad, bool isArenaCached, Vector2 position);
 void DrawControls(Vector2 position);
-void DrawWinner(Vector2 position, size_t index);
-void DrawStatePanel(const Robot* robot, size_t index, Vector2 position);
+void DrawWinner(Vector2 position, const RenderState* renderState);
+void DrawMatchLabel(const Match* match, bool isSelected, Vector2 position);
+void DrawStatePanel(const RobotRenderState* robot, size_t index, Vector2 position);
+void DrawProgramReloadMessage(const char* message, bool isError, Vector2 position);
 
 
-TextContents programTextA, programTextB;
-AssemblyProgram programA, programB;
-uint8_t initialMemoryA[MEMORY_SIZE], initialMemoryB[MEMORY_SIZE];
+size_t programCount;
+TextContents programTexts[MAX_PROGRAMS];
+AssemblyProgram programs[MAX_PROGRAMS];
+uint8_t initialMemories[MAX_PROGRAMS][MEMORY_SIZE];
 char errorMsgBuffer[8000];
-Simulation simulation;
+size_t matchCount;
+Match matches[MAX_MATCHES];
+ArenaMap map;
+Replay replay;
+ReplayRecorder replayRecorder;
+ReplayPlayer replayPlayer;
+TickRateMeter tickRateMeter;
+// The total time spent updating the matches, which the renderer compares with its own.
+_Atomic int64_t simulationBusyNanoseconds;
+SimulationCommandQueue simulationCommands;
+#ifdef USE_SIMULATION_WORKER
+// The thread pool that updates the matches in parallel, or the robots of the only match.
+ThreadPool simulationThreadPool;
+FileWatcher programWatcher;
+// The queue through which the program reloader hands assembled programs to the simulation.
+SimulationCommandQueue programReloadCommands;
+// The mutex protecting the message describing the latest program reload.
+pthread_mutex_t programReloadMessageMutex;
+char programReloadMessage[8000];
+bool isProgramReloadMessageError;
+// The number of program reload messages so far.
+uint64_t programReloadMessageCount;
+#endif
 float dpi = -1;
 Font primaryFont = { 0 };
 
@@ -97,83 +187,182 @@ Font primaryFont = { 0 };
 
 int main(int argc, char* argv[]) {
   // Get command line arguments
-  if (argc < 1 || argc > 3) {
-    fprintf(stderr, "Usage: %s [<assembly file A> [<assembly file B>]]\n", argv[0]);
+  char* assemblyFilePaths[MAX_PROGRAMS] = { NULL };
+  size_t assemblyFileCount = 0;
+  char* mapFilePath = NULL;
+  char* recordFilePath = NULL;
+  char* replayFilePath = NULL;
+  bool isUsageValid = true;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--map") == 0 && i + 1 < argc) {
+      mapFilePath = argv[++i];
+    } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      recordFilePath = argv[++i];
+    } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      replayFilePath = argv[++i];
+    } else if (argv[i][0] != '-' && assemblyFileCount < MAX_PROGRAMS) {
+      assemblyFilePaths[assemblyFileCount++] = argv[i];
+    } else {
+      isUsageValid = false;
+    }
+  }
+  if (!isUsageValid || (replayFilePath != NULL && (assemblyFileCount > 0 || mapFilePath != NULL || recordFilePath != NULL)) ||
+      (recordFilePath != NULL && assemblyFileCount > 2)) {
+    fprintf(stderr, "Usage: %s [<assembly file A> [<assembly file B>]] [--map <map file>] [--record <replay file>]\n", argv[0]);
+    fprintf(stderr, "       %s <assembly file A> <assembly file B> <assembly file C> ... [--map <map file>]\n", argv[0]);
+    fprintf(stderr, "       %s --replay <replay file>\n", argv[0]);
+    fprintf(stderr, "With more than two assembly files, A battles each of the others in its own arena, up to %d at once.\n", MAX_MATCHES);
     return 1;
   }
-  char* assemblyFilePathA = argc >= 2 ? argv[1] : NULL;
-  char* assemblyFilePathB = argc >= 3 ? argv[2] : NULL;
 
-  // Load assembly program files
-  if (assemblyFilePathA != NULL) {
-    if (!TryInitTextContentsFromFile(assemblyFilePathA, &programTextA)) {
-      fprintf(stderr, "Failed to read assembly file A.\n");
+  // Load map
+  if (mapFilePath != NULL) {
+    ArenaMapError mapError;
+    if (!TryLoadArenaMap(mapFilePath, &map, &mapError)) {
+      if (mapError.line > 0) {
+        fprintf(stderr, "Failed to load map file:\nLine %zu: %s.\n", mapError.line, mapError.message);
+      } else {
+        fprintf(stderr, "Failed to load map file: %s.\n", mapError.message);
+      }
       return 1;
     }
   } else {
-    programTextA = InitTextContentsAsCopyCStr("");
+    map = InitDefaultArenaMap();
   }
 
-  if (assemblyFilePathB != NULL) {
-    if (!TryInitTextContentsFromFile(assemblyFilePathB, &programTextB)) {
-      fprintf(stderr, "Failed to read assembly file B.\n");
+  // Load replay, which holds its own map and programs
+  if (replayFilePath != NULL) {
+    const char* replayError;
+    if (!TryLoadReplay(replayFilePath, &replay, &replayError)) {
+      fprintf(stderr, "Failed to load replay file: %s.\n", replayError);
       return 1;
     }
-  } else {
-    programTextB = InitTextContentsAsCopyCStr("");
+    programTexts[0] = InitTextContentsAsCopyCStr(replay.programTexts[0] != NULL ? replay.programTexts[0] : "");
+    programTexts[1] = InitTextContentsAsCopyCStr(replay.programTexts[1] != NULL ? replay.programTexts[1] : "");
   }
 
-  // Parse and assemble programs
-  memset(initialMemoryA, 0x00, sizeof(initialMemoryA));
-  if (!TryParseAndAssembleProgram(&programTextA, &programA, initialMemoryA)) {
-    fprintf(stderr, "Failed to assemble program A:\n");
-    fprintf(stderr, "%s", errorMsgBuffer);
-    return 1;
+  // Load assembly program files, with at least two programs so that every match has an opponent
+  programCount = assemblyFileCount > 2 ? assemblyFileCount : 2;
+  for (size_t i = 0; i < programCount; i++) {
+    if (replayFilePath != NULL) {
+      // Already loaded from the replay
+    } else if (assemblyFilePaths[i] != NULL) {
+      if (!TryInitTextContentsFromFile(assemblyFilePaths[i], &programTexts[i])) {
+        fprintf(stderr, "Failed to read assembly file %c.\n", (char)('A' + i));
+        return 1;
+      }
+    } else {
+      programTexts[i] = InitTextContentsAsCopyCStr("");
+    }
   }
 
-  memset(initialMemoryB, 0x00, sizeof(initialMemoryB));
-  if (!TryParseAndAssembleProgram(&programTextB, &programB, initialMemoryB)) {
-    fprintf(stderr, "Failed to assemble program B:\n");
-    fprintf(stderr, "%s", errorMsgBuffer);
-    return 1;
+  // Parse and assemble programs
+  for (size_t i = 0; i < programCount; i++) {
+    memset(initialMemories[i], 0x00, sizeof(initialMemories[i]));
+    if (!TryParseAndAssembleProgram(&programTexts[i], &programs[i], initialMemories[i], errorMsgBuffer, sizeof(errorMsgBuffer))) {
+      fprintf(stderr, "Failed to assemble program %c:\n", (char)('A' + i));
+      fprintf(stderr, "%s", errorMsgBuffer);
+      return 1;
+    }
   }
 
-  // Setup simulation
-  simulation = (Simulation){
-    .physicsWorld.boundary = (Rectangle){
-      .x = -ARENA_WIDTH / 2, .y = -ARENA_HEIGHT / 2,
-      .width = ARENA_WIDTH, .height = ARENA_HEIGHT
-    },
-    .timer = InitTimer(0, 100),
-  };
+  // Setup a match of program A against each of the other programs
+  matchCount = programCount - 1;
+  for (size_t i = 0; i < matchCount; i++) {
+    Match* match = &matches[i];
+    match->programIndices[0] = 0;
+    match->programIndices[1] = i + 1;
+
+    // Setup simulation
+    match->simulation = (Simulation){
+      .physicsWorld.useContinuousCollision = true,
+      .physicsWorld.useStaticDistanceField = true,
+      .host.timer = InitTimer(0, 100),
+      .instructionsPerPhysicsStep = SIMULATION_DEFAULT_INSTRUCTIONS_PER_PHYSICS_STEP,
+      .stallWindowTicks = SIMULATION_DEFAULT_STALL_WINDOW_TICKS,
+    };
+
+    if (replayFilePath != NULL) {
+      ApplyReplayToSimulation(&replay, &match->simulation);
+      replayPlayer = InitReplayPlayer(&replay);
+      match->simulation.host.replayPlayer = &replayPlayer;
+    } else {
+      ApplyArenaMapToSimulation(&map, &match->simulation);
+    }
 
-  AddRobotToSimulation(&simulation, (Vector2){ -ARENA_WIDTH / 2 + ROBOT_RADIUS * 2, 0 }, 0);
-  AddRobotToSimulation(&simulation, (Vector2){ ARENA_WIDTH / 2 - ROBOT_RADIUS * 2, 0 }, M_PI);
+    // Load assembly programs into robot memory
+    for (size_t j = 0; j < match->simulation.robotCount; j++) {
+      memcpy(match->simulation.robots[j].processState.memory, initialMemories[match->programIndices[j]], MEMORY_SIZE * sizeof(uint8_t));
+    }
 
-  AddObstacleToSimulation(&simulation, (Vector2){ -ARENA_WIDTH / 4, 0 }, 0, (PhysicsCollider){
-    .kind = PHYSICS_COLLIDER_RECTANGLE,
-    .widthHeight = { OBSTACLE_WIDTH, OBSTACLE_HEIGHT }
-  });
-  AddObstacleToSimulation(&simulation, (Vector2){ ARENA_WIDTH / 4, 0 }, 0, (PhysicsCollider){
-    .kind = PHYSICS_COLLIDER_RECTANGLE,
-    .widthHeight = { OBSTACLE_WIDTH, OBSTACLE_HEIGHT }
-  });
+    // Setup replay recording, which is only allowed for a single match
+    if (recordFilePath != NULL) {
+      InitReplay(&replay, &match->simulation, &map);
+      if (!TrySetReplayProgramText(&replay, 0, &programTexts[0]) || !TrySetReplayProgramText(&replay, 1, &programTexts[1])) {
+        fprintf(stderr, "Failed to initialize replay.\n");
+        return 1;
+      }
+      replayRecorder = InitReplayRecorder(&replay);
+      match->simulation.host.replayRecorder = &replayRecorder;
+    }
 
-  // Load assembly programs into robot memory
-  memcpy(simulation.robots[0].processState.memory, initialMemoryA, sizeof(initialMemoryA));
-  memcpy(simulation.robots[1].processState.memory, initialMemoryB, sizeof(initialMemoryB));
+    PrepSimulation(&match->simulation);
 
-  PrepSimulation(&simulation);
+    // Setup timeline for seeking back through the battle, sharing the memory cap between matches
+    if (!TryInitTimeline(&match->timeline, TIMELINE_DEFAULT_INTERVAL_TICKS, TIMELINE_DEFAULT_MEMORY_CAP_BYTES / matchCount)) {
+      fprintf(stderr, "Failed to initialize timeline.\n");
+      exit(1);
+    }
+    match->simulation.host.timeline = &match->timeline;
+
+    // Setup buffer through which states are handed to the renderer, and the states that it draws between
+    InitRenderStateBuffer(&match->renderStateBuffer);
+    PublishRenderState(&match->renderStateBuffer, &match->simulation);
+    InitRenderStateHistory(&match->renderStateHistory);
+  }
+
+  // Setup measurement of the speed that the selected match actually runs at
+  size_t selectedMatchIndex = 0;
+  tickRateMeter = InitTickRateMeter(TICK_RATE_WINDOW_NANOSECONDS, InitMonotonicTimeSource(), matches[selectedMatchIndex].simulation.tickCount);
+
+  // Setup queue through which the user interface controls the simulation
+  InitSimulationCommandQueue(&simulationCommands);
 
   #ifdef USE_SIMULATION_WORKER
-  // Setup worker to run simulation
+  // Setup thread pool that runs the matches side by side, or the per-robot phases of each step of a single match.
+  // A match's own steps don't use the pool while it is running the matches.
+  if (!TryInitThreadPool(&simulationThreadPool, GetDefaultThreadPoolThreadCount())) {
+    fprintf(stderr, "Failed to initialize simulation thread pool.\n");
+    exit(1);
+  }
+  if (matchCount == 1) {
+    matches[0].simulation.host.threadPool = &simulationThreadPool;
+  }
+
+  // Setup worker to run the matches
   Worker simulationWorker = { 0 };
-  if (!TryInitWorker(&simulationWorker, (void (*)(void*))UpdateSimulation, &simulation)) {
+  if (!TryInitWorker(&simulationWorker, UpdateMatchesFromWorker, NULL)) {
     fprintf(stderr, "Failed to initialize simulation worker.\n");
     exit(1);
   }
 
   StartWorker(&simulationWorker);
+
+  // Setup reloading of the program files whenever they change, which doesn't apply to replays
+  InitSimulationCommandQueue(&programReloadCommands);
+  programWatcher = InitFileWatcher();
+  Worker programReloadWorker = { 0 };
+  if (replayFilePath == NULL && assemblyFileCount > 0) {
+    for (size_t i = 0; i < assemblyFileCount; i++) {
+      size_t fileIndex;
+      TryAddFileToWatcher(&programWatcher, assemblyFilePaths[i], &fileIndex);
+    }
+    if (pthread_mutex_init(&programReloadMessageMutex, NULL) || !TryInitWorker(&programReloadWorker, ReloadChangedPrograms, &simulationWorker)) {
+      fprintf(stderr, "Failed to initialize program reloader.\n");
+      exit(1);
+    }
+    StartWorker(&programReloadWorker);
+  }
   #endif
 
   // Setup window
@@ -189,11 +378,11 @@ int main(int argc, char* argv[]) {
   #else
   SetWindowSize(GetCanvasWidth(), GetCanvasHeight());
   #endif
-  SetTargetFPS(60);
+  SetTargetFPS(FRAME_RATE);
 
   // Setup cameras
   Camera2D uiCamera = { 0 };
-  Camera2D arenaCamera = { 0 };
+  Camera2D arenaCameras[MAX_MATCHES] = { 0 };
 
   // Load resources
   primaryFont = LoadFontEx("resources/fonts/Roboto_Mono/static/RobotoMono-SemiBold.ttf", 100, NULL, 0);
@@ -225,32 +414,161 @@ int main(int argc, char* argv[]) {
   RenderTexture2D shadowsTarget0 = LoadRenderTexture(screenWidth, screenHeight);
   RenderTexture2D shadowsTarget1 = LoadRenderTexture(screenWidth, screenHeight);
 
+  // Initialize render texture holding the last drawn arena, for frames that don't redraw it
+  RenderTexture2D arenaTarget = LoadRenderTexture(screenWidth, screenHeight);
+  bool isArenaCached = false;
+  bool isArenaCacheValid = false;
+  double arenaDrawTime = 0.0;
+
+  // Setup measurement of the share of time spent rendering and simulating, as nanoseconds busy per second
+  TimeSource frameTimeSource = InitMonotonicTimeSource();
+  int64_t renderBusyNanoseconds = 0;
+  TickRateMeter renderLoadMeter = InitTickRateMeter(TICK_RATE_WINDOW_NANOSECONDS, InitMonotonicTimeSource(), 0);
+  TickRateMeter simulationLoadMeter = InitTickRateMeter(TICK_RATE_WINDOW_NANOSECONDS, InitMonotonicTimeSource(), 0);
+
   // Enter main loop
+  unsigned int sentUserKeys = 0;
+  #ifdef USE_SIMULATION_WORKER
+  char shownReloadMessage[sizeof(programReloadMessage)] = "";
+  bool isShownReloadMessageError = false;
+  uint64_t shownReloadMessageCount = 0;
+  double shownReloadMessageTime = 0.0;
+  #endif
   while (!WindowShouldClose()) {
     screenWidth = GetScreenWidth(); screenHeight = GetScreenHeight();
     UpdateDpiAndMinWindowSize();
 
-    // Update shadow render textures
+    // Update shadow and arena render textures
     if (screenWidth != shadowsTarget0.texture.width || screenHeight != shadowsTarget0.texture.height) {
       UnloadRenderTexture(shadowsTarget0);
       UnloadRenderTexture(shadowsTarget1);
+      UnloadRenderTexture(arenaTarget);
       shadowsTarget0 = LoadRenderTexture(screenWidth, screenHeight);
       shadowsTarget1 = LoadRenderTexture(screenWidth, screenHeight);
+      arenaTarget = LoadRenderTexture(screenWidth, screenHeight);
+      isArenaCacheValid = false;
     }
-    
-    // Update camera based on current window size
+
+    // Work out where each match is drawn
     uiCamera.zoom = dpi;
 
     float statePanelScreenWidth = dpi * STATE_PANEL_WIDTH;
     float controlsScreenHeight = dpi * CONTROLS_HEIGHT;
     float arenaScreenWidth = fmaxf(screenWidth - statePanelScreenWidth, ARENA_MIN_SCREEN_SIZE);
     float arenaScreenHeight = fmaxf(screenHeight - controlsScreenHeight * 2, ARENA_MIN_SCREEN_SIZE);
-    arenaCamera.offset = (Vector2){ statePanelScreenWidth + (arenaScreenWidth / 2), screenHeight / 2 };
-    arenaCamera.zoom = fmin((arenaScreenWidth - 2 * ARENA_MARGIN) / (ARENA_WIDTH + ARENA_BORDER_THICKNESS * 2),
-                            (arenaScreenHeight - 2 * ARENA_MARGIN) / (ARENA_HEIGHT + ARENA_BORDER_THICKNESS * 2));
+    Rectangle arenaScreenRect = { statePanelScreenWidth, (screenHeight - arenaScreenHeight) / 2, arenaScreenWidth, arenaScreenHeight };
+
+    // Handle input by sending commands that the simulation applies between updates, so that the user interface
+    // never waits on a running update
+    bool isCommandSent = false;
+
+    // Temporary code for manipulating time scale
+    int64_t ticksPerSec = -1;
+    if (IsKeyPressed(KEY_ZERO) || IsKeyPressed(KEY_KP_0)) {
+      ticksPerSec = 0;
+    } else if (IsKeyPressed(KEY_ONE) || IsKeyPressed(KEY_KP_1)) {
+      ticksPerSec = 1;
+    } else if (IsKeyPressed(KEY_TWO) || IsKeyPressed(KEY_KP_2)) {
+      ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND / 4;
+    } else if (IsKeyPressed(KEY_THREE) || IsKeyPressed(KEY_KP_3)) {
+      ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND / 2;
+    } else if (IsKeyPressed(KEY_FOUR) || IsKeyPressed(KEY_KP_4)) {
+      ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND;
+    } else if (IsKeyPressed(KEY_FIVE) || IsKeyPressed(KEY_KP_5)) {
+      ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND * 2;
+    } else if (IsKeyPressed(KEY_SIX) || IsKeyPressed(KEY_KP_6)) {
+      ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND * 4;
+    } else if (IsKeyPressed(KEY_SEVEN) || IsKeyPressed(KEY_KP_7)) {
+      ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND * 16;
+    } else if (IsKeyPressed(KEY_EIGHT) || IsKeyPressed(KEY_KP_8)) {
+      ticksPerSec = SIMULATION_MAX_SPEED_TICKS_PER_SECOND;
+    }
+    if (ticksPerSec >= 0) {
+      isCommandSent |= TryPushSimulationCommand(&simulationCommands, (SimulationCommand){ .kind = SIMULATION_COMMAND_SET_SPEED, .ticksPerSec = ticksPerSec });
+    }
+
+    if (IsKeyPressed(KEY_TAB) || IsKeyPressedRepeat(KEY_TAB)) {
+      isCommandSent |= TryPushSimulationCommand(&simulationCommands, (SimulationCommand){ .kind = SIMULATION_COMMAND_STEP, .stepCount = 1 });
+    }
+
+    // Seek by a second of simulation time, or restart the battle, unless a recording would be lost by rewinding
+    if (recordFilePath == NULL && (IsKeyPressed(KEY_LEFT_BRACKET) || IsKeyPressedRepeat(KEY_LEFT_BRACKET))) {
+      isCommandSent |= TryPushSimulationCommand(&simulationCommands, (SimulationCommand){ .kind = SIMULATION_COMMAND_SEEK, .tickOffset = -TIMELINE_DEFAULT_INTERVAL_TICKS });
+    } else if (IsKeyPressed(KEY_RIGHT_BRACKET) || IsKeyPressedRepeat(KEY_RIGHT_BRACKET)) {
+      isCommandSent |= TryPushSimulationCommand(&simulationCommands, (SimulationCommand){ .kind = SIMULATION_COMMAND_SEEK, .tickOffset = TIMELINE_DEFAULT_INTERVAL_TICKS });
+    }
+    if (recordFilePath == NULL && IsKeyPressed(KEY_R)) {
+      isCommandSent |= TryPushSimulationCommand(&simulationCommands, (SimulationCommand){ .kind = SIMULATION_COMMAND_RESET });
+    }
+
+    // Send the keys overriding the first robot's controls whenever they change
+    unsigned int heldUserKeys = GetHeldUserKeys();
+    if (heldUserKeys != sentUserKeys && TryPushSimulationCommand(&simulationCommands, (SimulationCommand){ .kind = SIMULATION_COMMAND_SET_USER_KEYS, .userKeys = heldUserKeys })) {
+      sentUserKeys = heldUserKeys;
+      isCommandSent = true;
+    }
+
+    #ifdef USE_SIMULATION_WORKER
+    // Wake the worker so that it doesn't keep waiting on a schedule that the commands may change
+    if (isCommandSent) {
+      WakeWorker(&simulationWorker);
+    }
+    #else
+    // Update simulation
+    (void)isCommandSent;
+    UpdateMatchesWithCommands();
+    #endif
+
+    // Measure the time spent rendering from here, leaving out the update of the simulation
+    int64_t frameStartTime = ReadTimeSource(&frameTimeSource);
+
+    #ifdef USE_SIMULATION_WORKER
+    // Pick up the message from the latest program reload
+    if (programReloadWorker.isThreadValid) {
+      pthread_mutex_lock(&programReloadMessageMutex); {
+        if (programReloadMessageCount != shownReloadMessageCount) {
+          strcpy(shownReloadMessage, programReloadMessage);
+          isShownReloadMessageError = isProgramReloadMessageError;
+          shownReloadMessageCount = programReloadMessageCount;
+          shownReloadMessageTime = GetTime();
+        }
+      } pthread_mutex_unlock(&programReloadMessageMutex);
+    }
+    #endif
+
+    // Draw frame from the latest published states of each match, which the simulation doesn't touch while they are
+    // being read, interpolating between them for smooth motion
+    const RenderState* renderStates[MAX_MATCHES];
+    int64_t frameTime = ReadTimeSource(&frameTimeSource);
+    for (size_t i = 0; i < matchCount; i++) {
+      UpdateRenderStateHistory(&matches[i].renderStateHistory, &matches[i].renderStateBuffer, frameTime);
+      InterpolateRenderState(&matches[i].renderStateHistory, frameTime, &matches[i].renderState);
+      renderStates[i] = &matches[i].renderState;
+      arenaCameras[i] = GetArenaCamera(renderStates[i]->boundary, GetMatchTileRect(arenaScreenRect, i));
+    }
+
+    // Select the match whose robots are shown in the state panel by clicking on it
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) {
+      for (size_t i = 0; i < matchCount; i++) {
+        if (CheckCollisionPointRec(GetMousePosition(), GetMatchTileRect(arenaScreenRect, i)) && i != selectedMatchIndex) {
+          selectedMatchIndex = i;
+          tickRateMeter = InitTickRateMeter(TICK_RATE_WINDOW_NANOSECONDS, InitMonotonicTimeSource(), renderStates[i]->tickCount);
+        }
+      }
+    }
+    const RenderState* selectedRenderState = renderStates[selectedMatchIndex];
+
+    // At fast speeds, draw frames less often and only redraw the arena, with its shadow passes, every few frames
+    bool isSimulationFast = selectedRenderState->ticksPerSec > SIMULATION_DEFAULT_TICKS_PER_SECOND * FAST_SIMULATION_SPEED;
+    if (isSimulationFast != isArenaCached) {
+      isArenaCached = isSimulationFast;
+      isArenaCacheValid = false;
+      SetTargetFPS(isArenaCached ? FAST_SIMULATION_FRAME_RATE : FRAME_RATE);
+    }
+    bool isArenaDrawn = !isArenaCached || !isArenaCacheValid || GetTime() - arenaDrawTime >= 1.0 / FAST_SIMULATION_ARENA_FRAME_RATE;
 
     // Update blur shader uniforms
-    float blurSize = SHADOW_BLUR_SIZE * arenaCamera.zoom;
+    float blurSize = SHADOW_BLUR_SIZE * arenaCameras[0].zoom;
 
     SetShaderValue(hBlurShader, hBlurRenderWidthLocation, &screenWidth, SHADER_UNIFORM_INT);
     SetShaderValue(hBlurShader, hBlurRenderHeightLocation, &screenHeight, SHADER_UNIFORM_INT);
@@ -260,119 +578,127 @@ int main(int argc, char* argv[]) {
     SetShaderValue(vBlurShader, vBlurRenderHeightLocation, &screenHeight, SHADER_UNIFORM_INT);
     SetShaderValue(vBlurShader, vBlurSizeLocation, &blurSize, SHADER_UNIFORM_FLOAT);
 
-    // Handle input
-    #ifdef USE_SIMULATION_WORKER
-    pthread_mutex_lock(&simulationWorker.stateMutex); {
-    #endif
-      // Temporary code for manipulating time scale
-      if (IsKeyPressed(KEY_ZERO) || IsKeyPressed(KEY_KP_0)) {
-        simulation.timer.ticksPerSec = 0;
-      } else if (IsKeyPressed(KEY_ONE) || IsKeyPressed(KEY_KP_1)) {
-        simulation.timer.ticksPerSec = 1;
-      } else if (IsKeyPressed(KEY_TWO) || IsKeyPressed(KEY_KP_2)) {
-        simulation.timer.ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND / 4;
-      } else if (IsKeyPressed(KEY_THREE) || IsKeyPressed(KEY_KP_3)) {
-        simulation.timer.ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND / 2;
-      } else if (IsKeyPressed(KEY_FOUR) || IsKeyPressed(KEY_KP_4)) {
-        simulation.timer.ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND;
-      } else if (IsKeyPressed(KEY_FIVE) || IsKeyPressed(KEY_KP_5)) {
-        simulation.timer.ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND * 2;
-      } else if (IsKeyPressed(KEY_SIX) || IsKeyPressed(KEY_KP_6)) {
-        simulation.timer.ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND * 4;
-      } else if (IsKeyPressed(KEY_SEVEN) || IsKeyPressed(KEY_KP_7)) {
-        simulation.timer.ticksPerSec = INT64_MAX;
-      }
-
-      if (IsKeyPressed(KEY_TAB) || IsKeyPressedRepeat(KEY_TAB)) {
-        simulation.forceStep = true;
-      }
-    #ifdef USE_SIMULATION_WORKER
-    } pthread_mutex_unlock(&simulationWorker.stateMutex);
-    #endif
+    BeginDrawing(); {
+      // Draw the arena of every match, unless the last drawn one is kept for this frame
+      if (isArenaDrawn) {
+        // Draw shadows of every match to first stage shadow texture
+        BeginTextureMode(shadowsTarget0); {
+          ClearBackground(WHITE);
+
+          for (size_t m = 0; m < matchCount; m++) {
+            const RenderState* renderState = renderStates[m];
+            BeginMode2D(arenaCameras[m]); {
+              // Draw layer 0 (shadows)
+              for (unsigned int i = 0; i < renderState->robotCount; i++) {
+                DrawRobot(&renderState->robots[i], ROBOT_COLORS[i], 0);
+              }
+              for (unsigned int i = 0; i < renderState->bodyCount; i++) {
+                const PhysicsBody* body = &renderState->bodies[i];
+                if (body->isStatic) {
+                  DrawStaticBody(body, 0);
+                }
+              }
+            } EndMode2D();
+          }
+        } EndTextureMode();
 
-    #ifndef USE_SIMULATION_WORKER
-    // Update simulation
-    UpdateSimulation(&simulation);
-    #endif
+        // Draw first stage shadow texture to second stage with partial blur
+        BeginTextureMode(shadowsTarget1); BeginShaderMode(hBlurShader); {
+          DrawTextureRec(shadowsTarget0.texture, (Rectangle){ 0, 0, shadowsTarget0.texture.width, -shadowsTarget0.texture.height }, (Vector2){ 0, 0 }, WHITE);
+        } EndShaderMode(); EndTextureMode();
 
-    // Draw frame
-    BeginDrawing();
-    #ifdef USE_SIMULATION_WORKER
-    pthread_mutex_lock(&simulationWorker.stateMutex); {
-    #endif
-      // Draw shadows to first stage shadow texture
-      BeginTextureMode(shadowsTarget0); {
-        ClearBackground(WHITE);
-
-        BeginMode2D(arenaCamera); {
-          // Draw layer 0 (shadows)
-          for (unsigned int i = 0; i < simulation.robotCount; i++) {
-            DrawRobot(&simulation.physicsWorld, &simulation.robots[i], ROBOT_COLORS[i], 0);
-          }
-          for (unsigned int i = 0; i < simulation.physicsWorld.bodyCount; i++) {
-            const PhysicsBody* body = &simulation.physicsWorld.bodies[i];
-            if (body->isStatic) {
-              DrawStaticBody(body, 0);
-            }
-          }
-        } EndMode2D();
-      } EndTextureMode();
-
-      // Draw first stage shadow texture to second stage with partial blur
-      BeginTextureMode(shadowsTarget1); BeginShaderMode(hBlurShader); {
-        DrawTextureRec(shadowsTarget0.texture, (Rectangle){ 0, 0, shadowsTarget0.texture.width, -shadowsTarget0.texture.height }, (Vector2){ 0, 0 }, WHITE);
-      } EndShaderMode(); EndTextureMode();
-
-      // Clear screen
-      ClearBackground(BACKGROUND_COLOR);
-
-      // Draw second stage shadow texture to screen with full blur
-      BeginShaderMode(vBlurShader); {
-        DrawTextureRec(shadowsTarget1.texture, (Rectangle){ 0, 0, shadowsTarget1.texture.width, -shadowsTarget1.texture.height }, (Vector2){ 0, 0 }, SHADOW_TINT);
-      } EndShaderMode();
-
-      // Draw scene
-      BeginMode2D(arenaCamera); {
-        // TODO: Draw some kind of arena backdrop
-        // Draw layers 1+
-        for (unsigned int layer = 1; layer < LAYER_COUNT; layer++) {
-          for (unsigned int i = 0; i < simulation.robotCount; i++) {
-            DrawRobot(&simulation.physicsWorld, &simulation.robots[i], ROBOT_COLORS[i], layer);
-          }
-          for (unsigned int i = 0; i < simulation.physicsWorld.bodyCount; i++) {
-            const PhysicsBody* body = &simulation.physicsWorld.bodies[i];
-            if (body->isStatic) {
-              DrawStaticBody(body, layer);
+        // Clear screen, or the arena texture if the arena is kept for the following frames
+        if (isArenaCached) {
+          BeginTextureMode(arenaTarget);
+        }
+        ClearBackground(BACKGROUND_COLOR);
+
+        // Draw second stage shadow texture to screen with full blur
+        BeginShaderMode(vBlurShader); {
+          DrawTextureRec(shadowsTarget1.texture, (Rectangle){ 0, 0, shadowsTarget1.texture.width, -shadowsTarget1.texture.height }, (Vector2){ 0, 0 }, SHADOW_TINT);
+        } EndShaderMode();
+
+        // Draw scene of every match
+        for (size_t m = 0; m < matchCount; m++) {
+          const RenderState* renderState = renderStates[m];
+          BeginMode2D(arenaCameras[m]); {
+            // TODO: Draw some kind of arena backdrop
+            // Draw layers 1+
+            for (unsigned int layer = 1; layer < LAYER_COUNT; layer++) {
+              for (unsigned int i = 0; i < renderState->robotCount; i++) {
+                DrawRobot(&renderState->robots[i], ROBOT_COLORS[i], layer);
+              }
+              for (unsigned int i = 0; i < renderState->bodyCount; i++) {
+                const PhysicsBody* body = &renderState->bodies[i];
+                if (body->isStatic) {
+                  DrawStaticBody(body, layer);
+                }
+              }
             }
-          }
+            DrawArenaForeground(renderState->boundary);
+          } EndMode2D();
         }
-        DrawArenaForeground();
-      } EndMode2D();
+
+        if (isArenaCached) {
+          // Make the arena texture opaque again, since blending the scene into it lowers its alpha. Additive black
+          // only adds to the alpha.
+          BeginBlendMode(BLEND_ADDITIVE); {
+            DrawRectangle(0, 0, arenaTarget.texture.width, arenaTarget.texture.height, BLACK);
+          } EndBlendMode();
+          EndTextureMode();
+          isArenaCacheValid = true;
+          arenaDrawTime = GetTime();
+        }
+      }
+
+      // Draw the last drawn arena when it is kept between frames
+      if (isArenaCached) {
+        ClearBackground(BACKGROUND_COLOR);
+        DrawTextureRec(arenaTarget.texture, (Rectangle){ 0, 0, arenaTarget.texture.width, -arenaTarget.texture.height }, (Vector2){ 0, 0 }, WHITE);
+      }
 
       // Draw user interface
       BeginMode2D(uiCamera); {
         float scaledScreenWidth = screenWidth / dpi;
         float scaledScreenHeight = screenHeight / dpi;
-  
+
         DrawRectangleRec((Rectangle){ 0.0f, 0.0f, scaledScreenWidth, CONTROLS_HEIGHT }, WHITE);
-        DrawSimSpeed(simulation.timer.ticksPerSec, (Vector2){ (scaledScreenWidth + STATE_PANEL_WIDTH) / 2, STATE_PANEL_MARGIN });
+        UpdateTickRateMeter(&tickRateMeter, selectedRenderState->tickCount);
+        DrawSimSpeed(selectedRenderState->ticksPerSec, tickRateMeter.ticksPerSec, (Vector2){ (scaledScreenWidth + STATE_PANEL_WIDTH) / 2, STATE_PANEL_MARGIN });
+        UpdateTickRateMeter(&renderLoadMeter, renderBusyNanoseconds);
+        UpdateTickRateMeter(&simulationLoadMeter, atomic_load(&simulationBusyNanoseconds));
+        DrawFrameLoad(renderLoadMeter.ticksPerSec / TIMER_NANOSECONDS_PER_SECOND, GetFPS(), simulationLoadMeter.ticksPerSec / TIMER_NANOSECONDS_PER_SECOND, isArenaCached,
+                      (Vector2){ (scaledScreenWidth + STATE_PANEL_WIDTH) / 2, STATE_PANEL_MARGIN + 24 });
 
         DrawRectangleRec((Rectangle){ 0.0f, scaledScreenHeight - CONTROLS_HEIGHT, scaledScreenWidth, CONTROLS_HEIGHT }, WHITE);
         DrawControls((Vector2){ (scaledScreenWidth + STATE_PANEL_WIDTH) / 2, scaledScreenHeight - CONTROLS_HEIGHT });
-        
-        if (simulation.battleEnded) {
-          DrawWinner((Vector2){ (scaledScreenWidth + STATE_PANEL_WIDTH) / 2, scaledScreenHeight / 2 }, simulation.lastSurvivingRobotIndex);
+
+        for (size_t m = 0; m < matchCount; m++) {
+          Rectangle tileRect = GetMatchTileRect(arenaScreenRect, m);
+          if (renderStates[m]->battleEnded) {
+            DrawWinner((Vector2){ (tileRect.x + tileRect.width / 2) / dpi, (tileRect.y + tileRect.height / 2) / dpi }, renderStates[m]);
+          }
+          if (matchCount > 1) {
+            DrawMatchLabel(&matches[m], m == selectedMatchIndex, (Vector2){ tileRect.x / dpi + STATE_PANEL_MARGIN, tileRect.y / dpi });
+          }
         }
 
+        #ifdef USE_SIMULATION_WORKER
+        // Keep errors up until they are fixed
+        if (shownReloadMessage[0] != '\0' && (isShownReloadMessageError || GetTime() - shownReloadMessageTime < PROGRAM_RELOAD_MESSAGE_SECONDS)) {
+          DrawProgramReloadMessage(shownReloadMessage, isShownReloadMessageError, (Vector2){ STATE_PANEL_WIDTH + STATE_PANEL_MARGIN, CONTROLS_HEIGHT });
+        }
+        #endif
+
         DrawRectangleRec((Rectangle){ 0.0f, 0.0f, STATE_PANEL_WIDTH, scaledScreenHeight}, LIGHTGRAY);
-        for (unsigned int i = 0; i < simulation.robotCount; i++) {
-          DrawStatePanel(&simulation.robots[i], i, (Vector2){ 0, STATE_PANEL_HEIGHT * i });
+        for (unsigned int i = 0; i < selectedRenderState->robotCount; i++) {
+          DrawStatePanel(&selectedRenderState->robots[i], i, (Vector2){ 0, STATE_PANEL_HEIGHT * i });
         }
       } EndMode2D();
-    #ifdef USE_SIMULATION_WORKER
-    } pthread_mutex_unlock(&simulationWorker.stateMutex);
-    #endif
-    EndDrawing();
+
+      // Count the time until the frame is handed over, but not the wait for the next one
+      renderBusyNanoseconds += ReadTimeSource(&frameTimeSource) - frameStartTime;
+    } EndDrawing();
   }
 
   UnloadFont(primaryFont);
@@ -380,15 +706,38 @@ int main(int argc, char* argv[]) {
   UnloadShader(vBlurShader);
   UnloadRenderTexture(shadowsTarget0);
   UnloadRenderTexture(shadowsTarget1);
+  UnloadRenderTexture(arenaTarget);
   CloseWindow();
 
   #ifdef USE_SIMULATION_WORKER
+  if (programReloadWorker.isThreadValid) {
+    StopWorker(&programReloadWorker);
+    DestroyWorker(&programReloadWorker);
+    pthread_mutex_destroy(&programReloadMessageMutex);
+  }
+  DestroyFileWatcher(&programWatcher);
+
   printf("Stopping simulation thread\n");
   StopWorker(&simulationWorker);
   printf("Simulation thread stopped\n");
   DestroyWorker(&simulationWorker);
+  matches[0].simulation.host.threadPool = NULL;
+  DestroyThreadPool(&simulationThreadPool);
   #endif
 
+  // Save the recorded battle
+  if (recordFilePath != NULL) {
+    FinishReplayRecording(&replayRecorder, &matches[0].simulation);
+    if (replayRecorder.hasFailed || !TrySaveReplay(&replay, recordFilePath)) {
+      fprintf(stderr, "Failed to write replay file %s.\n", recordFilePath);
+    }
+  }
+  for (size_t i = 0; i < matchCount; i++) {
+    matches[i].simulation.host.timeline = NULL;
+    DestroyTimeline(&matches[i].timeline);
+  }
+  DestroyReplay(&replay);
+
   return 0;
 }
 
@@ -398,39 +747,272 @@ void EMSCRIPTEN_KEEPALIVE OnCanvasResize(int width, int height) {
   SetWindowSize(width, height);
 }
 
-const char* reloadAssemblyProgram(TextContents* programText, AssemblyProgram* assemblyProgram, uint8_t* initialMemory, Robot* robot, char* programStr) {
-  DestroyTextContents(programText);
-  *programText = InitTextContentsAsCopyCStr(programStr);
-  
-  memset(initialMemory, 0x00, MEMORY_SIZE * sizeof(uint8_t));
-  if (!TryParseAndAssembleProgram(programText, assemblyProgram, initialMemory)) {
+const char* reloadAssemblyProgram(size_t programIndex, char* programStr) {
+  DestroyTextContents(&programTexts[programIndex]);
+  programTexts[programIndex] = InitTextContentsAsCopyCStr(programStr);
+
+  uint8_t* memory = calloc(MEMORY_SIZE, sizeof(uint8_t));
+  if (memory == NULL) {
+    return "Out of memory.";
+  }
+  if (!TryParseAndAssembleProgram(&programTexts[programIndex], &programs[programIndex], memory, errorMsgBuffer, sizeof(errorMsgBuffer))) {
+    free(memory);
     return errorMsgBuffer;
   }
 
-  int64_t oldTicksPerSec = simulation.timer.ticksPerSec;
-  simulation.timer.ticksPerSec = 0;
-  memcpy(robot->processState.memory, initialMemory, MEMORY_SIZE * sizeof(uint8_t));
-  memset(&robot->processState.registers, 0x00, sizeof(RegistersState));
-  simulation.timer.ticksPerSec = oldTicksPerSec;
+  // Hand the image over to the simulation, which loads it before its next update
+  SimulationCommand command = { .kind = SIMULATION_COMMAND_RELOAD_PROGRAM, .reload = { .programIndex = programIndex, .memory = memory } };
+  if (!TryPushSimulationCommand(&simulationCommands, command)) {
+    free(memory);
+    return "Too many pending commands.";
+  }
 
   return "";
 }
 
 const char* EMSCRIPTEN_KEEPALIVE ReloadAssemblyProgramA(char* programStr) {
-  return reloadAssemblyProgram(&programTextA, &programA, initialMemoryA, &simulation.robots[0], programStr);
+  return reloadAssemblyProgram(0, programStr);
 }
 
 const char* EMSCRIPTEN_KEEPALIVE ReloadAssemblyProgramB(char* programStr) {
-  return reloadAssemblyProgram(&programTextB, &programB, initialMemoryB, &simulation.robots[1], programStr);
+  return reloadAssemblyProgram(1, programStr);
 }
 #endif
 
-bool TryParseAndAssembleProgram(const TextContents* programText, AssemblyProgram* assemblyProgramOut, uint8_t* memoryOut) {
+#ifdef USE_SIMULATION_WORKER
+int64_t UpdateMatchesFromWorker(void* state) {
+  (void)state;
+  UpdateMatchesWithCommands();
+
+  // Wait until the first match is due to step again
+  int64_t waitNs = -1;
+  for (size_t i = 0; i < matchCount; i++) {
+    int64_t matchWaitNs = GetTimerNanosecondsUntilTick(&matches[i].simulation.host.timer);
+    if (matchWaitNs >= 0 && (waitNs < 0 || matchWaitNs < waitNs)) {
+      waitNs = matchWaitNs;
+    }
+  }
+  return waitNs;
+}
+
+int64_t ReloadChangedPrograms(void* state) {
+  Worker* simulationWorker = (Worker*)state;
+  uint32_t changedFiles = WaitForFileChanges(&programWatcher, PROGRAM_RELOAD_WAIT_MS);
+  for (size_t i = 0; i < programWatcher.fileCount; i++) {
+    if (changedFiles & ((uint32_t)1 << i)) {
+      ReloadProgramFile(i, programWatcher.filePaths[i], simulationWorker);
+    }
+  }
+  return 0;
+}
+
+void ReloadProgramFile(size_t programIndex, const char* filePath, Worker* simulationWorker) {
+  char programName = (char)('A' + programIndex);
+  TextContents programText;
+  if (!TryInitTextContentsFromFile(filePath, &programText)) {
+    SetProgramReloadMessage(true, "Failed to read assembly file %c.\n", programName);
+    return;
+  }
+
+  // Assemble into a fresh image, which the simulation takes ownership of
+  uint8_t* memory = calloc(MEMORY_SIZE, sizeof(uint8_t));
+  if (memory == NULL) {
+    DestroyTextContents(&programText);
+    SetProgramReloadMessage(true, "Out of memory reloading program %c.\n", programName);
+    return;
+  }
+  AssemblyProgram program = { 0 };
+  char errorMsg[sizeof(programReloadMessage) - 64];
+  bool isAssembled = TryParseAndAssembleProgram(&programText, &program, memory, errorMsg, sizeof(errorMsg));
+  DestroyAssemblyProgram(&program);
+  DestroyTextContents(&programText);
+  if (!isAssembled) {
+    free(memory);
+    SetProgramReloadMessage(true, "Failed to assemble program %c:\n%s", programName, errorMsg);
+    return;
+  }
+
+  SimulationCommand command = { .kind = SIMULATION_COMMAND_RELOAD_PROGRAM, .reload = { .programIndex = programIndex, .memory = memory } };
+  if (!TryPushSimulationCommand(&programReloadCommands, command)) {
+    free(memory);
+    SetProgramReloadMessage(true, "Too many pending reloads of program %c.\n", programName);
+    return;
+  }
+  WakeWorker(simulationWorker);
+  SetProgramReloadMessage(false, "Reloaded program %c.\n", programName);
+}
+
+void SetProgramReloadMessage(bool isError, const char* format, ...) {
+  pthread_mutex_lock(&programReloadMessageMutex); {
+    va_list args;
+    va_start(args, format);
+    vsnprintf(programReloadMessage, sizeof(programReloadMessage), format, args);
+    va_end(args);
+    isProgramReloadMessageError = isError;
+    programReloadMessageCount++;
+    fputs(programReloadMessage, isError ? stderr : stdout);
+  } pthread_mutex_unlock(&programReloadMessageMutex);
+}
+#endif
+
+void UpdateMatchesWithCommands() {
+  TimeSource timeSource = InitMonotonicTimeSource();
+  int64_t startTime = ReadTimeSource(&timeSource);
+
+  SimulationCommand command;
+  while (TryPopSimulationCommand(&simulationCommands, &command)) {
+    ApplySimulationCommand(command);
+  }
+  #ifdef USE_SIMULATION_WORKER
+  while (TryPopSimulationCommand(&programReloadCommands, &command)) {
+    ApplySimulationCommand(command);
+  }
+
+  // Update several matches side by side, each following its own timer
+  if (matchCount > 1) {
+    RunThreadPoolTasks(&simulationThreadPool, matchCount, UpdateMatchTask, NULL);
+  } else {
+    UpdateMatch(&matches[0]);
+  }
+  #else
+  for (size_t i = 0; i < matchCount; i++) {
+    UpdateMatch(&matches[i]);
+  }
+  #endif
+
+  atomic_fetch_add(&simulationBusyNanoseconds, ReadTimeSource(&timeSource) - startTime);
+}
+
+void UpdateMatch(Match* match) {
+  UpdateSimulation(&match->simulation);
+
+  // Publish at intervals while running, and whenever the simulation is about to wait longer than that
+  TimeSource timeSource = InitMonotonicTimeSource();
+  int64_t time = ReadTimeSource(&timeSource);
+  int64_t waitNs = GetTimerNanosecondsUntilTick(&match->simulation.host.timer);
+  if (time - match->lastPublishTime >= RENDER_STATE_PUBLISH_INTERVAL_NANOSECONDS || waitNs < 0 || waitNs >= RENDER_STATE_PUBLISH_INTERVAL_NANOSECONDS) {
+    PublishRenderState(&match->renderStateBuffer, &match->simulation);
+    match->lastPublishTime = time;
+  }
+}
+
+void UpdateMatchTask(void* context, size_t taskIndex) {
+  (void)context;
+  UpdateMatch(&matches[taskIndex]);
+}
+
+void ApplySimulationCommand(SimulationCommand command) {
+  for (size_t i = 0; i < matchCount; i++) {
+    ApplySimulationCommandToMatch(&matches[i], command);
+  }
+
+  // Keep reloaded programs for when battles are restarted
+  if (command.kind == SIMULATION_COMMAND_RELOAD_PROGRAM) {
+    if (command.reload.programIndex < programCount) {
+      memcpy(initialMemories[command.reload.programIndex], command.reload.memory, MEMORY_SIZE * sizeof(uint8_t));
+    }
+    free(command.reload.memory);
+  }
+}
+
+void ApplySimulationCommandToMatch(Match* match, SimulationCommand command) {
+  Simulation* simulation = &match->simulation;
+  switch (command.kind) {
+    case SIMULATION_COMMAND_SET_SPEED:
+      SetTimerTicksPerSec(&simulation->host.timer, command.ticksPerSec);
+      break;
+
+    case SIMULATION_COMMAND_STEP:
+      for (uint64_t i = 0; i < command.stepCount; i++) {
+        StepSimulation(simulation);
+      }
+      break;
+
+    case SIMULATION_COMMAND_SEEK: {
+      if (simulation->host.timeline == NULL) { break; }
+      if (command.tickOffset >= 0) {
+        TrySeekTimeline(simulation->host.timeline, simulation, simulation->tickCount + (uint64_t)command.tickOffset);
+        break;
+      }
+
+      // Seek back as far as the timeline reaches
+      uint64_t startTick = GetTimelineStartTick(simulation->host.timeline);
+      uint64_t offsetTicks = (uint64_t)0 - (uint64_t)command.tickOffset;
+      uint64_t tick = simulation->tickCount > offsetTicks ? simulation->tickCount - offsetTicks : 0;
+      if (startTick <= simulation->tickCount) {
+        TrySeekTimeline(simulation->host.timeline, simulation, tick > startTick ? tick : startTick);
+      }
+      break;
+    }
+
+    case SIMULATION_COMMAND_RELOAD_PROGRAM:
+      for (size_t i = 0; i < simulation->robotCount; i++) {
+        if (match->programIndices[i] == command.reload.programIndex) {
+          Robot* robot = &simulation->robots[i];
+          memcpy(robot->processState.memory, command.reload.memory, MEMORY_SIZE * sizeof(uint8_t));
+          memset(&robot->processState.registers, 0x00, sizeof(RegistersState));
+        }
+      }
+      break;
+
+    case SIMULATION_COMMAND_RESET:
+      RestartBattle(match);
+      break;
+
+    case SIMULATION_COMMAND_SET_USER_KEYS:
+      simulation->host.heldUserKeys = command.userKeys;
+      break;
+  }
+}
+
+void RestartBattle(Match* match) {
+  Simulation* simulation = &match->simulation;
+
+  // Keep the battle's settings, while the host is kept by ReplaceSimulationBattle
+  bool useContinuousCollision = simulation->physicsWorld.useContinuousCollision;
+  bool useStaticDistanceField = simulation->physicsWorld.useStaticDistanceField;
+  unsigned int instructionsPerPhysicsStep = simulation->instructionsPerPhysicsStep;
+  uint64_t stallWindowTicks = simulation->stallWindowTicks;
+
+  ReplaceSimulationBattle(simulation, NULL);
+  simulation->physicsWorld.useContinuousCollision = useContinuousCollision;
+  simulation->physicsWorld.useStaticDistanceField = useStaticDistanceField;
+  simulation->instructionsPerPhysicsStep = instructionsPerPhysicsStep;
+  simulation->stallWindowTicks = stallWindowTicks;
+
+  // Rebuild the battle from where it came from, then load the programs again
+  if (simulation->host.replayPlayer != NULL) {
+    ApplyReplayToSimulation(&replay, simulation);
+    *simulation->host.replayPlayer = InitReplayPlayer(&replay);
+  } else {
+    ApplyArenaMapToSimulation(&map, simulation);
+  }
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    memcpy(simulation->robots[i].processState.memory, initialMemories[match->programIndices[i]], MEMORY_SIZE * sizeof(uint8_t));
+  }
+
+  if (simulation->host.timeline != NULL) {
+    ClearTimeline(simulation->host.timeline);
+  }
+  PrepSimulation(simulation);
+}
+
+unsigned int GetHeldUserKeys() {
+  unsigned int keys = 0;
+  if (IsKeyDown(KEY_UP)) { keys |= SIMULATION_USER_KEY_FORWARD; }
+  if (IsKeyDown(KEY_DOWN)) { keys |= SIMULATION_USER_KEY_BACKWARD; }
+  if (IsKeyDown(KEY_RIGHT)) { keys |= SIMULATION_USER_KEY_RIGHT; }
+  if (IsKeyDown(KEY_LEFT)) { keys |= SIMULATION_USER_KEY_LEFT; }
+  if (IsKeyDown(KEY_SPACE)) { keys |= SIMULATION_USER_KEY_FIRE; }
+  return keys;
+}
+
+bool TryParseAndAssembleProgram(const TextContents* programText, AssemblyProgram* assemblyProgramOut, uint8_t* memoryOut, char* errorMsgOut, size_t errorMsgSize) {
   ParsingErrorList parsingErrors = { 0 };
   if (!TryParseAssemblyProgram(programText, assemblyProgramOut, &parsingErrors)) {
     size_t written = 0;
-    for (size_t i = 0; i < parsingErrors.errorCount && written < sizeof(errorMsgBuffer); i++) {
-      int n = snprintf(errorMsgBuffer + written, sizeof(errorMsgBuffer) - written,
+    for (size_t i = 0; i < parsingErrors.errorCount && written < errorMsgSize; i++) {
+      int n = snprintf(errorMsgOut + written, errorMsgSize - written,
         "Line %zu, column %zu: %s.\n",
         parsingErrors.errors[i].sourceSpan.start.line + 1,
         parsingErrors.errors[i].sourceSpan.start.column + 1,
@@ -443,7 +1025,7 @@ bool TryParseAndAssembleProgram(const TextContents* programText, AssemblyProgram
 
   AssemblingError assemblingError = { 0 };
   if (!TryAssembleProgram(programText, assemblyProgramOut, memoryOut, &assemblingError)) {
-    snprintf(errorMsgBuffer, sizeof(errorMsgBuffer),
+    snprintf(errorMsgOut, errorMsgSize,
       "Line %zu, column %zu: %s.\n",
       assemblingError.sourceSpan.start.line + 1,
       assemblingError.sourceSpan.start.column + 1,
@@ -469,38 +1051,60 @@ void UpdateDpiAndMinWindowSize() {
   }
 }
 
+Rectangle GetMatchTileRect(Rectangle area, size_t matchIndex) {
+  // Lay the matches out in a grid that is as close to square as possible
+  size_t columnCount = (size_t)ceil(sqrt((double)matchCount));
+  size_t rowCount = (matchCount + columnCount - 1) / columnCount;
+  float tileWidth = area.width / columnCount;
+  float tileHeight = area.height / rowCount;
+  return (Rectangle){
+    .x = area.x + tileWidth * (matchIndex % columnCount),
+    .y = area.y + tileHeight * (matchIndex / columnCount),
+    .width = tileWidth,
+    .height = tileHeight,
+  };
+}
 
-void DrawArenaForeground() {
+Camera2D GetArenaCamera(Rectangle boundary, Rectangle screenRect) {
+  return (Camera2D){
+    .target = { boundary.x + boundary.width / 2, boundary.y + boundary.height / 2 },
+    .offset = { screenRect.x + screenRect.width / 2, screenRect.y + screenRect.height / 2 },
+    .zoom = fmin((screenRect.width - 2 * ARENA_MARGIN) / (boundary.width + ARENA_BORDER_THICKNESS * 2),
+                 (screenRect.height - 2 * ARENA_MARGIN) / (boundary.height + ARENA_BORDER_THICKNESS * 2)),
+  };
+}
+
+
+void DrawArenaForeground(Rectangle boundary) {
   // Mask outside of arena in white
   DrawRectangleRec((Rectangle){
-    .x=-ARENA_WIDTH / 2 - 100, .y=-ARENA_HEIGHT / 2 - 100,
-    .width=ARENA_WIDTH + 200, .height=100
+    .x=boundary.x - 100, .y=boundary.y - 100,
+    .width=boundary.width + 200, .height=100
   }, BACKGROUND_COLOR);
   DrawRectangleRec((Rectangle){
-    .x=-ARENA_WIDTH / 2 - 100, .y=ARENA_HEIGHT / 2,
-    .width=ARENA_WIDTH + 200, .height=100
+    .x=boundary.x - 100, .y=boundary.y + boundary.height,
+    .width=boundary.width + 200, .height=100
   }, BACKGROUND_COLOR);
   DrawRectangleRec((Rectangle){
-    .x=-ARENA_WIDTH / 2 - 100, .y=-ARENA_HEIGHT / 2 - 100,
-    .width=100, .height=ARENA_HEIGHT + 200
+    .x=boundary.x - 100, .y=boundary.y - 100,
+    .width=100, .height=boundary.height + 200
   }, BACKGROUND_COLOR);
   DrawRectangleRec((Rectangle){
-    .x=ARENA_WIDTH / 2, .y=-ARENA_HEIGHT / 2 - 100,
-    .width=100, .height=ARENA_HEIGHT + 200
+    .x=boundary.x + boundary.width, .y=boundary.y - 100,
+    .width=100, .height=boundary.height + 200
   }, BACKGROUND_COLOR);
 
   // Draw border
   DrawRectangleLinesEx((Rectangle){
-    .x=-ARENA_WIDTH / 2 - ARENA_BORDER_THICKNESS, .y=-ARENA_HEIGHT / 2 - ARENA_BORDER_THICKNESS,
-    .width=ARENA_WIDTH + ARENA_BORDER_THICKNESS * 2, .height=ARENA_HEIGHT + ARENA_BORDER_THICKNESS * 2
+    .x=boundary.x - ARENA_BORDER_THICKNESS, .y=boundary.y - ARENA_BORDER_THICKNESS,
+    .width=boundary.width + ARENA_BORDER_THICKNESS * 2, .height=boundary.height + ARENA_BORDER_THICKNESS * 2
   }, ARENA_BORDER_THICKNESS, GRAY);
 }
 
 
-void DrawRobot(const PhysicsWorld* physicsWorld, const Robot* robot, Color baseColor, unsigned int layer) {
-  const PhysicsBody* body = &physicsWorld->bodies[robot->physicsBodyIndex];
-  Vector2 position = { body->position.x, body->position.y };
-  double rotation = body->rotation;
+void DrawRobot(const RobotRenderState* robot, Color baseColor, unsigned int layer) {
+  Vector2 position = robot->position;
+  double rotation = robot->rotation;
 
   switch (layer) {
     case 0: {
@@ -548,11 +1152,12 @@ void DrawRobot(const PhysicsWorld* physicsWorld, const Robot* robot, Color baseC
         (Rectangle){ .x=position.x, .y=position.y, .width=ROBOT_TURRET_LENGTH, .height=ROBOT_TURRET_WIDTH},
         (Vector2){ -ROBOT_TURRET_OFFSET, ROBOT_TURRET_WIDTH / 2 },
         rotation * RAD2DEG, turretColor);
+      float sinRotation, cosRotation;
+      FastSinCos(rotation, &sinRotation, &cosRotation);
+      Vector2 turretTip = { position.x + ROBOT_TURRET_OFFSET * cosRotation, position.y + ROBOT_TURRET_OFFSET * sinRotation };
+      DrawCircleV(turretTip, ROBOT_TURRET_WIDTH / 2, turretColor);
       DrawCircleV(
-        (Vector2){ position.x + ROBOT_TURRET_OFFSET * cos(rotation), position.y + ROBOT_TURRET_OFFSET * sin(rotation) },
-        ROBOT_TURRET_WIDTH / 2, turretColor);
-      DrawCircleV(
-        (Vector2){ position.x + ROBOT_TURRET_OFFSET * cos(rotation), position.y + ROBOT_TURRET_OFFSET * sin(rotation) },
+        turretTip,
         ROBOT_TURRET_WIDTH / 4, robot->weaponCooldownRemaining > 0 || robot->energyRemaining <= 0 ? GRAY : RED);
     } break;
   }
@@ -595,12 +1200,13 @@ void DrawStaticBody(const PhysicsBody* body, unsigned int layer) {
   }
 }
 
-void DrawSimSpeed(int64_t ticksPerSec, Vector2 position) {
+void DrawSimSpeed(int64_t ticksPerSec, double achievedTicksPerSec, Vector2 position) {
   char buffer[1024];
   if (ticksPerSec == 0) {
     snprintf(buffer, sizeof(buffer), "Simulation Speed: Paused");
-  } else if (ticksPerSec == INT64_MAX) {
-    snprintf(buffer, sizeof(buffer), "Simulation Speed: Max   ");
+  } else if (ticksPerSec == SIMULATION_MAX_SPEED_TICKS_PER_SECOND) {
+    double speed = achievedTicksPerSec / SIMULATION_DEFAULT_TICKS_PER_SECOND;
+    snprintf(buffer, sizeof(buffer), "Simulation Speed: Max (%.1fx, %.0f ticks/s)", speed, achievedTicksPerSec);
   } else {
     double speed = (double)ticksPerSec / SIMULATION_DEFAULT_TICKS_PER_SECOND;
     snprintf(buffer, sizeof(buffer), "Simulation Speed: %.3fx", speed);
@@ -610,34 +1216,62 @@ void DrawSimSpeed(int64_t ticksPerSec, Vector2 position) {
   DrawTextEx(primaryFont, buffer, (Vector2){ position.x - width / 2, position.y }, 18, 1.0, DARKGRAY);
 }
 
+void DrawFrameLoad(double renderLoad, int frameRate, double simulationLoad, bool isArenaCached, Vector2 position) {
+  char buffer[1024];
+  double renderMilliseconds = frameRate > 0 ? renderLoad * 1000.0 / frameRate : 0.0;
+  int length = snprintf(buffer, sizeof(buffer), "Render: %.0f%% (%.1f ms/frame at %d fps), Simulation: %.0f%%",
+                        renderLoad * 100.0, renderMilliseconds, frameRate, simulationLoad * 100.0);
+  if (isArenaCached && length > 0 && (size_t)length < sizeof(buffer)) {
+    snprintf(buffer + length, sizeof(buffer) - length, ", arena at %d fps", FAST_SIMULATION_ARENA_FRAME_RATE);
+  }
+
+  float width = MeasureTextEx(primaryFont, buffer, 15, 1.0).x;
+  DrawTextEx(primaryFont, buffer, (Vector2){ position.x - width / 2, position.y }, 15, 1.0, GRAY);
+}
+
 void DrawControls(Vector2 position) {
-  const char* controls = "Sim. Speed Controls: 0 = pause, 1 = 0.001x, 2 = 0.25x, 3 = 0.5x, 4 = normal\n"
-                         "                     5 = 2x,    6 = 4x,     7 = max,   tab = step once\n"
+  const char* controls = "Sim. Speed Controls: 0 = pause, 1 = 0.001x, 2 = 0.25x, 3 = 0.5x, 4 = normal, 5 = 2x\n"
+                         "                     6 = 4x,    7 = 16x,    8 = max,   tab = step once,  [ / ] = seek 1s,  r = restart\n"
                          "Manual Robot Controls (purple): arrow keys = move, space = shoot";
   float width = MeasureTextEx(primaryFont, controls, 15, 1.0).x;
   DrawTextEx(primaryFont, controls, (Vector2){ position.x - width / 2, position.y }, 15, 1.0, DARKGRAY);
 }
 
-void DrawWinner(Vector2 position, size_t index) {
+void DrawWinner(Vector2 position, const RenderState* renderState) {
+  const char* reason = "";
+  switch (renderState->battleEndReason) {
+    case BATTLE_END_TICK_LIMIT: reason = " (time limit)"; break;
+    case BATTLE_END_STALL: reason = " (stalled)"; break;
+    default: break;
+  }
+
   char buffer[1024];
-  snprintf(buffer, sizeof(buffer), "Robot %zu wins!", index + 1);
+  if (renderState->battleDrawn) {
+    snprintf(buffer, sizeof(buffer), "Draw!%s", reason);
+  } else {
+    snprintf(buffer, sizeof(buffer), "Robot %zu wins!%s", renderState->winningRobotIndex + 1, reason);
+  }
   
   Vector2 size = MeasureTextEx(primaryFont, buffer, 24, 1.0);
   DrawTextEx(primaryFont, buffer, (Vector2){ position.x - size.x / 2, position.y - size.y / 2 }, 24, 1.0, BLACK);
 }
 
-void DrawStatePanel(const Robot* robot, size_t index, Vector2 position) {
+void DrawMatchLabel(const Match* match, bool isSelected, Vector2 position) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%c vs %c", (char)('A' + match->programIndices[0]), (char)('A' + match->programIndices[1]));
+  DrawTextEx(primaryFont, buffer, position, 15, 1.0, isSelected ? BLACK : GRAY);
+}
+
+void DrawStatePanel(const RobotRenderState* robot, size_t index, Vector2 position) {
   char buffer[1024];
   Vector2 topLeft = { position.x + STATE_PANEL_MARGIN, position.y + STATE_PANEL_MARGIN };
   Vector2 bottomRight = { position.x + STATE_PANEL_WIDTH - STATE_PANEL_MARGIN, position.y + STATE_PANEL_HEIGHT - STATE_PANEL_MARGIN };
   
   // Compute state info
   float energyPercent = fmax(0.0f, fmin(1.0f, (float)robot->energyRemaining / ROBOT_INITIAL_ENERGY));
-  const struct ProcessState* processState = &robot->processState;
+  const RegistersState* registers = &robot->registers;
+  struct Instruction nextInstruction = robot->nextInstruction;
 
-  struct Instruction nextInstruction;
-  fetchInstruction(processState->memory, processState->registers.ip, &nextInstruction);
-  
   const struct OpcodeInfo* opcodeInfo = getOpcodeInfo(nextInstruction.opcode);
   bool hasRegA = opcodeInfo->layout.hasRegA;
   bool hasRegB = opcodeInfo->layout.hasRegB;
@@ -671,11 +1305,11 @@ void DrawStatePanel(const Robot* robot, size_t index, Vector2 position) {
     "x3: %04x  x4: %04x  x5: %04x\n"
     "x6: %04x  x7: %04x  x8: %04x\n"
     "x9: %04x  x10:%04x  x11:%04x",
-    processState->registers.ip, processState->registers.sp, processState->registers.rt,
-    processState->registers.x0, processState->registers.x1, processState->registers.x2,
-    processState->registers.x3, processState->registers.x4, processState->registers.x5,
-    processState->registers.x6, processState->registers.x7, processState->registers.x8,
-    processState->registers.x9, processState->registers.x10, processState->registers.x11
+    registers->ip, registers->sp, registers->rt,
+    registers->x0, registers->x1, registers->x2,
+    registers->x3, registers->x4, registers->x5,
+    registers->x6, registers->x7, registers->x8,
+    registers->x9, registers->x10, registers->x11
   );
   DrawTextEx(primaryFont, buffer, (Vector2){ topLeft.x + 10, topLeft.y }, 15, 1.0, BLACK);
   topLeft.y += 5*15 + 4*2 + 2;
@@ -714,3 +1348,7 @@ void DrawStatePanel(const Robot* robot, size_t index, Vector2 position) {
   DrawTextEx(primaryFont, buffer, (Vector2){ topLeft.x + 10, topLeft.y }, 15, 1.0, BLACK);
   //topLeft.y += 6*15 + 5*2 + STATE_PANEL_MARGIN; // Uncomment to measure height of panel
 }
+
+void DrawProgramReloadMessage(const char* message, bool isError, Vector2 position) {
+  DrawTextEx(primaryFont, message, position, 15, 1.0, isError ? MAROON : DARKGREEN);
+}
@@ -0,0 +1,35 @@
+#include "arena/command_queue.h"
+
+_Static_assert((SIMULATION_COMMAND_QUEUE_CAPACITY & (SIMULATION_COMMAND_QUEUE_CAPACITY - 1)) == 0, "Command queue capacity must be a power of two");
+
+
+void InitSimulationCommandQueue(SimulationCommandQueue* queue) {
+  atomic_init(&queue->pushCount, 0);
+  atomic_init(&queue->popCount, 0);
+}
+
+bool TryPushSimulationCommand(SimulationCommandQueue* queue, SimulationCommand command) {
+  size_t pushCount = atomic_load_explicit(&queue->pushCount, memory_order_relaxed);
+  size_t popCount = atomic_load_explicit(&queue->popCount, memory_order_acquire);
+  if (pushCount - popCount >= SIMULATION_COMMAND_QUEUE_CAPACITY) {
+    return false;
+  }
+
+  // Fill in the slot before publishing it to the consumer
+  queue->commands[pushCount % SIMULATION_COMMAND_QUEUE_CAPACITY] = command;
+  atomic_store_explicit(&queue->pushCount, pushCount + 1, memory_order_release);
+  return true;
+}
+
+bool TryPopSimulationCommand(SimulationCommandQueue* queue, SimulationCommand* commandOut) {
+  size_t popCount = atomic_load_explicit(&queue->popCount, memory_order_relaxed);
+  size_t pushCount = atomic_load_explicit(&queue->pushCount, memory_order_acquire);
+  if (popCount == pushCount) {
+    return false;
+  }
+
+  // Read out the slot before handing it back to the producer
+  *commandOut = queue->commands[popCount % SIMULATION_COMMAND_QUEUE_CAPACITY];
+  atomic_store_explicit(&queue->popCount, popCount + 1, memory_order_release);
+  return true;
+}
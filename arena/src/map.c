@@ -0,0 +1,489 @@
+#include "arena/map.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <raymath.h>
+#include "utilities/bytes.h"
+#include "utilities/file.h"
+
+#define DEFAULT_ARENA_WIDTH 1000.0f
+#define DEFAULT_ARENA_HEIGHT 1000.0f
+#define DEFAULT_OBSTACLE_WIDTH (ROBOT_RADIUS)
+#define DEFAULT_OBSTACLE_HEIGHT (DEFAULT_ARENA_HEIGHT / 2)
+
+#define MAP_MAX_LINE_LENGTH 256
+#define MAP_MAX_LINE_TOKENS 8
+
+// Binary maps store every field as a little-endian 32-bit integer or float. The header holds the magic, version,
+// flags, a 64-bit geometry hash, boundary, obstacle count and spawn count, and is followed by the obstacles, the spawns
+// and then the index.
+#define MAP_BINARY_FLAG_HAS_INDEX 0x1
+#define MAP_BINARY_OBSTACLE_KIND_CIRCLE 0
+#define MAP_BINARY_OBSTACLE_KIND_RECTANGLE 1
+#define MAP_BINARY_OBSTACLE_FIELD_COUNT 5
+
+// The 64-bit FNV-1a parameters used to hash the geometry an index was baked from.
+#define MAP_FNV_OFFSET_BASIS 0xCBF29CE484222325ULL
+#define MAP_FNV_PRIME 0x100000001B3ULL
+
+const char MAP_FILE_UNREADABLE[] = "Map file could not be read";
+const char MAP_FILE_TRUNCATED[] = "Map file ends unexpectedly";
+const char MAP_UNSUPPORTED_VERSION[] = "Map file version is not supported";
+const char MAP_INVALID_LINE[] = "Invalid line";
+const char MAP_INVALID_NUMBER[] = "Invalid number";
+const char MAP_INVALID_BOUNDARY[] = "Map boundary is missing or has no area";
+const char MAP_INVALID_OBSTACLE[] = "Obstacle size must be positive";
+const char MAP_TOO_MANY_OBSTACLES[] = "Map has too many obstacles";
+const char MAP_TOO_MANY_SPAWNS[] = "Map has too many spawn points";
+const char MAP_TOO_FEW_SPAWNS[] = "Map has fewer spawn points than robots";
+const char MAP_SPAWN_OUT_OF_BOUNDS[] = "Spawn point is outside of the map boundary";
+const char MAP_INVALID_INDEX[] = "Map index does not cover the map boundary";
+const char MAP_INDEX_MISMATCH[] = "Map index does not match the map's obstacles";
+
+
+// Parses the bytes of a map file in either form.
+bool tryLoadArenaMapBytes(const uint8_t* bytes, size_t length, ArenaMap* mapOut, ArenaMapError* error);
+
+// Checks the parts of a map that both forms must agree on, such as having enough spawn points for every robot.
+bool validateArenaMap(const ArenaMap* map, ArenaMapError* error);
+// Outputs the kind and the position, rotation and size fields an obstacle is stored as in the binary form.
+void encodeMapObstacle(const MapObstacle* obstacle, uint32_t* kindOut, float fieldsOut[MAP_BINARY_OBSTACLE_FIELD_COUNT]);
+// Hashes the boundary and obstacles in their stored form, which an index must have been baked from to be trusted.
+uint64_t hashMapGeometry(const ArenaMap* map);
+// Folds the little-endian bytes of a value into an FNV-1a hash.
+uint64_t hashMapU32(uint64_t hash, uint32_t value);
+uint64_t hashMapF32(uint64_t hash, float value);
+
+// Splits a text line into whitespace-separated tokens in place, ignoring anything after a '#'.
+size_t tokenizeMapLine(char* line, char** tokensOut);
+// Parses each of the given tokens as a finite number.
+bool tryParseMapNumbers(char** tokens, size_t tokenCount, float* valuesOut);
+
+
+ArenaMap InitDefaultArenaMap(void) {
+  ArenaMap map = {
+    .boundary = (Rectangle){
+      .x = -DEFAULT_ARENA_WIDTH / 2, .y = -DEFAULT_ARENA_HEIGHT / 2,
+      .width = DEFAULT_ARENA_WIDTH, .height = DEFAULT_ARENA_HEIGHT
+    },
+    .obstacleCount = 2,
+    .obstacles = {
+      {
+        .position = { -DEFAULT_ARENA_WIDTH / 4, 0 },
+        .collider = { .kind = PHYSICS_COLLIDER_RECTANGLE, .widthHeight = { DEFAULT_OBSTACLE_WIDTH, DEFAULT_OBSTACLE_HEIGHT } }
+      },
+      {
+        .position = { DEFAULT_ARENA_WIDTH / 4, 0 },
+        .collider = { .kind = PHYSICS_COLLIDER_RECTANGLE, .widthHeight = { DEFAULT_OBSTACLE_WIDTH, DEFAULT_OBSTACLE_HEIGHT } }
+      },
+    },
+    .spawnCount = 2,
+    .spawns = {
+      { .position = { -DEFAULT_ARENA_WIDTH / 2 + ROBOT_RADIUS * 2, 0 }, .rotation = 0 },
+      { .position = { DEFAULT_ARENA_WIDTH / 2 - ROBOT_RADIUS * 2, 0 }, .rotation = PI },
+    },
+  };
+  return map;
+}
+
+bool TryLoadArenaMap(const char* filePath, ArenaMap* mapOut, ArenaMapError* error) {
+  *error = (ArenaMapError){ 0 };
+
+  FileBytes contents;
+  if (!TryReadAllBytes(filePath, &contents)) {
+    error->message = MAP_FILE_UNREADABLE;
+    return false;
+  }
+
+  bool success = tryLoadArenaMapBytes(contents.bytes, contents.length, mapOut, error);
+  ReleaseFileBytes(&contents);
+  return success;
+}
+
+bool TryParseArenaMapText(const char* text, size_t length, ArenaMap* mapOut, ArenaMapError* error) {
+  *error = (ArenaMapError){ 0 };
+  *mapOut = (ArenaMap){ 0 };
+
+  size_t lineStart = 0;
+  for (size_t lineNumber = 1; lineStart < length; lineNumber++) {
+    // Copy the line so that it can be tokenized in place
+    size_t lineEnd = lineStart;
+    while (lineEnd < length && text[lineEnd] != '\n') { lineEnd++; }
+    char line[MAP_MAX_LINE_LENGTH];
+    size_t lineLength = lineEnd - lineStart;
+    if (lineLength >= sizeof(line)) {
+      *error = (ArenaMapError){ .message = MAP_INVALID_LINE, .line = lineNumber };
+      return false;
+    }
+    memcpy(line, &text[lineStart], lineLength);
+    line[lineLength] = '\0';
+    lineStart = lineEnd + 1;
+
+    char* tokens[MAP_MAX_LINE_TOKENS];
+    size_t tokenCount = tokenizeMapLine(line, tokens);
+    if (tokenCount == 0) {
+      continue;
+    }
+
+    float values[MAP_MAX_LINE_TOKENS];
+    size_t valueCount = tokenCount - 1;
+    if (!tryParseMapNumbers(&tokens[1], valueCount, values)) {
+      *error = (ArenaMapError){ .message = MAP_INVALID_NUMBER, .line = lineNumber };
+      return false;
+    }
+
+    if (strcmp(tokens[0], "boundary") == 0 && valueCount == 4) {
+      mapOut->boundary = (Rectangle){ values[0], values[1], values[2], values[3] };
+    } else if (strcmp(tokens[0], "rectangle") == 0 && (valueCount == 4 || valueCount == 5)) {
+      if (mapOut->obstacleCount >= MAP_MAX_OBSTACLES) {
+        *error = (ArenaMapError){ .message = MAP_TOO_MANY_OBSTACLES, .line = lineNumber };
+        return false;
+      }
+      if (!(values[2] > 0 && values[3] > 0)) {
+        *error = (ArenaMapError){ .message = MAP_INVALID_OBSTACLE, .line = lineNumber };
+        return false;
+      }
+      mapOut->obstacles[mapOut->obstacleCount++] = (MapObstacle){
+        .position = { values[0], values[1] },
+        .rotation = valueCount == 5 ? values[4] * DEG2RAD : 0,
+        .collider = { .kind = PHYSICS_COLLIDER_RECTANGLE, .widthHeight = { values[2], values[3] } },
+      };
+    } else if (strcmp(tokens[0], "circle") == 0 && valueCount == 3) {
+      if (mapOut->obstacleCount >= MAP_MAX_OBSTACLES) {
+        *error = (ArenaMapError){ .message = MAP_TOO_MANY_OBSTACLES, .line = lineNumber };
+        return false;
+      }
+      if (!(values[2] > 0)) {
+        *error = (ArenaMapError){ .message = MAP_INVALID_OBSTACLE, .line = lineNumber };
+        return false;
+      }
+      mapOut->obstacles[mapOut->obstacleCount++] = (MapObstacle){
+        .position = { values[0], values[1] },
+        .collider = { .kind = PHYSICS_COLLIDER_CIRCLE, .radius = values[2] },
+      };
+    } else if (strcmp(tokens[0], "spawn") == 0 && (valueCount == 2 || valueCount == 3)) {
+      if (mapOut->spawnCount >= MAP_MAX_SPAWNS) {
+        *error = (ArenaMapError){ .message = MAP_TOO_MANY_SPAWNS, .line = lineNumber };
+        return false;
+      }
+      mapOut->spawns[mapOut->spawnCount++] = (MapSpawn){
+        .position = { values[0], values[1] },
+        .rotation = valueCount == 3 ? values[2] * DEG2RAD : 0,
+      };
+    } else {
+      *error = (ArenaMapError){ .message = MAP_INVALID_LINE, .line = lineNumber };
+      return false;
+    }
+  }
+
+  return validateArenaMap(mapOut, error);
+}
+
+bool TryReadArenaMapBinary(const uint8_t* bytes, size_t length, ArenaMap* mapOut, ArenaMapError* error) {
+  *error = (ArenaMapError){ 0 };
+  *mapOut = (ArenaMap){ 0 };
+
+  ByteReader reader = { .bytes = bytes, .length = length };
+  size_t magicLength = strlen(MAP_BINARY_MAGIC);
+  if (length < magicLength || memcmp(bytes, MAP_BINARY_MAGIC, magicLength) != 0) {
+    error->message = MAP_FILE_UNREADABLE;
+    return false;
+  }
+  reader.offset = magicLength;
+
+  // Read the header
+  uint32_t version, flags, obstacleCount, spawnCount;
+  uint64_t geometryHash;
+  if (!TryReadU32(&reader, &version)) {
+    error->message = MAP_FILE_TRUNCATED;
+    return false;
+  }
+  if (version != MAP_BINARY_VERSION) {
+    error->message = MAP_UNSUPPORTED_VERSION;
+    return false;
+  }
+  if (!TryReadU32(&reader, &flags) || !TryReadU64(&reader, &geometryHash)
+      || !TryReadF32(&reader, &mapOut->boundary.x) || !TryReadF32(&reader, &mapOut->boundary.y)
+      || !TryReadF32(&reader, &mapOut->boundary.width) || !TryReadF32(&reader, &mapOut->boundary.height)
+      || !TryReadU32(&reader, &obstacleCount) || !TryReadU32(&reader, &spawnCount)) {
+    error->message = MAP_FILE_TRUNCATED;
+    return false;
+  }
+  if (obstacleCount > MAP_MAX_OBSTACLES) {
+    error->message = MAP_TOO_MANY_OBSTACLES;
+    return false;
+  }
+  if (spawnCount > MAP_MAX_SPAWNS) {
+    error->message = MAP_TOO_MANY_SPAWNS;
+    return false;
+  }
+
+  // Read the obstacles
+  for (uint32_t i = 0; i < obstacleCount; i++) {
+    MapObstacle* obstacle = &mapOut->obstacles[i];
+    uint32_t kind;
+    float width, height;
+    if (!TryReadU32(&reader, &kind)
+        || !TryReadF32(&reader, &obstacle->position.x) || !TryReadF32(&reader, &obstacle->position.y)
+        || !TryReadF32(&reader, &obstacle->rotation)
+        || !TryReadF32(&reader, &width) || !TryReadF32(&reader, &height)) {
+      error->message = MAP_FILE_TRUNCATED;
+      return false;
+    }
+
+    if (kind == MAP_BINARY_OBSTACLE_KIND_CIRCLE && width > 0) {
+      obstacle->collider = (PhysicsCollider){ .kind = PHYSICS_COLLIDER_CIRCLE, .radius = width };
+    } else if (kind == MAP_BINARY_OBSTACLE_KIND_RECTANGLE && width > 0 && height > 0) {
+      obstacle->collider = (PhysicsCollider){ .kind = PHYSICS_COLLIDER_RECTANGLE, .widthHeight = { width, height } };
+    } else {
+      error->message = MAP_INVALID_OBSTACLE;
+      return false;
+    }
+  }
+  mapOut->obstacleCount = obstacleCount;
+
+  // Read the spawn points
+  for (uint32_t i = 0; i < spawnCount; i++) {
+    MapSpawn* spawn = &mapOut->spawns[i];
+    if (!TryReadF32(&reader, &spawn->position.x) || !TryReadF32(&reader, &spawn->position.y)
+        || !TryReadF32(&reader, &spawn->rotation)) {
+      error->message = MAP_FILE_TRUNCATED;
+      return false;
+    }
+  }
+  mapOut->spawnCount = spawnCount;
+
+  // Read the index, which must be laid out the way BakePhysicsDistanceField lays out a field for the boundary
+  if (flags & MAP_BINARY_FLAG_HAS_INDEX) {
+    PhysicsDistanceField* field = &mapOut->distanceField;
+    uint32_t columnCount, rowCount;
+    if (!TryReadF32(&reader, &field->origin.x) || !TryReadF32(&reader, &field->origin.y)
+        || !TryReadF32(&reader, &field->cellSize)
+        || !TryReadU32(&reader, &columnCount) || !TryReadU32(&reader, &rowCount)) {
+      error->message = MAP_FILE_TRUNCATED;
+      return false;
+    }
+    if (columnCount == 0 || columnCount > PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1
+        || rowCount == 0 || rowCount > PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1
+        || !(field->cellSize > 0)
+        || field->origin.x != mapOut->boundary.x || field->origin.y != mapOut->boundary.y
+        || (columnCount - 1) * field->cellSize < mapOut->boundary.width
+        || (rowCount - 1) * field->cellSize < mapOut->boundary.height) {
+      error->message = MAP_INVALID_INDEX;
+      return false;
+    }
+    field->columnCount = columnCount;
+    field->rowCount = rowCount;
+
+    for (uint32_t i = 0; i < columnCount * rowCount; i++) {
+      if (!TryReadF32(&reader, &field->distances[i])) {
+        error->message = MAP_FILE_TRUNCATED;
+        return false;
+      }
+    }
+    field->isBaked = true;
+    mapOut->hasDistanceField = true;
+  }
+
+  if (!validateArenaMap(mapOut, error)) {
+    return false;
+  }
+  // An index baked from other geometry would let robots pass through obstacles, so it is only trusted when it was
+  // written alongside the same boundary and obstacles
+  if (mapOut->hasDistanceField && geometryHash != hashMapGeometry(mapOut)) {
+    error->message = MAP_INDEX_MISMATCH;
+    return false;
+  }
+  return true;
+}
+
+bool TrySaveArenaMapBinary(const ArenaMap* map, const char* filePath) {
+  FILE* file = fopen(filePath, "wb");
+  if (file == NULL) {
+    return false;
+  }
+
+  bool success = TryWriteArenaMapBinary(map, file);
+  return fclose(file) == 0 && success;
+}
+
+bool TryWriteArenaMapBinary(const ArenaMap* map, FILE* file) {
+  // Write the header
+  bool success = fwrite(MAP_BINARY_MAGIC, 1, strlen(MAP_BINARY_MAGIC), file) == strlen(MAP_BINARY_MAGIC)
+    && TryWriteU32(file, MAP_BINARY_VERSION)
+    && TryWriteU32(file, map->hasDistanceField ? MAP_BINARY_FLAG_HAS_INDEX : 0)
+    && TryWriteU64(file, hashMapGeometry(map))
+    && TryWriteF32(file, map->boundary.x) && TryWriteF32(file, map->boundary.y)
+    && TryWriteF32(file, map->boundary.width) && TryWriteF32(file, map->boundary.height)
+    && TryWriteU32(file, map->obstacleCount) && TryWriteU32(file, map->spawnCount);
+
+  // Write the obstacles
+  for (unsigned int i = 0; success && i < map->obstacleCount; i++) {
+    uint32_t kind;
+    float fields[MAP_BINARY_OBSTACLE_FIELD_COUNT];
+    encodeMapObstacle(&map->obstacles[i], &kind, fields);
+    success = TryWriteU32(file, kind);
+    for (unsigned int j = 0; success && j < MAP_BINARY_OBSTACLE_FIELD_COUNT; j++) {
+      success = TryWriteF32(file, fields[j]);
+    }
+  }
+
+  // Write the spawn points
+  for (unsigned int i = 0; success && i < map->spawnCount; i++) {
+    const MapSpawn* spawn = &map->spawns[i];
+    success = TryWriteF32(file, spawn->position.x) && TryWriteF32(file, spawn->position.y)
+      && TryWriteF32(file, spawn->rotation);
+  }
+
+  // Write the index
+  if (success && map->hasDistanceField) {
+    const PhysicsDistanceField* field = &map->distanceField;
+    success = TryWriteF32(file, field->origin.x) && TryWriteF32(file, field->origin.y)
+      && TryWriteF32(file, field->cellSize)
+      && TryWriteU32(file, field->columnCount) && TryWriteU32(file, field->rowCount);
+    for (unsigned int i = 0; success && i < field->columnCount * field->rowCount; i++) {
+      success = TryWriteF32(file, field->distances[i]);
+    }
+  }
+
+  return success;
+}
+
+void BakeArenaMapDistanceField(ArenaMap* map) {
+  PhysicsWorld world = { .boundary = map->boundary };
+  for (unsigned int i = 0; i < map->obstacleCount; i++) {
+    world.bodies[world.bodyCount++] = (PhysicsBody){
+      .isStatic = true,
+      .position = map->obstacles[i].position,
+      .rotation = map->obstacles[i].rotation,
+      .collider = map->obstacles[i].collider,
+    };
+  }
+
+  BakePhysicsDistanceField(&world);
+  map->distanceField = world.staticDistanceField;
+  map->hasDistanceField = world.staticDistanceField.isBaked;
+}
+
+void ApplyArenaMapToSimulation(const ArenaMap* map, Simulation* simulation) {
+  PhysicsWorld* physicsWorld = &simulation->physicsWorld;
+  physicsWorld->boundary = map->boundary;
+
+  for (unsigned int i = 0; i < map->spawnCount && i < SIMULATION_MAX_ROBOTS; i++) {
+    AddRobotToSimulation(simulation, map->spawns[i].position, map->spawns[i].rotation);
+  }
+  for (unsigned int i = 0; i < map->obstacleCount; i++) {
+    AddObstacleToSimulation(simulation, map->obstacles[i].position, map->obstacles[i].rotation, map->obstacles[i].collider);
+  }
+
+  // Adding the obstacles cleared the world's field, so the index is copied in afterwards
+  if (map->hasDistanceField && physicsWorld->useStaticDistanceField && !physicsWorld->useFixedPoint) {
+    physicsWorld->staticDistanceField = map->distanceField;
+  }
+}
+
+
+bool tryLoadArenaMapBytes(const uint8_t* bytes, size_t length, ArenaMap* mapOut, ArenaMapError* error) {
+  size_t magicLength = strlen(MAP_BINARY_MAGIC);
+  if (length >= magicLength && memcmp(bytes, MAP_BINARY_MAGIC, magicLength) == 0) {
+    return TryReadArenaMapBinary(bytes, length, mapOut, error);
+  }
+  return TryParseArenaMapText((const char*)bytes, length, mapOut, error);
+}
+
+bool validateArenaMap(const ArenaMap* map, ArenaMapError* error) {
+  const Rectangle* boundary = &map->boundary;
+  if (!(boundary->width > 0 && boundary->height > 0)) {
+    error->message = MAP_INVALID_BOUNDARY;
+    return false;
+  }
+  if (map->spawnCount < SIMULATION_MAX_ROBOTS) {
+    error->message = MAP_TOO_FEW_SPAWNS;
+    return false;
+  }
+
+  for (unsigned int i = 0; i < map->spawnCount; i++) {
+    Vector2 position = map->spawns[i].position;
+    if (position.x < boundary->x || position.x > boundary->x + boundary->width
+        || position.y < boundary->y || position.y > boundary->y + boundary->height) {
+      error->message = MAP_SPAWN_OUT_OF_BOUNDS;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void encodeMapObstacle(const MapObstacle* obstacle, uint32_t* kindOut, float fieldsOut[MAP_BINARY_OBSTACLE_FIELD_COUNT]) {
+  bool isCircle = obstacle->collider.kind == PHYSICS_COLLIDER_CIRCLE;
+  *kindOut = isCircle ? MAP_BINARY_OBSTACLE_KIND_CIRCLE : MAP_BINARY_OBSTACLE_KIND_RECTANGLE;
+  fieldsOut[0] = obstacle->position.x;
+  fieldsOut[1] = obstacle->position.y;
+  fieldsOut[2] = obstacle->rotation;
+  fieldsOut[3] = isCircle ? obstacle->collider.radius : obstacle->collider.widthHeight.x;
+  fieldsOut[4] = isCircle ? 0 : obstacle->collider.widthHeight.y;
+}
+
+uint64_t hashMapGeometry(const ArenaMap* map) {
+  uint64_t hash = MAP_FNV_OFFSET_BASIS;
+  hash = hashMapF32(hash, map->boundary.x);
+  hash = hashMapF32(hash, map->boundary.y);
+  hash = hashMapF32(hash, map->boundary.width);
+  hash = hashMapF32(hash, map->boundary.height);
+  hash = hashMapU32(hash, map->obstacleCount);
+  for (unsigned int i = 0; i < map->obstacleCount; i++) {
+    uint32_t kind;
+    float fields[MAP_BINARY_OBSTACLE_FIELD_COUNT];
+    encodeMapObstacle(&map->obstacles[i], &kind, fields);
+    hash = hashMapU32(hash, kind);
+    for (unsigned int j = 0; j < MAP_BINARY_OBSTACLE_FIELD_COUNT; j++) {
+      hash = hashMapF32(hash, fields[j]);
+    }
+  }
+  return hash;
+}
+
+uint64_t hashMapU32(uint64_t hash, uint32_t value) {
+  for (unsigned int i = 0; i < sizeof(value); i++) {
+    hash ^= (value >> (i * 8)) & 0xFF;
+    hash *= MAP_FNV_PRIME;
+  }
+  return hash;
+}
+
+uint64_t hashMapF32(uint64_t hash, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return hashMapU32(hash, bits);
+}
+
+size_t tokenizeMapLine(char* line, char** tokensOut) {
+  size_t tokenCount = 0;
+  char* c = line;
+  while (*c != '\0' && *c != '#') {
+    if (*c == ' ' || *c == '\t' || *c == '\r') {
+      *c++ = '\0';
+      continue;
+    }
+
+    if (tokenCount >= MAP_MAX_LINE_TOKENS) {
+      break; // Too many tokens for any kind of line, which is reported as an invalid line
+    }
+    tokensOut[tokenCount++] = c;
+    while (*c != '\0' && *c != '#' && *c != ' ' && *c != '\t' && *c != '\r') { c++; }
+  }
+  *c = '\0';
+  return tokenCount;
+}
+
+bool tryParseMapNumbers(char** tokens, size_t tokenCount, float* valuesOut) {
+  for (size_t i = 0; i < tokenCount; i++) {
+    char* end;
+    valuesOut[i] = strtof(tokens[i], &end);
+    if (*end != '\0' || !isfinite(valuesOut[i])) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -3,8 +3,80 @@
 #include <math.h>
 #include <raymath.h>
 #include <assert.h>
+#include "arena/fixed.h"
+#include "arena/trig.h"
 
 #define MAX_RESOLVER_ITERATIONS 32
+// The penetration depth up to which colliding bodies are considered to be resting against one another
+// rather than needing to be pushed apart, so that steady contacts don't keep the resolver iterating.
+#define RESOLVER_SLOP 0.001f
+
+// The maximum number of times a swept body can stop at a surface and slide along it in a single step.
+#define MAX_SWEEP_ITERATIONS 4
+// The distance kept between a swept body and the surface it stopped at, to avoid starting the next sweep in contact.
+#define SWEEP_SKIN_DISTANCE 0.001f
+
+// The amount subtracted from distances read from a distance field to cover the rounding error of the exact tests.
+#define DISTANCE_FIELD_MARGIN 0.01f
+
+
+#pragma region Integration helper functions
+
+// Advances a body's position and rotation by its velocities over the given time step.
+void integrateBody(const PhysicsWorld* world, PhysicsBody* body, double deltaTimeSeconds);
+
+// Offsets a body's position by the given vector.
+void translateBody(const PhysicsWorld* world, PhysicsBody* body, Vector2 offset);
+
+#pragma endregion
+
+
+#pragma region Collision resolution helper functions
+
+// Pushes a pair of colliding bodies apart along the given penetration of body A into body B, splitting the push
+// between the bodies that can be pushed, then pushes them away from the world boundary if either is now colliding
+// with it. Returns true if either body's position changed, or false if the push was too small to change the positions.
+bool resolveCollisionPair(const PhysicsWorld* world, PhysicsBody* bodyA, PhysicsBody* bodyB, Vector2 penetration, bool canPushA, bool canPushB);
+
+// Returns whether a penetration is deeper than RESOLVER_SLOP. The resolver's decisions are made in fixed-point
+// arithmetic in worlds that use it, so that they come out the same on every target.
+bool isPenetrationBeyondSlop(const PhysicsWorld* world, Vector2 penetration);
+
+// Computes the direction of a penetration. Returns false if the penetration has no length.
+bool tryGetPenetrationNormal(const PhysicsWorld* world, Vector2 penetration, Vector2* normalOut);
+
+// Returns -1, 0 or 1 for a negative, zero or positive dot product of the two vectors.
+int getDotProductSign(const PhysicsWorld* world, Vector2 a, Vector2 b);
+
+#pragma endregion
+
+
+#pragma region Continuous collision helper functions
+
+// Moves a dynamic circular body by the given displacement, stopping at the world boundary and static rectangular
+// bodies and sliding along them with the remaining displacement.
+void sweepCircleBody(const PhysicsWorld* world, PhysicsBody* body, Vector2 displacement);
+
+// Checks whether a circle moving by the given displacement touches the world boundary or a static rectangular body.
+// If it does, returns true and outputs the earliest fraction of the displacement at which it touches and the surface
+// normal there. Otherwise, returns false. Surfaces the circle already overlaps are left to the collision resolver.
+bool sweepCircle(const PhysicsWorld* world, Vector2 position, float radius, Vector2 displacement, float* fractionOut, Vector2* normalOut);
+
+bool sweepCircleBoundary(Vector2 position, float radius, Vector2 displacement, const PhysicsWorld* world, float* fractionOut, Vector2* normalOut);
+bool sweepCircleRectangleCollider(Vector2 position, float radius, Vector2 displacement, Vector2 positionB, float rotationB, Vector2 widthHeightB, float* fractionOut, Vector2* normalOut);
+
+#pragma endregion
+
+
+#pragma region Distance field helper functions
+
+// Computes the signed distance from the given position to the nearest static surface of the world.
+float computeStaticSignedDistance(const PhysicsWorld* world, Vector2 position);
+
+// Returns whether the world's distance field shows that the body can't be touching any static geometry.
+bool isBodyClearOfStaticGeometry(const PhysicsWorld* world, const PhysicsBody* body);
+
+#pragma endregion
 
 
 #pragma region Collision helper functions
@@ -17,7 +89,7 @@ bool checkCollisionBodyBoundary(const PhysicsBody* body, const PhysicsWorld* wor
 // Checks whether two bodies are colliding with one another.
 // If they are, returns true and outputs a vector indiciating how far body A is penetrating into body B.
 // Otherwise, returns false.
-bool checkCollisionBodies(const PhysicsBody* bodyA, const PhysicsBody* bodyB, Vector2* penetrationOut);
+bool checkCollisionBodies(const PhysicsWorld* world, const PhysicsBody* bodyA, const PhysicsBody* bodyB, Vector2* penetrationOut);
 
 bool checkCollisionCircleColliderBoundary(Vector2 position, float radius, const PhysicsWorld* world, Vector2* penetrationOut);
 bool checkCollisionRectangleColliderBoundary(Vector2 position, float rotation, Vector2 widthHeight, const PhysicsWorld* world, Vector2* penetrationOut);
@@ -25,72 +97,557 @@ bool checkCollisionCircleColliders(Vector2 positionA, float radiusA, Vector2 pos
 bool checkCollisionRectangleColliders(Vector2 positionA, float rotationA, Vector2 widthHeightA, Vector2 positionB, float rotationB, Vector2 widthHeightB, Vector2* penetrationOut);
 bool checkCollisionCircleColliderRectangleCollider(Vector2 positionA, float radiusA, Vector2 positionB, float rotationB, Vector2 widthHeightB, Vector2* penetrationOut);
 
+// Rotates a vector by the angle with the given cosine and sine.
+Vector2 rotateCosSin(Vector2 vector, float cosAngle, float sinAngle);
+
+#pragma endregion
+
+
+#pragma region Fixed-point collision helper functions
+
+// Equivalents of the collision helper functions above for worlds that use fixed-point arithmetic.
+bool checkCollisionCircleColliderBoundaryFixed(FixedVector2 position, Fixed radius, const PhysicsWorld* world, FixedVector2* penetrationOut);
+bool checkCollisionCircleCollidersFixed(FixedVector2 positionA, Fixed radiusA, FixedVector2 positionB, Fixed radiusB, FixedVector2* penetrationOut);
+bool checkCollisionCircleColliderRectangleColliderFixed(FixedVector2 positionA, Fixed radiusA, FixedVector2 positionB, Fixed rotationB, FixedVector2 widthHeightB, FixedVector2* penetrationOut);
+
 #pragma endregion
 
 
 void StepPhysicsWorld(PhysicsWorld* world, double deltaTimeSeconds) {
-  // Update positions and rotations based on current velocities
+  // Track which bodies may have moved so that the world's version can be updated
+  bool bodyMoved[MAX_PHYSICS_BODIES] = { 0 };
+
+  // Update positions and rotations based on current velocities, waking any sleeping bodies that were given a velocity
   for (unsigned int i = 0; i < world->bodyCount; i++) {
     PhysicsBody* body = &world->bodies[i];
-    body->position.x += body->linearVelocity.x * deltaTimeSeconds;
-    body->position.y += body->linearVelocity.y * deltaTimeSeconds;
-    body->rotation += body->angularVelocity * deltaTimeSeconds;
-    body->rotation -= floor(body->rotation / (M_PI * 2)) * (M_PI * 2);
+    bodyMoved[i] = body->linearVelocity.x != 0 || body->linearVelocity.y != 0 || body->angularVelocity != 0;
+    if (!bodyMoved[i]) { continue; }
+
+    body->isAsleep = false;
+    integrateBody(world, body, deltaTimeSeconds);
   }
 
   // Resolve collisions between bodies and the world boundary
   for (unsigned int i = 0; i < world->bodyCount; i++) {
     PhysicsBody* body = &world->bodies[i];
+    if (body->isAsleep) {
+      continue; // Sleeping bodies were not touching the boundary when they fell asleep and haven't moved since.
+    }
+    if (!body->isStatic && isBodyClearOfStaticGeometry(world, body)) {
+      continue;
+    }
+
     Vector2 penetration;
     if (checkCollisionBodyBoundary(body, world, &penetration)) {
-      body->position = Vector2Subtract(body->position, penetration);
+      translateBody(world, body, Vector2Negate(penetration));
+      bodyMoved[i] = true;
+    }
+  }
+
+  // Order the body pairs so that pairs that were in contact during the last step are resolved first
+  unsigned int pairCount = 0;
+  unsigned char pairs[MAX_PHYSICS_CONTACTS][2];
+  for (int wasActive = 1; wasActive >= 0; wasActive--) {
+    for (unsigned int i = 0; i + 1 < world->bodyCount; i++) {
+      for (unsigned int j = i + 1; j < world->bodyCount; j++) {
+        if (world->contacts[GetPhysicsContactIndex(i, j)].isActive == (bool)wasActive) {
+          pairs[pairCount][0] = i;
+          pairs[pairCount][1] = j;
+          pairCount++;
+        }
+      }
     }
   }
 
-  // Iteratively resolve collisions between physics bodies
+  // Find the direction in which each body was pressed against a static body during the last step. Pushing it further
+  // that way would only move it back into the static body, so its collisions with dynamic bodies push the other body.
+  bool isBlocked[MAX_PHYSICS_BODIES] = { 0 };
+  Vector2 blockedNormals[MAX_PHYSICS_BODIES];
+  for (unsigned int p = 0; p < pairCount && world->contacts[GetPhysicsContactIndex(pairs[p][0], pairs[p][1])].isActive; p++) {
+    unsigned int i = pairs[p][0];
+    unsigned int j = pairs[p][1];
+    const PhysicsContact* contact = &world->contacts[GetPhysicsContactIndex(i, j)];
+    if (world->bodies[j].isStatic && !world->bodies[i].isStatic) {
+      isBlocked[i] = true;
+      blockedNormals[i] = contact->normal;
+    } else if (world->bodies[i].isStatic && !world->bodies[j].isStatic) {
+      isBlocked[j] = true;
+      blockedNormals[j] = Vector2Negate(contact->normal);
+    }
+  }
+  for (unsigned int i = 0; i < MAX_PHYSICS_CONTACTS; i++) {
+    world->contacts[i].isActive = false;
+  }
+
+  // Iteratively resolve collisions between physics bodies. After the first iteration, only pairs containing a body
+  // that was pushed in the previous iteration can have changed, so the rest are skipped.
+  bool bodyPushed[MAX_PHYSICS_BODIES];
+  for (unsigned int i = 0; i < world->bodyCount; i++) {
+    bodyPushed[i] = true;
+  }
   bool foundCollision = true;
+  world->resolverIterations = 0;
   for (unsigned int k = 0; foundCollision && k < MAX_RESOLVER_ITERATIONS; k++) {
+    world->resolverIterations++;
     foundCollision = false;
-    for (unsigned int i = 0; i < world->bodyCount - 1; i++) {
-      for (unsigned int j = i + 1; j < world->bodyCount; j++) {
-        PhysicsBody* bodyA = &world->bodies[i];
-        PhysicsBody* bodyB = &world->bodies[j];
-        if (bodyA->isStatic && bodyB->isStatic) {
-          continue; // Two static bodies don't affect each other.
+
+    bool bodyPushedThisIteration[MAX_PHYSICS_BODIES] = { 0 };
+    for (unsigned int p = 0; p < pairCount; p++) {
+      unsigned int i = pairs[p][0];
+      unsigned int j = pairs[p][1];
+      PhysicsBody* bodyA = &world->bodies[i];
+      PhysicsBody* bodyB = &world->bodies[j];
+      if ((bodyA->isStatic || bodyA->isAsleep) && (bodyB->isStatic || bodyB->isAsleep)) {
+        continue; // Static and sleeping bodies can't start colliding with one another.
+      }
+      if (!bodyPushed[i] && !bodyPushed[j] && !bodyPushedThisIteration[i] && !bodyPushedThisIteration[j]) {
+        continue; // Neither body has moved since this pair was last checked.
+      }
+      if ((bodyA->isStatic && isBodyClearOfStaticGeometry(world, bodyB)) || (bodyB->isStatic && isBodyClearOfStaticGeometry(world, bodyA))) {
+        continue;
+      }
+
+      Vector2 penetration;
+      if (checkCollisionBodies(world, bodyA, bodyB, &penetration)) {
+        bodyA->isAsleep = false;
+        bodyB->isAsleep = false;
+
+        PhysicsContact* contact = &world->contacts[GetPhysicsContactIndex(i, j)];
+        contact->isActive = true;
+        tryGetPenetrationNormal(world, penetration, &contact->normal);
+
+        // Keep track of which way each body is pressed against static bodies
+        if (bodyB->isStatic && !bodyA->isStatic) {
+          isBlocked[i] = true;
+          blockedNormals[i] = contact->normal;
+        } else if (bodyA->isStatic && !bodyB->isStatic) {
+          isBlocked[j] = true;
+          blockedNormals[j] = Vector2Negate(contact->normal);
         }
 
-        Vector2 penetration;
-        if (checkCollisionBodies(bodyA, bodyB, &penetration)) {
-          foundCollision = true;
+        // A body blocked by a static body in the direction it would be pushed is left in place if the other body can move
+        bool canPushA = !bodyA->isStatic;
+        bool canPushB = !bodyB->isStatic;
+        if (canPushA && canPushB) {
+          bool isABlocked = isBlocked[i] && getDotProductSign(world, penetration, blockedNormals[i]) < 0;
+          bool isBBlocked = isBlocked[j] && getDotProductSign(world, penetration, blockedNormals[j]) > 0;
+          canPushA = !isABlocked || isBBlocked;
+          canPushB = !isBBlocked || isABlocked;
+        }
 
-          if (!bodyA->isStatic && !bodyB->isStatic) {
-            Vector2 halfPenetration = Vector2Scale(penetration, 0.5);
-            bodyA->position = Vector2Subtract(bodyA->position, halfPenetration);
-            bodyB->position = Vector2Add(bodyB->position, halfPenetration);
-          } else if (!bodyA->isStatic) {
-            bodyA->position = Vector2Subtract(bodyA->position, penetration);
-          } else {
-            bodyB->position = Vector2Add(bodyB->position, penetration);
-          }
-
-          // Move both bodies away from boundary if either is now colliding
-          if (!bodyA->isStatic && checkCollisionBodyBoundary(bodyA, world, &penetration)) {
-            bodyA->position = Vector2Subtract(bodyA->position, penetration);
-            if (!bodyB->isStatic) { bodyB->position = Vector2Subtract(bodyB->position, penetration); }
-          }
-
-          if (!bodyB->isStatic && checkCollisionBodyBoundary(bodyB, world, &penetration)) {
-            if (!bodyA->isStatic) { bodyA->position = Vector2Subtract(bodyA->position, penetration); }
-            bodyB->position = Vector2Subtract(bodyB->position, penetration);
-          }
+        // Pushes too small to change the positions would never converge, so they don't count as progress
+        if (isPenetrationBeyondSlop(world, penetration) && resolveCollisionPair(world, bodyA, bodyB, penetration, canPushA, canPushB)) {
+          foundCollision = true;
+          bodyPushedThisIteration[i] = !bodyA->isStatic;
+          bodyPushedThisIteration[j] = !bodyB->isStatic;
+          bodyMoved[i] = bodyMoved[i] || !bodyA->isStatic;
+          bodyMoved[j] = bodyMoved[j] || !bodyB->isStatic;
         }
       }
     }
+
+    for (unsigned int i = 0; i < world->bodyCount; i++) {
+      bodyPushed[i] = bodyPushedThisIteration[i];
+    }
+  }
+
+  // Put dynamic bodies to sleep if they were neither moving nor pushed out of a collision during this step
+  for (unsigned int i = 0; i < world->bodyCount; i++) {
+    PhysicsBody* body = &world->bodies[i];
+    body->isAsleep = !body->isStatic && !bodyMoved[i];
+  }
+
+  // Update the version of the world and of each body that moved
+  bool anyBodyMoved = false;
+  for (unsigned int i = 0; i < world->bodyCount; i++) {
+    anyBodyMoved = anyBodyMoved || bodyMoved[i];
+  }
+  if (anyBodyMoved) {
+    world->version++;
+    for (unsigned int i = 0; i < world->bodyCount; i++) {
+      if (bodyMoved[i]) { world->bodyVersions[i] = world->version; }
+    }
+  }
+}
+
+unsigned int GetPhysicsContactIndex(unsigned int bodyIndexA, unsigned int bodyIndexB) {
+  assert(bodyIndexA < bodyIndexB && bodyIndexB < MAX_PHYSICS_BODIES);
+  return bodyIndexA * (2 * MAX_PHYSICS_BODIES - bodyIndexA - 1) / 2 + (bodyIndexB - bodyIndexA - 1);
+}
+
+void BakePhysicsDistanceField(PhysicsWorld* world) {
+  PhysicsDistanceField* field = &world->staticDistanceField;
+  field->isBaked = false;
+  if (world->useFixedPoint || world->boundary.width <= 0 || world->boundary.height <= 0) {
+    return;
   }
+
+  // Cover the boundary with square cells, using as many as allowed along its longer side
+  field->origin = (Vector2){ world->boundary.x, world->boundary.y };
+  field->cellSize = fmaxf(world->boundary.width, world->boundary.height) / PHYSICS_DISTANCE_FIELD_MAX_CELLS;
+  field->columnCount = (unsigned int)ceilf(world->boundary.width / field->cellSize) + 1;
+  field->rowCount = (unsigned int)ceilf(world->boundary.height / field->cellSize) + 1;
+  if (field->columnCount > PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1) { field->columnCount = PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1; }
+  if (field->rowCount > PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1) { field->rowCount = PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1; }
+
+  for (unsigned int row = 0; row < field->rowCount; row++) {
+    for (unsigned int column = 0; column < field->columnCount; column++) {
+      Vector2 position = { field->origin.x + column * field->cellSize, field->origin.y + row * field->cellSize };
+      field->distances[row * field->columnCount + column] = computeStaticSignedDistance(world, position);
+    }
+  }
+  field->isBaked = true;
+}
+
+float GetPhysicsStaticDistanceBound(const PhysicsWorld* world, Vector2 position) {
+  const PhysicsDistanceField* field = &world->staticDistanceField;
+  if (!field->isBaked || world->useFixedPoint) {
+    return 0;
+  }
+
+  // The distance to the nearest surface changes by at most the distance moved, so the nearest node bounds it
+  float column = roundf((position.x - field->origin.x) / field->cellSize);
+  float row = roundf((position.y - field->origin.y) / field->cellSize);
+  column = fminf(fmaxf(column, 0), field->columnCount - 1);
+  row = fminf(fmaxf(row, 0), field->rowCount - 1);
+  if (isnan(column) || isnan(row)) {
+    return 0;
+  }
+
+  Vector2 nodePosition = { field->origin.x + column * field->cellSize, field->origin.y + row * field->cellSize };
+  float nodeDistance = field->distances[(unsigned int)row * field->columnCount + (unsigned int)column];
+  return nodeDistance - Vector2Distance(position, nodePosition) - DISTANCE_FIELD_MARGIN;
+}
+
+float GetPhysicsBodyBoundingRadius(const PhysicsBody* body) {
+  switch (body->collider.kind) {
+    case PHYSICS_COLLIDER_CIRCLE:
+      return body->collider.radius;
+    case PHYSICS_COLLIDER_RECTANGLE:
+      return Vector2Length(body->collider.widthHeight) / 2;
+  }
+
+  assert(false);
+  return INFINITY;
+}
+
+void MarkPhysicsBodyChanged(PhysicsWorld* world, unsigned int bodyIndex) {
+  if (world->bodies[bodyIndex].isStatic) {
+    world->staticDistanceField.isBaked = false;
+  }
+  world->bodies[bodyIndex].isAsleep = false;
+  world->version++;
+  world->bodyVersions[bodyIndex] = world->version;
+}
+
+
+void integrateBody(const PhysicsWorld* world, PhysicsBody* body, double deltaTimeSeconds) {
+  if (world->useFixedPoint) {
+    Fixed deltaTime = (Fixed)(deltaTimeSeconds * FIXED_ONE);
+    FixedVector2 position = FixedVector2FromFloat(body->position.x, body->position.y);
+    FixedVector2 linearVelocity = FixedVector2FromFloat(body->linearVelocity.x, body->linearVelocity.y);
+    position = FixedVector2Add(position, FixedVector2Scale(linearVelocity, deltaTime));
+    Fixed rotation = FixedFromFloat(body->rotation) + FixedMul(FixedFromFloat(body->angularVelocity), deltaTime);
+
+    body->position = (Vector2){ FixedToFloat(position.x), FixedToFloat(position.y) };
+    body->rotation = FixedToFloat(FixedWrapAngle(rotation));
+    return;
+  }
+
+  if (world->useContinuousCollision && !body->isStatic && body->collider.kind == PHYSICS_COLLIDER_CIRCLE) {
+    sweepCircleBody(world, body, Vector2Scale(body->linearVelocity, deltaTimeSeconds));
+  } else {
+    body->position.x += body->linearVelocity.x * deltaTimeSeconds;
+    body->position.y += body->linearVelocity.y * deltaTimeSeconds;
+  }
+  body->rotation += body->angularVelocity * deltaTimeSeconds;
+  body->rotation -= floor(body->rotation / (M_PI * 2)) * (M_PI * 2);
+}
+
+void translateBody(const PhysicsWorld* world, PhysicsBody* body, Vector2 offset) {
+  if (world->useFixedPoint) {
+    body->position.x = FixedToFloat(FixedFromFloat(body->position.x) + FixedFromFloat(offset.x));
+    body->position.y = FixedToFloat(FixedFromFloat(body->position.y) + FixedFromFloat(offset.y));
+    return;
+  }
+
+  body->position = Vector2Add(body->position, offset);
+}
+
+
+bool resolveCollisionPair(const PhysicsWorld* world, PhysicsBody* bodyA, PhysicsBody* bodyB, Vector2 penetration, bool canPushA, bool canPushB) {
+  Vector2 initialPositionA = bodyA->position;
+  Vector2 initialPositionB = bodyB->position;
+
+  if (canPushA && canPushB) {
+    Vector2 halfPenetration = Vector2Scale(penetration, 0.5);
+    translateBody(world, bodyA, Vector2Negate(halfPenetration));
+    translateBody(world, bodyB, halfPenetration);
+  } else if (canPushA) {
+    translateBody(world, bodyA, Vector2Negate(penetration));
+  } else {
+    translateBody(world, bodyB, penetration);
+  }
+
+  // Move both bodies away from boundary if either is now colliding
+  if (!bodyA->isStatic && checkCollisionBodyBoundary(bodyA, world, &penetration)) {
+    translateBody(world, bodyA, Vector2Negate(penetration));
+    if (!bodyB->isStatic) { translateBody(world, bodyB, Vector2Negate(penetration)); }
+  }
+
+  if (!bodyB->isStatic && checkCollisionBodyBoundary(bodyB, world, &penetration)) {
+    if (!bodyA->isStatic) { translateBody(world, bodyA, Vector2Negate(penetration)); }
+    translateBody(world, bodyB, Vector2Negate(penetration));
+  }
+
+  return bodyA->position.x != initialPositionA.x || bodyA->position.y != initialPositionA.y
+    || bodyB->position.x != initialPositionB.x || bodyB->position.y != initialPositionB.y;
+}
+
+bool isPenetrationBeyondSlop(const PhysicsWorld* world, Vector2 penetration) {
+  if (world->useFixedPoint) {
+    FixedVector2 fixedPenetration = FixedVector2FromFloat(penetration.x, penetration.y);
+    return FixedVector2LengthSqrWide(fixedPenetration) > FixedSquareWide(FixedFromFloat(RESOLVER_SLOP));
+  }
+
+  return Vector2Length(penetration) > RESOLVER_SLOP;
+}
+
+bool tryGetPenetrationNormal(const PhysicsWorld* world, Vector2 penetration, Vector2* normalOut) {
+  if (world->useFixedPoint) {
+    FixedVector2 fixedPenetration = FixedVector2FromFloat(penetration.x, penetration.y);
+    Fixed depth = FixedSqrtWide(FixedVector2LengthSqrWide(fixedPenetration));
+    if (depth <= 0) {
+      return false;
+    }
+    *normalOut = (Vector2){ FixedToFloat(FixedDiv(fixedPenetration.x, depth)), FixedToFloat(FixedDiv(fixedPenetration.y, depth)) };
+    return true;
+  }
+
+  float depth = Vector2Length(penetration);
+  if (depth <= 0) {
+    return false;
+  }
+  *normalOut = Vector2Scale(penetration, 1 / depth);
+  return true;
+}
+
+int getDotProductSign(const PhysicsWorld* world, Vector2 a, Vector2 b) {
+  if (world->useFixedPoint) {
+    // Keep the full product, since shifting it back to 16 fractional bits would round tiny products to zero or -1
+    FixedVector2 fixedA = FixedVector2FromFloat(a.x, a.y);
+    FixedVector2 fixedB = FixedVector2FromFloat(b.x, b.y);
+    int64_t dot = (int64_t)fixedA.x * fixedB.x + (int64_t)fixedA.y * fixedB.y;
+    return (dot > 0) - (dot < 0);
+  }
+
+  float dot = Vector2DotProduct(a, b);
+  return (dot > 0) - (dot < 0);
+}
+
+void sweepCircleBody(const PhysicsWorld* world, PhysicsBody* body, Vector2 displacement) {
+  float radius = body->collider.radius;
+  for (unsigned int k = 0; k < MAX_SWEEP_ITERATIONS; k++) {
+    float fraction;
+    Vector2 normal;
+    if (!sweepCircle(world, body->position, radius, displacement, &fraction, &normal)) {
+      break;
+    }
+
+    // Stop just short of the surface, then slide along it with the rest of the displacement
+    Vector2 travelled = Vector2Scale(displacement, fraction);
+    body->position = Vector2Add(body->position, Vector2Add(travelled, Vector2Scale(normal, SWEEP_SKIN_DISTANCE)));
+    Vector2 remaining = Vector2Subtract(displacement, travelled);
+    displacement = Vector2Subtract(remaining, Vector2Scale(normal, Vector2DotProduct(remaining, normal)));
+  }
+
+  // Any displacement left after the last sweep is applied as-is and left to the collision resolver
+  body->position = Vector2Add(body->position, displacement);
+}
+
+bool sweepCircle(const PhysicsWorld* world, Vector2 position, float radius, Vector2 displacement, float* fractionOut, Vector2* normalOut) {
+  if (GetPhysicsStaticDistanceBound(world, position) > radius + Vector2Length(displacement)) {
+    return false; // No static surface is within reach of the swept circle.
+  }
+
+  bool foundHit = sweepCircleBoundary(position, radius, displacement, world, fractionOut, normalOut);
+
+  for (unsigned int i = 0; i < world->bodyCount; i++) {
+    const PhysicsBody* other = &world->bodies[i];
+    if (!other->isStatic || other->collider.kind != PHYSICS_COLLIDER_RECTANGLE) {
+      continue;
+    }
+
+    float fraction;
+    Vector2 normal;
+    if (sweepCircleRectangleCollider(position, radius, displacement, other->position, other->rotation, other->collider.widthHeight, &fraction, &normal)
+        && (!foundHit || fraction < *fractionOut)) {
+      foundHit = true;
+      *fractionOut = fraction;
+      *normalOut = normal;
+    }
+  }
+
+  return foundHit;
+}
+
+bool sweepCircleBoundary(Vector2 position, float radius, Vector2 displacement, const PhysicsWorld* world, float* fractionOut, Vector2* normalOut) {
+  float left = world->boundary.x + radius;
+  float top = world->boundary.y + radius;
+  float right = world->boundary.x + world->boundary.width - radius;
+  float bottom = world->boundary.y + world->boundary.height - radius;
+  if (position.x < left || position.x > right || position.y < top || position.y > bottom) {
+    return false; // Already touching the boundary.
+  }
+
+  // Find the earliest point at which the circle's center leaves the boundary shrunk by the radius
+  bool foundHit = false;
+  float fraction = 1;
+  Vector2 normal = { 0 };
+  if (position.x + displacement.x < left && (left - position.x) / displacement.x < fraction) {
+    fraction = (left - position.x) / displacement.x;
+    normal = (Vector2){ 1, 0 };
+    foundHit = true;
+  } else if (position.x + displacement.x > right && (right - position.x) / displacement.x < fraction) {
+    fraction = (right - position.x) / displacement.x;
+    normal = (Vector2){ -1, 0 };
+    foundHit = true;
+  }
+  if (position.y + displacement.y < top && (top - position.y) / displacement.y < fraction) {
+    fraction = (top - position.y) / displacement.y;
+    normal = (Vector2){ 0, 1 };
+    foundHit = true;
+  } else if (position.y + displacement.y > bottom && (bottom - position.y) / displacement.y < fraction) {
+    fraction = (bottom - position.y) / displacement.y;
+    normal = (Vector2){ 0, -1 };
+    foundHit = true;
+  }
+
+  if (foundHit) {
+    *fractionOut = fraction;
+    *normalOut = normal;
+  }
+  return foundHit;
+}
+
+bool sweepCircleRectangleCollider(Vector2 position, float radius, Vector2 displacement, Vector2 positionB, float rotationB, Vector2 widthHeightB, float* fractionOut, Vector2* normalOut) {
+  // Work in the rectangle's frame, where the circle's center must be kept outside the rectangle rounded by the radius
+  float sinRotation, cosRotation;
+  FastSinCos(rotationB, &sinRotation, &cosRotation);
+  Vector2 start = rotateCosSin(Vector2Subtract(position, positionB), cosRotation, -sinRotation);
+  Vector2 delta = rotateCosSin(displacement, cosRotation, -sinRotation);
+  float halfWidth = widthHeightB.x / 2;
+  float halfHeight = widthHeightB.y / 2;
+
+  // Intersect the path with the rectangle expanded by the radius on every side
+  float entryFraction = -INFINITY, exitFraction = INFINITY;
+  Vector2 entryNormal = { 0 };
+  float starts[2] = { start.x, start.y };
+  float deltas[2] = { delta.x, delta.y };
+  float halfExtents[2] = { halfWidth + radius, halfHeight + radius };
+  for (int axis = 0; axis < 2; axis++) {
+    if (deltas[axis] == 0) {
+      if (fabsf(starts[axis]) >= halfExtents[axis]) { return false; }
+      continue;
+    }
+
+    float nearFraction = (-copysignf(halfExtents[axis], deltas[axis]) - starts[axis]) / deltas[axis];
+    float farFraction = (copysignf(halfExtents[axis], deltas[axis]) - starts[axis]) / deltas[axis];
+    if (nearFraction > entryFraction) {
+      entryFraction = nearFraction;
+      entryNormal = axis == 0 ? (Vector2){ -copysignf(1, deltas[axis]), 0 } : (Vector2){ 0, -copysignf(1, deltas[axis]) };
+    }
+    exitFraction = fminf(exitFraction, farFraction);
+  }
+  if (entryFraction > exitFraction || exitFraction < 0 || entryFraction > 1) {
+    return false; // Missed, or not reached within this step.
+  }
+  bool startsInExpandedRectangle = entryFraction < 0;
+  entryFraction = fmaxf(entryFraction, 0);
+
+  // Entering through a corner of the expanded rectangle only touches if the path hits the rounded corner
+  Vector2 entryPoint = Vector2Add(start, Vector2Scale(delta, entryFraction));
+  if (fabsf(entryPoint.x) > halfWidth && fabsf(entryPoint.y) > halfHeight) {
+    Vector2 corner = { copysignf(halfWidth, entryPoint.x), copysignf(halfHeight, entryPoint.y) };
+    Vector2 cornerToStart = Vector2Subtract(start, corner);
+    float a = Vector2DotProduct(delta, delta);
+    float b = Vector2DotProduct(cornerToStart, delta);
+    float c = Vector2DotProduct(cornerToStart, cornerToStart) - radius * radius;
+    float discriminant = b * b - a * c;
+    if (c < 0 || b >= 0 || discriminant < 0) { return false; } // Already overlapping, moving away, or missed.
+
+    entryFraction = (-b - sqrtf(discriminant)) / a;
+    if (entryFraction < 0 || entryFraction > 1) { return false; }
+    entryNormal = Vector2Scale(Vector2Subtract(Vector2Add(start, Vector2Scale(delta, entryFraction)), corner), 1 / radius);
+  } else if (startsInExpandedRectangle) {
+    return false; // Already overlapping.
+  }
+
+  *fractionOut = entryFraction;
+  *normalOut = rotateCosSin(entryNormal, cosRotation, sinRotation);
+  return true;
+}
+
+
+float computeStaticSignedDistance(const PhysicsWorld* world, Vector2 position) {
+  // Distances are computed in double precision so that the only rounding left is in storing the result
+  double x = position.x;
+  double y = position.y;
+  double distance = fmin(
+    fmin(x - world->boundary.x, world->boundary.x + world->boundary.width - x),
+    fmin(y - world->boundary.y, world->boundary.y + world->boundary.height - y));
+
+  for (unsigned int i = 0; i < world->bodyCount; i++) {
+    const PhysicsBody* body = &world->bodies[i];
+    if (!body->isStatic) {
+      continue;
+    }
+
+    double relativeX = x - body->position.x;
+    double relativeY = y - body->position.y;
+    double bodyDistance;
+    switch (body->collider.kind) {
+      case PHYSICS_COLLIDER_CIRCLE:
+        bodyDistance = sqrt(relativeX * relativeX + relativeY * relativeY) - body->collider.radius;
+        break;
+      case PHYSICS_COLLIDER_RECTANGLE: {
+        // Measure the distance to the rectangle in its own frame, negative inside by the distance to the nearest edge
+        double cosRotation = cos(body->rotation);
+        double sinRotation = sin(body->rotation);
+        double localX = fabs(relativeX * cosRotation + relativeY * sinRotation) - body->collider.widthHeight.x / 2.0;
+        double localY = fabs(-relativeX * sinRotation + relativeY * cosRotation) - body->collider.widthHeight.y / 2.0;
+        double outsideX = fmax(localX, 0);
+        double outsideY = fmax(localY, 0);
+        bodyDistance = sqrt(outsideX * outsideX + outsideY * outsideY) + fmin(fmax(localX, localY), 0);
+        break;
+      }
+      default:
+        assert(false);
+        continue;
+    }
+    distance = fmin(distance, bodyDistance);
+  }
+
+  return (float)distance;
+}
+
+bool isBodyClearOfStaticGeometry(const PhysicsWorld* world, const PhysicsBody* body) {
+  return GetPhysicsStaticDistanceBound(world, body->position) > GetPhysicsBodyBoundingRadius(body);
 }
 
 
 bool checkCollisionBodyBoundary(const PhysicsBody* body, const PhysicsWorld* world, Vector2* penetrationOut) {
+  if (world->useFixedPoint) {
+    FixedVector2 penetration = { 0 };
+    bool colliding = false;
+    if (body->collider.kind == PHYSICS_COLLIDER_CIRCLE) {
+      colliding = checkCollisionCircleColliderBoundaryFixed(
+        FixedVector2FromFloat(body->position.x, body->position.y), FixedFromFloat(body->collider.radius), world, &penetration);
+    }
+    *penetrationOut = (Vector2){ FixedToFloat(penetration.x), FixedToFloat(penetration.y) };
+    return colliding;
+  }
+
   switch (body->collider.kind) {
     case PHYSICS_COLLIDER_CIRCLE:
       return checkCollisionCircleColliderBoundary(body->position, body->collider.radius, world, penetrationOut);
@@ -102,7 +659,29 @@ bool checkCollisionBodyBoundary(const PhysicsBody* body, const PhysicsWorld* wor
   return false;
 }
 
-bool checkCollisionBodies(const PhysicsBody* bodyA, const PhysicsBody* bodyB, Vector2* penetrationOut) {
+bool checkCollisionBodies(const PhysicsWorld* world, const PhysicsBody* bodyA, const PhysicsBody* bodyB, Vector2* penetrationOut) {
+  if (world->useFixedPoint) {
+    FixedVector2 positionA = FixedVector2FromFloat(bodyA->position.x, bodyA->position.y);
+    FixedVector2 positionB = FixedVector2FromFloat(bodyB->position.x, bodyB->position.y);
+    FixedVector2 penetration = { 0 };
+    bool colliding = false;
+    if (bodyA->collider.kind == PHYSICS_COLLIDER_CIRCLE && bodyB->collider.kind == PHYSICS_COLLIDER_CIRCLE) {
+      colliding = checkCollisionCircleCollidersFixed(
+        positionA, FixedFromFloat(bodyA->collider.radius), positionB, FixedFromFloat(bodyB->collider.radius), &penetration);
+    } else if (bodyA->collider.kind == PHYSICS_COLLIDER_CIRCLE && bodyB->collider.kind == PHYSICS_COLLIDER_RECTANGLE) {
+      colliding = checkCollisionCircleColliderRectangleColliderFixed(
+        positionA, FixedFromFloat(bodyA->collider.radius), positionB, FixedFromFloat(bodyB->rotation),
+        FixedVector2FromFloat(bodyB->collider.widthHeight.x, bodyB->collider.widthHeight.y), &penetration);
+    } else if (bodyA->collider.kind == PHYSICS_COLLIDER_RECTANGLE && bodyB->collider.kind == PHYSICS_COLLIDER_CIRCLE) {
+      colliding = checkCollisionCircleColliderRectangleColliderFixed(
+        positionB, FixedFromFloat(bodyB->collider.radius), positionA, FixedFromFloat(bodyA->rotation),
+        FixedVector2FromFloat(bodyA->collider.widthHeight.x, bodyA->collider.widthHeight.y), &penetration);
+      penetration = (FixedVector2){ -penetration.x, -penetration.y };
+    }
+    *penetrationOut = (Vector2){ FixedToFloat(penetration.x), FixedToFloat(penetration.y) };
+    return colliding;
+  }
+
   switch (bodyA->collider.kind) {
     case PHYSICS_COLLIDER_CIRCLE:
       switch (bodyB->collider.kind) {
@@ -198,8 +777,11 @@ bool checkCollisionRectangleColliders(Vector2 positionA, float rotationA, Vector
 }
 
 bool checkCollisionCircleColliderRectangleCollider(Vector2 positionA, float radiusA, Vector2 positionB, float rotationB, Vector2 widthHeightB, Vector2* penetrationOut) {
+  float sinRotation, cosRotation;
+  FastSinCos(rotationB, &sinRotation, &cosRotation);
+
   Vector2 circleRelativePosition = Vector2Subtract(positionA, positionB);
-  circleRelativePosition = Vector2Rotate(circleRelativePosition, -rotationB);
+  circleRelativePosition = rotateCosSin(circleRelativePosition, cosRotation, -sinRotation);
 
   float halfWidth = widthHeightB.x / 2;
   float halfHeight = widthHeightB.y / 2;
@@ -216,7 +798,7 @@ bool checkCollisionCircleColliderRectangleCollider(Vector2 positionA, float radi
       float penetrationDepth = radiusA - leftRightSignedDistance + EPSILON;
       penetrationOut->x = circleRelativePosition.x > 0 ? -penetrationDepth : penetrationDepth;
       penetrationOut->y = 0;
-      *penetrationOut = Vector2Rotate(*penetrationOut, rotationB);
+      *penetrationOut = rotateCosSin(*penetrationOut, cosRotation, sinRotation);
       return true;
     }
     
@@ -226,7 +808,7 @@ bool checkCollisionCircleColliderRectangleCollider(Vector2 positionA, float radi
       float penetrationDepth = radiusA - topBottomSignedDistance + EPSILON;
       penetrationOut->x = 0;
       penetrationOut->y = circleRelativePosition.y > 0 ? -penetrationDepth : penetrationDepth;
-      *penetrationOut = Vector2Rotate(*penetrationOut, rotationB);
+      *penetrationOut = rotateCosSin(*penetrationOut, cosRotation, sinRotation);
       return true;
     }
 
@@ -251,10 +833,122 @@ bool checkCollisionCircleColliderRectangleCollider(Vector2 positionA, float radi
 
       float penetrationDepth = radiusA - distanceToNearestCorner + EPSILON;
       *penetrationOut = Vector2Scale(deltaToNearestCorner, penetrationDepth);
-      *penetrationOut = Vector2Rotate(*penetrationOut, rotationB);
+      *penetrationOut = rotateCosSin(*penetrationOut, cosRotation, sinRotation);
       return true;
     }
   }
 
   return false;
 }
+
+Vector2 rotateCosSin(Vector2 vector, float cosAngle, float sinAngle) {
+  return (Vector2){ vector.x * cosAngle - vector.y * sinAngle, vector.x * sinAngle + vector.y * cosAngle };
+}
+
+
+bool checkCollisionCircleColliderBoundaryFixed(FixedVector2 position, Fixed radius, const PhysicsWorld* world, FixedVector2* penetrationOut) {
+  Fixed left = FixedFromFloat(world->boundary.x);
+  Fixed top = FixedFromFloat(world->boundary.y);
+  Fixed right = left + FixedFromFloat(world->boundary.width);
+  Fixed bottom = top + FixedFromFloat(world->boundary.height);
+  bool colliding = false;
+
+  if (position.x - radius < left) {
+    colliding = true;
+    penetrationOut->x = position.x - radius - left - FIXED_EPSILON;
+  } else if (position.x + radius > right) {
+    colliding = true;
+    penetrationOut->x = position.x + radius - right + FIXED_EPSILON;
+  } else {
+    penetrationOut->x = 0;
+  }
+
+  if (position.y - radius < top) {
+    colliding = true;
+    penetrationOut->y = position.y - radius - top - FIXED_EPSILON;
+  } else if (position.y + radius > bottom) {
+    colliding = true;
+    penetrationOut->y = position.y + radius - bottom + FIXED_EPSILON;
+  } else {
+    penetrationOut->y = 0;
+  }
+
+  return colliding;
+}
+
+bool checkCollisionCircleCollidersFixed(FixedVector2 positionA, Fixed radiusA, FixedVector2 positionB, Fixed radiusB, FixedVector2* penetrationOut) {
+  FixedVector2 delta = FixedVector2Subtract(positionB, positionA);
+  Fixed radii = radiusA + radiusB;
+
+  int64_t squareDistance = FixedVector2LengthSqrWide(delta);
+  if (squareDistance < FixedSquareWide(radii)) {
+    Fixed distance = FixedSqrtWide(squareDistance);
+    if (distance > FIXED_EPSILON) {
+      delta.x = FixedDiv(delta.x, distance); delta.y = FixedDiv(delta.y, distance);
+    } else {
+      // Arbitrary but deterministic normal vector
+      delta = (FixedVector2){ FIXED_ONE, 0 };
+    }
+
+    Fixed penetrationDepth = radii - distance + FIXED_EPSILON;
+    *penetrationOut = FixedVector2Scale(delta, penetrationDepth);
+    return true;
+  } else {
+    return false;
+  }
+}
+
+bool checkCollisionCircleColliderRectangleColliderFixed(FixedVector2 positionA, Fixed radiusA, FixedVector2 positionB, Fixed rotationB, FixedVector2 widthHeightB, FixedVector2* penetrationOut) {
+  Fixed cosRotation = FixedCos(rotationB);
+  Fixed sinRotation = FixedSin(rotationB);
+  FixedVector2 circleRelativePosition = FixedVector2Subtract(positionA, positionB);
+  circleRelativePosition = FixedVector2RotateCosSin(circleRelativePosition, cosRotation, -sinRotation);
+
+  Fixed halfWidth = widthHeightB.x / 2;
+  Fixed halfHeight = widthHeightB.y / 2;
+
+  Fixed leftRightSignedDistance = FixedAbs(circleRelativePosition.x) - halfWidth;
+  Fixed topBottomSignedDistance = FixedAbs(circleRelativePosition.y) - halfHeight;
+
+  bool circleIsBetweenLeftAndRight = leftRightSignedDistance <= 0;
+  bool circleIsBetweenTopAndBottom = topBottomSignedDistance <= 0;
+
+  FixedVector2 penetration;
+  if (circleIsBetweenTopAndBottom && (!circleIsBetweenLeftAndRight || leftRightSignedDistance > topBottomSignedDistance)) {
+    // Check for collision with left-right sides.
+    if (leftRightSignedDistance >= radiusA) { return false; }
+    Fixed penetrationDepth = radiusA - leftRightSignedDistance + FIXED_EPSILON;
+    penetration = (FixedVector2){ circleRelativePosition.x > 0 ? -penetrationDepth : penetrationDepth, 0 };
+
+  } else if (circleIsBetweenLeftAndRight) {
+    // Check for collision with top-bottom sides.
+    if (topBottomSignedDistance >= radiusA) { return false; }
+    Fixed penetrationDepth = radiusA - topBottomSignedDistance + FIXED_EPSILON;
+    penetration = (FixedVector2){ 0, circleRelativePosition.y > 0 ? -penetrationDepth : penetrationDepth };
+
+  } else {
+    // Check for collision with nearest corner.
+    FixedVector2 deltaToNearestCorner = { leftRightSignedDistance, topBottomSignedDistance };
+
+    int64_t sqrDistanceToNearestCorner = FixedVector2LengthSqrWide(deltaToNearestCorner);
+    if (sqrDistanceToNearestCorner >= FixedSquareWide(radiusA)) { return false; }
+    Fixed distanceToNearestCorner = FixedSqrtWide(sqrDistanceToNearestCorner);
+    if (distanceToNearestCorner > FIXED_EPSILON) {
+      deltaToNearestCorner.x = FixedDiv(deltaToNearestCorner.x, distanceToNearestCorner);
+      deltaToNearestCorner.y = FixedDiv(deltaToNearestCorner.y, distanceToNearestCorner);
+    } else {
+      // Arbitrary but deterministic normal vector
+      deltaToNearestCorner = (FixedVector2){ FIXED_SQRT1_2, FIXED_SQRT1_2 };
+    }
+
+    // Set signs based on which corner the circle is closest to.
+    deltaToNearestCorner.x = circleRelativePosition.x > 0 ? -deltaToNearestCorner.x : deltaToNearestCorner.x;
+    deltaToNearestCorner.y = circleRelativePosition.y > 0 ? -deltaToNearestCorner.y : deltaToNearestCorner.y;
+
+    Fixed penetrationDepth = radiusA - distanceToNearestCorner + FIXED_EPSILON;
+    penetration = FixedVector2Scale(deltaToNearestCorner, penetrationDepth);
+  }
+
+  *penetrationOut = FixedVector2RotateCosSin(penetration, cosRotation, sinRotation);
+  return true;
+}
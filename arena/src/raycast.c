@@ -1,6 +1,21 @@
 #include "arena/raycast.h"
 #include <raymath.h>
 #include <assert.h>
+#include "arena/fixed.h"
+#include "arena/trig.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define USE_SSE_RAYCAST
+#endif
+
+// The number of rays intersected with each body at once by ComputeRaycastBatch.
+#define RAYCAST_LANES 4
+
+// The maximum number of steps a ray is sphere traced through a distance field before being tested exactly.
+#define MAX_SPHERE_TRACE_STEPS 32
+// The smallest step, as a fraction of the field's cell size, worth sphere tracing before testing a ray exactly.
+#define MIN_SPHERE_TRACE_STEP_CELLS 0.5f
 
 
 float checkRaycastWithBody(const PhysicsBody* body, Vector2 origin, Vector2 direction);
@@ -8,37 +23,257 @@ float checkRaycastWithCircleCollider(Vector2 position, float radius, Vector2 ori
 float checkRaycastWithRectangleCollider(Vector2 position, float rotation, Vector2 widthHeight, Vector2 origin, Vector2 direction);
 float checkRaycastWithBoundary(const PhysicsWorld* world, Vector2 origin, Vector2 direction);
 
+// Updates the nearest result for a ray with the static bodies and boundary of a world with a baked distance field.
+// The ray is sphere traced through empty space, and only tested exactly against the static geometry if it comes near
+// a static surface before reaching the nearest result, so the outcome is the same as testing it exactly from the start.
+void traceRaycastWithStaticGeometry(const PhysicsWorld* world, Vector2 origin, Vector2 direction, RaycastResult* nearestResult);
+
+// Computes the raycast results for exactly RAYCAST_LANES rays.
+void computeRaycastLanes(const PhysicsWorld* world, const Vector2* origins, const Vector2* directions, RaycastResult* resultsOut);
+
+// Computes a raycast result using fixed-point arithmetic. Distances of FIXED_MAX represent no intersection.
+RaycastResult computeRaycastFixed(const PhysicsWorld* world, Vector2 origin, Vector2 direction);
+Fixed checkRaycastWithCircleColliderFixed(FixedVector2 position, Fixed radius, FixedVector2 origin, FixedVector2 direction);
+Fixed checkRaycastWithRectangleColliderFixed(FixedVector2 position, Fixed rotation, FixedVector2 widthHeight, FixedVector2 origin, FixedVector2 direction);
+// Computes the distance along a ray to the line at the given offset, or FIXED_MAX if the intersection
+// lies behind the ray or outside of the span [min, max] along the perpendicular axis.
+Fixed checkRaycastWithEdgeFixed(Fixed offset, Fixed direction, Fixed perpendicularDirection, Fixed min, Fixed max);
+Fixed checkRaycastWithBoundaryFixed(const PhysicsWorld* world, FixedVector2 origin, FixedVector2 direction);
+
 
 RaycastResult ComputeRaycast(const PhysicsWorld* world, Vector2 origin, Vector2 direction) {
-  RaycastResult nearestResult = { .distance = INFINITY, .type = INTERSECTION_NONE, .bodyIndex = -1 };
-  
-  direction = Vector2Normalize(direction);
-  if (direction.x == 0 && direction.y == 0) {
-    return nearestResult;
+  RaycastResult result;
+  ComputeRaycastBatch(world, 1, &origin, &direction, &result);
+  return result;
+}
+
+void ComputeRaycastBatch(const PhysicsWorld* world, size_t rayCount, const Vector2* origins, const Vector2* directions, RaycastResult* resultsOut) {
+  if (world->useFixedPoint) {
+    for (size_t i = 0; i < rayCount; i++) {
+      resultsOut[i] = computeRaycastFixed(world, origins[i], directions[i]);
+    }
+    return;
+  }
+
+  size_t i = 0;
+  for (; i + RAYCAST_LANES <= rayCount; i += RAYCAST_LANES) {
+    computeRaycastLanes(world, &origins[i], &directions[i], &resultsOut[i]);
+  }
+
+  if (i < rayCount) {
+    // Pad the remaining rays with zero-length rays, which never intersect anything
+    Vector2 paddedOrigins[RAYCAST_LANES] = { 0 };
+    Vector2 paddedDirections[RAYCAST_LANES] = { 0 };
+    RaycastResult paddedResults[RAYCAST_LANES];
+    for (size_t k = 0; i + k < rayCount; k++) {
+      paddedOrigins[k] = origins[i + k];
+      paddedDirections[k] = directions[i + k];
+    }
+
+    computeRaycastLanes(world, paddedOrigins, paddedDirections, paddedResults);
+    for (size_t k = 0; i + k < rayCount; k++) {
+      resultsOut[i + k] = paddedResults[k];
+    }
+  }
+}
+
+
+#if defined(USE_SSE_RAYCAST)
+
+#pragma region SIMD lane helper functions
+
+// Selects the lanes of a where mask is set and the lanes of b elsewhere.
+static inline __m128 selectLanes(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// Mirrors checkRaycastWithCircleCollider for each lane.
+static inline __m128 checkRaycastWithCircleColliderLanes(Vector2 position, float radius, __m128 originX, __m128 originY, __m128 directionX, __m128 directionY) {
+  const __m128 infinity = _mm_set1_ps(INFINITY);
+  const __m128 zero = _mm_setzero_ps();
+
+  __m128 relativeX = _mm_sub_ps(_mm_set1_ps(position.x), originX);
+  __m128 relativeY = _mm_sub_ps(_mm_set1_ps(position.y), originY);
+  __m128 projectedDistanceAlongRay = _mm_add_ps(_mm_mul_ps(relativeX, directionX), _mm_mul_ps(relativeY, directionY));
+  __m128 sqrRelativeDistance = _mm_add_ps(_mm_mul_ps(relativeX, relativeX), _mm_mul_ps(relativeY, relativeY));
+  __m128 sqrDistanceBetweenPositionAndProjectedPosition = _mm_sub_ps(sqrRelativeDistance, _mm_mul_ps(projectedDistanceAlongRay, projectedDistanceAlongRay));
+  __m128 sqrDistanceBetweenProjectedPositionAndIntersections = _mm_sub_ps(_mm_set1_ps(radius * radius), sqrDistanceBetweenPositionAndProjectedPosition);
+
+  __m128 missesCollider = _mm_cmplt_ps(sqrDistanceBetweenProjectedPositionAndIntersections, zero);
+  __m128 distanceBetweenProjectedPositionAndIntersections = _mm_sqrt_ps(_mm_max_ps(sqrDistanceBetweenProjectedPositionAndIntersections, zero));
+  __m128 absProjectedDistanceAlongRay = _mm_andnot_ps(_mm_set1_ps(-0.0f), projectedDistanceAlongRay);
+  __m128 originIsInsideCollider = _mm_cmpgt_ps(distanceBetweenProjectedPositionAndIntersections, absProjectedDistanceAlongRay);
+  __m128 colliderIsBehindOrigin = _mm_cmplt_ps(projectedDistanceAlongRay, zero);
+
+  // Apply the same precedence as the scalar implementation
+  __m128 distance = _mm_sub_ps(projectedDistanceAlongRay, distanceBetweenProjectedPositionAndIntersections);
+  distance = selectLanes(colliderIsBehindOrigin, infinity, distance);
+  distance = selectLanes(originIsInsideCollider, zero, distance);
+  distance = selectLanes(missesCollider, infinity, distance);
+  return distance;
+}
+
+// Computes the distance along each lane's ray to the line at the given offset, or +inf if the intersection
+// lies behind the ray or outside of the span [min, max] along the perpendicular axis.
+static inline __m128 checkRaycastWithEdgeLanes(__m128 offset, __m128 direction, __m128 perpendicularDirection, __m128 min, __m128 max) {
+  __m128 distance = _mm_div_ps(offset, direction);
+  __m128 intersection = _mm_mul_ps(distance, perpendicularDirection);
+  // Ordered comparisons are false for NaN, which matches the scalar implementation's isnan checks
+  __m128 isValid = _mm_and_ps(
+    _mm_cmpge_ps(distance, _mm_setzero_ps()),
+    _mm_and_ps(_mm_cmpge_ps(intersection, min), _mm_cmple_ps(intersection, max)));
+  return selectLanes(isValid, distance, _mm_set1_ps(INFINITY));
+}
+
+// Mirrors checkRaycastWithRectangleCollider for each lane.
+static inline __m128 checkRaycastWithRectangleColliderLanes(Vector2 position, float rotation, Vector2 widthHeight, __m128 originX, __m128 originY, __m128 directionX, __m128 directionY) {
+  float sinNegRotation, cosNegRotation;
+  FastSinCos(-rotation, &sinNegRotation, &cosNegRotation);
+  __m128 cosRotation = _mm_set1_ps(cosNegRotation);
+  __m128 sinRotation = _mm_set1_ps(sinNegRotation);
+
+  __m128 relativeX = _mm_sub_ps(_mm_set1_ps(position.x), originX);
+  __m128 relativeY = _mm_sub_ps(_mm_set1_ps(position.y), originY);
+
+  __m128 localDirectionX = _mm_sub_ps(_mm_mul_ps(directionX, cosRotation), _mm_mul_ps(directionY, sinRotation));
+  __m128 localDirectionY = _mm_add_ps(_mm_mul_ps(directionX, sinRotation), _mm_mul_ps(directionY, cosRotation));
+  __m128 localRelativeX = _mm_sub_ps(_mm_mul_ps(relativeX, cosRotation), _mm_mul_ps(relativeY, sinRotation));
+  __m128 localRelativeY = _mm_add_ps(_mm_mul_ps(relativeX, sinRotation), _mm_mul_ps(relativeY, cosRotation));
+
+  __m128 halfWidth = _mm_set1_ps(widthHeight.x / 2);
+  __m128 halfHeight = _mm_set1_ps(widthHeight.y / 2);
+  __m128 left = _mm_sub_ps(localRelativeX, halfWidth);
+  __m128 right = _mm_add_ps(localRelativeX, halfWidth);
+  __m128 top = _mm_sub_ps(localRelativeY, halfHeight);
+  __m128 bottom = _mm_add_ps(localRelativeY, halfHeight);
+
+  __m128 leftDist = checkRaycastWithEdgeLanes(left, localDirectionX, localDirectionY, top, bottom);
+  __m128 rightDist = checkRaycastWithEdgeLanes(right, localDirectionX, localDirectionY, top, bottom);
+  __m128 topDist = checkRaycastWithEdgeLanes(top, localDirectionY, localDirectionX, left, right);
+  __m128 bottomDist = checkRaycastWithEdgeLanes(bottom, localDirectionY, localDirectionX, left, right);
+
+  return _mm_min_ps(_mm_min_ps(leftDist, rightDist), _mm_min_ps(topDist, bottomDist));
+}
+
+#pragma endregion
+
+void computeRaycastLanes(const PhysicsWorld* world, const Vector2* origins, const Vector2* directions, RaycastResult* resultsOut) {
+  float originX[RAYCAST_LANES], originY[RAYCAST_LANES];
+  float directionX[RAYCAST_LANES], directionY[RAYCAST_LANES];
+  bool isActive[RAYCAST_LANES];
+  for (unsigned int k = 0; k < RAYCAST_LANES; k++) {
+    Vector2 direction = Vector2Normalize(directions[k]);
+    isActive[k] = direction.x != 0 || direction.y != 0;
+    originX[k] = origins[k].x; originY[k] = origins[k].y;
+    directionX[k] = direction.x; directionY[k] = direction.y;
   }
 
+  __m128 originXLanes = _mm_loadu_ps(originX), originYLanes = _mm_loadu_ps(originY);
+  __m128 directionXLanes = _mm_loadu_ps(directionX), directionYLanes = _mm_loadu_ps(directionY);
+
   // Check for ray intersection with each of the physics bodies
-  double distance;
+  __m128 nearestDistance = _mm_set1_ps(INFINITY);
+  __m128 nearestBodyIndex = _mm_set1_ps(-1);
+  bool useDistanceField = world->staticDistanceField.isBaked;
   for (unsigned int i = 0; i < world->bodyCount; i++) {
-    distance = checkRaycastWithBody(&world->bodies[i], origin, direction);
-    if (distance < nearestResult.distance) {
-      nearestResult.distance = distance;
-      nearestResult.type = INTERSECTION_BODY;
-      nearestResult.bodyIndex = i;
+    const PhysicsBody* body = &world->bodies[i];
+    if (useDistanceField && body->isStatic) {
+      continue; // Static bodies are traced through the distance field below.
+    }
+
+    __m128 distance;
+    switch (body->collider.kind) {
+      case PHYSICS_COLLIDER_CIRCLE:
+        distance = checkRaycastWithCircleColliderLanes(body->position, body->collider.radius, originXLanes, originYLanes, directionXLanes, directionYLanes);
+        break;
+      case PHYSICS_COLLIDER_RECTANGLE:
+        distance = checkRaycastWithRectangleColliderLanes(body->position, body->rotation, body->collider.widthHeight, originXLanes, originYLanes, directionXLanes, directionYLanes);
+        break;
+      default:
+        assert(false);
+        continue;
     }
+
+    __m128 isNearer = _mm_cmplt_ps(distance, nearestDistance);
+    nearestDistance = selectLanes(isNearer, distance, nearestDistance);
+    nearestBodyIndex = selectLanes(isNearer, _mm_set1_ps((float)i), nearestBodyIndex);
   }
 
-  // Check for ray intersection with each of the world boundaries
-  distance = checkRaycastWithBoundary(world, origin, direction);
-  if (distance < nearestResult.distance) {
-    nearestResult.distance = distance;
-    nearestResult.type = INTERSECTION_BOUNDARY;
-    nearestResult.bodyIndex = -1;
+  float nearestDistances[RAYCAST_LANES], nearestBodyIndices[RAYCAST_LANES];
+  _mm_storeu_ps(nearestDistances, nearestDistance);
+  _mm_storeu_ps(nearestBodyIndices, nearestBodyIndex);
+
+  for (unsigned int k = 0; k < RAYCAST_LANES; k++) {
+    RaycastResult nearestResult = { .distance = INFINITY, .type = INTERSECTION_NONE, .bodyIndex = -1 };
+    if (isActive[k]) {
+      if (nearestDistances[k] < INFINITY) {
+        nearestResult.distance = nearestDistances[k];
+        nearestResult.type = INTERSECTION_BODY;
+        nearestResult.bodyIndex = (int)nearestBodyIndices[k];
+      }
+
+      if (useDistanceField) {
+        traceRaycastWithStaticGeometry(world, origins[k], (Vector2){ directionX[k], directionY[k] }, &nearestResult);
+      } else {
+        // Check for ray intersection with each of the world boundaries
+        float distance = checkRaycastWithBoundary(world, origins[k], (Vector2){ directionX[k], directionY[k] });
+        if (distance < nearestResult.distance) {
+          nearestResult.distance = distance;
+          nearestResult.type = INTERSECTION_BOUNDARY;
+          nearestResult.bodyIndex = -1;
+        }
+      }
+    }
+    resultsOut[k] = nearestResult;
   }
+}
 
-  return nearestResult;
+#else
+
+void computeRaycastLanes(const PhysicsWorld* world, const Vector2* origins, const Vector2* directions, RaycastResult* resultsOut) {
+  bool useDistanceField = world->staticDistanceField.isBaked;
+  for (unsigned int k = 0; k < RAYCAST_LANES; k++) {
+    RaycastResult nearestResult = { .distance = INFINITY, .type = INTERSECTION_NONE, .bodyIndex = -1 };
+
+    Vector2 direction = Vector2Normalize(directions[k]);
+    if (direction.x == 0 && direction.y == 0) {
+      resultsOut[k] = nearestResult;
+      continue;
+    }
+
+    // Check for ray intersection with each of the physics bodies
+    double distance;
+    for (unsigned int i = 0; i < world->bodyCount; i++) {
+      if (useDistanceField && world->bodies[i].isStatic) {
+        continue; // Static bodies are traced through the distance field below.
+      }
+
+      distance = checkRaycastWithBody(&world->bodies[i], origins[k], direction);
+      if (distance < nearestResult.distance) {
+        nearestResult.distance = distance;
+        nearestResult.type = INTERSECTION_BODY;
+        nearestResult.bodyIndex = i;
+      }
+    }
+
+    if (useDistanceField) {
+      traceRaycastWithStaticGeometry(world, origins[k], direction, &nearestResult);
+    } else {
+      // Check for ray intersection with each of the world boundaries
+      distance = checkRaycastWithBoundary(world, origins[k], direction);
+      if (distance < nearestResult.distance) {
+        nearestResult.distance = distance;
+        nearestResult.type = INTERSECTION_BOUNDARY;
+        nearestResult.bodyIndex = -1;
+      }
+    }
+
+    resultsOut[k] = nearestResult;
+  }
 }
 
+#endif
+
 
 float checkRaycastWithBody(const PhysicsBody* body, Vector2 origin, Vector2 direction) {
   switch (body->collider.kind) {
@@ -81,8 +316,16 @@ float checkRaycastWithRectangleCollider(Vector2 position, float rotation, Vector
   // Compute the intersection point between the ray and the rectangle
   Vector2 relativePosition = Vector2Subtract(position, origin);
 
-  direction = Vector2Rotate(direction, -rotation);
-  relativePosition = Vector2Rotate(relativePosition, -rotation);
+  float sinNegRotation, cosNegRotation;
+  FastSinCos(-rotation, &sinNegRotation, &cosNegRotation);
+  direction = (Vector2){
+    direction.x * cosNegRotation - direction.y * sinNegRotation,
+    direction.x * sinNegRotation + direction.y * cosNegRotation
+  };
+  relativePosition = (Vector2){
+    relativePosition.x * cosNegRotation - relativePosition.y * sinNegRotation,
+    relativePosition.x * sinNegRotation + relativePosition.y * cosNegRotation
+  };
 
   float left = relativePosition.x - widthHeight.x / 2;
   float right = relativePosition.x + widthHeight.x / 2;
@@ -143,3 +386,194 @@ float checkRaycastWithBoundary(const PhysicsWorld* world, Vector2 origin, Vector
 
   return fminf(leftRightBoundaryDistance, topBottomBoundaryDistance);
 }
+
+void traceRaycastWithStaticGeometry(const PhysicsWorld* world, Vector2 origin, Vector2 direction, RaycastResult* nearestResult) {
+  // Step along the ray by the distance to the nearest static surface until it comes near one. If it passes the
+  // nearest result first, every static surface lies beyond that result.
+  float minStep = world->staticDistanceField.cellSize * MIN_SPHERE_TRACE_STEP_CELLS;
+  float travelled = 0;
+  for (unsigned int k = 0; k < MAX_SPHERE_TRACE_STEPS; k++) {
+    Vector2 position = { origin.x + direction.x * travelled, origin.y + direction.y * travelled };
+    float clearance = GetPhysicsStaticDistanceBound(world, position);
+    if (clearance < minStep) {
+      break;
+    }
+
+    travelled += clearance;
+    if (travelled > nearestResult->distance) {
+      return;
+    }
+  }
+
+  // Check for ray intersection with each of the static bodies, keeping the lowest index among equally near bodies
+  for (unsigned int i = 0; i < world->bodyCount; i++) {
+    if (!world->bodies[i].isStatic) {
+      continue;
+    }
+
+    float distance = checkRaycastWithBody(&world->bodies[i], origin, direction);
+    if (distance < nearestResult->distance
+        || (distance == nearestResult->distance && nearestResult->type == INTERSECTION_BODY && (int)i < nearestResult->bodyIndex)) {
+      nearestResult->distance = distance;
+      nearestResult->type = INTERSECTION_BODY;
+      nearestResult->bodyIndex = i;
+    }
+  }
+
+  // Check for ray intersection with each of the world boundaries
+  float distance = checkRaycastWithBoundary(world, origin, direction);
+  if (distance < nearestResult->distance) {
+    nearestResult->distance = distance;
+    nearestResult->type = INTERSECTION_BOUNDARY;
+    nearestResult->bodyIndex = -1;
+  }
+}
+
+
+RaycastResult computeRaycastFixed(const PhysicsWorld* world, Vector2 origin, Vector2 direction) {
+  RaycastResult nearestResult = { .distance = INFINITY, .type = INTERSECTION_NONE, .bodyIndex = -1 };
+
+  FixedVector2 fixedOrigin = FixedVector2FromFloat(origin.x, origin.y);
+  FixedVector2 fixedDirection = FixedVector2FromFloat(direction.x, direction.y);
+  Fixed length = FixedSqrtWide(FixedVector2LengthSqrWide(fixedDirection));
+  if (length == 0) {
+    return nearestResult;
+  }
+  fixedDirection = (FixedVector2){ FixedDiv(fixedDirection.x, length), FixedDiv(fixedDirection.y, length) };
+
+  // Check for ray intersection with each of the physics bodies
+  Fixed nearestDistance = FIXED_MAX;
+  Fixed distance;
+  for (unsigned int i = 0; i < world->bodyCount; i++) {
+    const PhysicsBody* body = &world->bodies[i];
+    FixedVector2 position = FixedVector2FromFloat(body->position.x, body->position.y);
+    switch (body->collider.kind) {
+      case PHYSICS_COLLIDER_CIRCLE:
+        distance = checkRaycastWithCircleColliderFixed(position, FixedFromFloat(body->collider.radius), fixedOrigin, fixedDirection);
+        break;
+      case PHYSICS_COLLIDER_RECTANGLE:
+        distance = checkRaycastWithRectangleColliderFixed(position, FixedFromFloat(body->rotation),
+          FixedVector2FromFloat(body->collider.widthHeight.x, body->collider.widthHeight.y), fixedOrigin, fixedDirection);
+        break;
+      default:
+        assert(false);
+        continue;
+    }
+
+    if (distance < nearestDistance) {
+      nearestDistance = distance;
+      nearestResult.type = INTERSECTION_BODY;
+      nearestResult.bodyIndex = i;
+    }
+  }
+
+  // Check for ray intersection with each of the world boundaries
+  distance = checkRaycastWithBoundaryFixed(world, fixedOrigin, fixedDirection);
+  if (distance < nearestDistance) {
+    nearestDistance = distance;
+    nearestResult.type = INTERSECTION_BOUNDARY;
+    nearestResult.bodyIndex = -1;
+  }
+
+  if (nearestResult.type != INTERSECTION_NONE) {
+    nearestResult.distance = FixedToFloat(nearestDistance);
+  }
+  return nearestResult;
+}
+
+Fixed checkRaycastWithCircleColliderFixed(FixedVector2 position, Fixed radius, FixedVector2 origin, FixedVector2 direction) {
+  // Compute the intersection point between the ray and the circle
+  FixedVector2 relativePosition = FixedVector2Subtract(position, origin);
+  Fixed projectedDistanceAlongRay = FixedVector2Dot(relativePosition, direction);
+  int64_t sqrDistanceBetweenPositionAndProjectedPosition = FixedVector2LengthSqrWide(relativePosition) - FixedSquareWide(projectedDistanceAlongRay);
+  int64_t sqrDistanceBetweenProjectedPositionAndIntersections = FixedSquareWide(radius) - sqrDistanceBetweenPositionAndProjectedPosition;
+
+  if (sqrDistanceBetweenProjectedPositionAndIntersections < 0) {
+    return FIXED_MAX; // The ray does not intersect with the collider
+  }
+
+  Fixed distanceBetweenProjectedPositionAndIntersections = FixedSqrtWide(sqrDistanceBetweenProjectedPositionAndIntersections);
+  if (distanceBetweenProjectedPositionAndIntersections > FixedAbs(projectedDistanceAlongRay)) {
+    return 0; // The ray origin is inside the collider
+  }
+
+  if (projectedDistanceAlongRay < 0) {
+    return FIXED_MAX; // The collider is behind the origin of the ray
+  }
+
+  return projectedDistanceAlongRay - distanceBetweenProjectedPositionAndIntersections;
+}
+
+Fixed checkRaycastWithEdgeFixed(Fixed offset, Fixed direction, Fixed perpendicularDirection, Fixed min, Fixed max) {
+  if (direction == 0) {
+    return FIXED_MAX; // The ray is parallel to the edge
+  }
+
+  int64_t distance = ((int64_t)offset * FIXED_ONE) / direction;
+  if (distance < 0 || distance >= FIXED_MAX) {
+    return FIXED_MAX;
+  }
+
+  int64_t intersection = (distance * perpendicularDirection) >> FIXED_FRACTION_BITS;
+  if (intersection < min || intersection > max) {
+    return FIXED_MAX;
+  }
+  return (Fixed)distance;
+}
+
+Fixed checkRaycastWithRectangleColliderFixed(FixedVector2 position, Fixed rotation, FixedVector2 widthHeight, FixedVector2 origin, FixedVector2 direction) {
+  // Compute the intersection point between the ray and the rectangle
+  Fixed cosRotation = FixedCos(rotation);
+  Fixed negSinRotation = -FixedSin(rotation);
+  FixedVector2 relativePosition = FixedVector2Subtract(position, origin);
+
+  direction = FixedVector2RotateCosSin(direction, cosRotation, negSinRotation);
+  relativePosition = FixedVector2RotateCosSin(relativePosition, cosRotation, negSinRotation);
+
+  Fixed left = relativePosition.x - widthHeight.x / 2;
+  Fixed right = relativePosition.x + widthHeight.x / 2;
+  Fixed top = relativePosition.y - widthHeight.y / 2;
+  Fixed bottom = relativePosition.y + widthHeight.y / 2;
+
+  Fixed leftDist = checkRaycastWithEdgeFixed(left, direction.x, direction.y, top, bottom);
+  Fixed rightDist = checkRaycastWithEdgeFixed(right, direction.x, direction.y, top, bottom);
+  Fixed topDist = checkRaycastWithEdgeFixed(top, direction.y, direction.x, left, right);
+  Fixed bottomDist = checkRaycastWithEdgeFixed(bottom, direction.y, direction.x, left, right);
+
+  Fixed nearest = leftDist;
+  if (rightDist < nearest) { nearest = rightDist; }
+  if (topDist < nearest) { nearest = topDist; }
+  if (bottomDist < nearest) { nearest = bottomDist; }
+  return nearest;
+}
+
+Fixed checkRaycastWithBoundaryFixed(const PhysicsWorld* world, FixedVector2 origin, FixedVector2 direction) {
+  Fixed left = FixedFromFloat(world->boundary.x);
+  Fixed top = FixedFromFloat(world->boundary.y);
+  Fixed right = left + FixedFromFloat(world->boundary.width);
+  Fixed bottom = top + FixedFromFloat(world->boundary.height);
+
+  Fixed leftRightBoundaryDistance;
+  if (left <= origin.x && direction.x < 0) {
+    leftRightBoundaryDistance = FixedDiv(left - origin.x, direction.x);
+  } else if (right >= origin.x && direction.x > 0) {
+    leftRightBoundaryDistance = FixedDiv(right - origin.x, direction.x);
+  } else if (left > origin.x || right < origin.x) {
+    return 0; // Origin is outside the boundaries
+  } else {
+    leftRightBoundaryDistance = FIXED_MAX;
+  }
+
+  Fixed topBottomBoundaryDistance;
+  if (top <= origin.y && direction.y < 0) {
+    topBottomBoundaryDistance = FixedDiv(top - origin.y, direction.y);
+  } else if (bottom >= origin.y && direction.y > 0) {
+    topBottomBoundaryDistance = FixedDiv(bottom - origin.y, direction.y);
+  } else if (top > origin.y || bottom < origin.y) {
+    return 0; // Origin is outside the boundaries
+  } else {
+    topBottomBoundaryDistance = FIXED_MAX;
+  }
+
+  return leftRightBoundaryDistance < topBottomBoundaryDistance ? leftRightBoundaryDistance : topBottomBoundaryDistance;
+}
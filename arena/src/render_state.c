@@ -0,0 +1,131 @@
+#include "arena/render_state.h"
+#include <math.h>
+#include <raymath.h>
+
+
+float lerpRotation(float from, float to, float amount);
+
+
+void InitRenderStateBuffer(RenderStateBuffer* buffer) {
+  for (size_t i = 0; i < RENDER_STATE_BUFFER_COUNT; i++) {
+    buffer->states[i] = (RenderState){ 0 };
+  }
+  buffer->writeIndex = 0;
+  atomic_init(&buffer->sharedIndex, 1);
+  buffer->readIndex = 2;
+}
+
+void PublishRenderState(RenderStateBuffer* buffer, const Simulation* simulation) {
+  CaptureRenderState(simulation, &buffer->states[buffer->writeIndex]);
+
+  // Swap the filled state with the shared one, taking whichever state the reader last released or never acquired
+  uint32_t previousIndex = atomic_exchange_explicit(&buffer->sharedIndex, buffer->writeIndex | RENDER_STATE_FRESH_FLAG, memory_order_acq_rel);
+  buffer->writeIndex = previousIndex & ~RENDER_STATE_FRESH_FLAG;
+}
+
+const RenderState* AcquireRenderState(RenderStateBuffer* buffer) {
+  const RenderState* state;
+  TryAcquireNewRenderState(buffer, &state);
+  return &buffer->states[buffer->readIndex];
+}
+
+bool TryAcquireNewRenderState(RenderStateBuffer* buffer, const RenderState** stateOut) {
+  if (!(atomic_load_explicit(&buffer->sharedIndex, memory_order_relaxed) & RENDER_STATE_FRESH_FLAG)) {
+    return false;
+  }
+  uint32_t latestIndex = atomic_exchange_explicit(&buffer->sharedIndex, buffer->readIndex, memory_order_acq_rel);
+  buffer->readIndex = latestIndex & ~RENDER_STATE_FRESH_FLAG;
+  *stateOut = &buffer->states[buffer->readIndex];
+  return true;
+}
+
+void InitRenderStateHistory(RenderStateHistory* history) {
+  history->previous = (RenderState){ 0 };
+  history->latest = (RenderState){ 0 };
+  history->latestTime = 0;
+}
+
+void UpdateRenderStateHistory(RenderStateHistory* history, RenderStateBuffer* buffer, int64_t time) {
+  const RenderState* state;
+  if (!TryAcquireNewRenderState(buffer, &state)) {
+    return;
+  }
+
+  // Move on from what is being drawn, rather than from the previous latest state, so that motion doesn't jump when
+  // a state arrives early or late
+  RenderState drawnState;
+  InterpolateRenderState(history, time, &drawnState);
+  history->previous = drawnState;
+  history->latest = *state;
+  history->latestTime = time;
+}
+
+void InterpolateRenderState(const RenderStateHistory* history, int64_t time, RenderState* stateOut) {
+  const RenderState* previous = &history->previous;
+  const RenderState* latest = &history->latest;
+
+  // Work out how far the drawn state has moved towards the latest one, at the speed that the simulation runs at
+  double progress = 1.0;
+  uint64_t tickGap = latest->tickCount - previous->tickCount;
+  bool isContinuous = latest->tickCount > previous->tickCount && tickGap <= RENDER_STATE_MAX_INTERPOLATED_TICKS &&
+                      latest->bodyCount == previous->bodyCount && latest->robotCount == previous->robotCount;
+  if (isContinuous && latest->ticksPerSec > 0) {
+    double elapsedTicks = (double)(time - history->latestTime) * latest->ticksPerSec / TIMER_NANOSECONDS_PER_SECOND;
+    progress = fmin(fmax(elapsedTicks / tickGap, 0.0), 1.0);
+  }
+
+  *stateOut = progress < 0.5 ? *previous : *latest;
+  if (progress >= 1.0) {
+    return;
+  }
+
+  float amount = (float)progress;
+  stateOut->tickCount = previous->tickCount + (uint64_t)(progress * tickGap + 0.5);
+  for (unsigned int i = 0; i < stateOut->bodyCount; i++) {
+    stateOut->bodies[i].position = Vector2Lerp(previous->bodies[i].position, latest->bodies[i].position, amount);
+    stateOut->bodies[i].rotation = lerpRotation(previous->bodies[i].rotation, latest->bodies[i].rotation, amount);
+  }
+  for (size_t i = 0; i < stateOut->robotCount; i++) {
+    stateOut->robots[i].position = Vector2Lerp(previous->robots[i].position, latest->robots[i].position, amount);
+    stateOut->robots[i].rotation = lerpRotation(previous->robots[i].rotation, latest->robots[i].rotation, amount);
+  }
+}
+
+void CaptureRenderState(const Simulation* simulation, RenderState* stateOut) {
+  const PhysicsWorld* physicsWorld = &simulation->physicsWorld;
+  stateOut->tickCount = simulation->tickCount;
+  stateOut->ticksPerSec = simulation->host.timer.ticksPerSec;
+
+  stateOut->boundary = physicsWorld->boundary;
+  stateOut->bodyCount = physicsWorld->bodyCount;
+  for (unsigned int i = 0; i < physicsWorld->bodyCount; i++) {
+    stateOut->bodies[i] = physicsWorld->bodies[i];
+  }
+
+  stateOut->robotCount = simulation->robotCount;
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    const Robot* robot = &simulation->robots[i];
+    const PhysicsBody* body = &physicsWorld->bodies[robot->physicsBodyIndex];
+    RobotRenderState* robotState = &stateOut->robots[i];
+    robotState->position = body->position;
+    robotState->rotation = body->rotation;
+    robotState->energyRemaining = robot->energyRemaining;
+    robotState->weaponCooldownRemaining = robot->weaponCooldownRemaining;
+    robotState->lastWeaponFire.start = robot->lastWeaponFire.start;
+    robotState->lastWeaponFire.end = robot->lastWeaponFire.end;
+    robotState->lastSensorReading.start = robot->lastSensorReading.start;
+    robotState->lastSensorReading.end = robot->lastSensorReading.end;
+    robotState->registers = robot->processState.registers;
+    fetchInstruction(robot->processState.memory, robot->processState.registers.ip, &robotState->nextInstruction);
+  }
+
+  stateOut->battleEnded = simulation->battleEnded;
+  stateOut->battleEndReason = simulation->battleEndReason;
+  stateOut->battleDrawn = simulation->battleDrawn;
+  stateOut->winningRobotIndex = simulation->winningRobotIndex;
+}
+
+float lerpRotation(float from, float to, float amount) {
+  // Turn the shorter way round
+  return from + remainderf(to - from, 2 * PI) * amount;
+}
@@ -0,0 +1,391 @@
+#include "arena/replay.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utilities/bytes.h"
+#include "utilities/file.h"
+
+#define REPLAY_CONTROL_COUNT 4
+#define REPLAY_INITIAL_STREAM_CAPACITY 1024
+// The largest number of bytes taken by a step count in the control stream, which is stored 7 bits per byte.
+#define REPLAY_MAX_VARINT_LENGTH 10
+// The largest number of bytes taken by a single change in the control stream.
+#define REPLAY_MAX_CHANGE_LENGTH (REPLAY_MAX_VARINT_LENGTH + (SIMULATION_MAX_ROBOTS * REPLAY_CONTROL_COUNT + 7) / 8 + SIMULATION_MAX_ROBOTS * REPLAY_CONTROL_COUNT)
+
+// Replays store every field as a little-endian integer. The header holds the magic, version, settings and outcome,
+// and is followed by the map in its binary form, the program texts and then the control stream, each prefixed with
+// its length in bytes.
+#define REPLAY_FLAG_FIXED_POINT 0x1
+#define REPLAY_FLAG_CONTINUOUS_COLLISION 0x2
+
+const char REPLAY_FILE_UNREADABLE[] = "Replay file could not be read";
+const char REPLAY_FILE_TRUNCATED[] = "Replay file ends unexpectedly";
+const char REPLAY_UNSUPPORTED_VERSION[] = "Replay file version is not supported";
+const char REPLAY_INVALID_SETTINGS[] = "Replay settings are not supported";
+const char REPLAY_INVALID_MAP[] = "Replay map is invalid";
+const char REPLAY_OUT_OF_MEMORY[] = "Out of memory";
+
+
+// Gets the number of bytes in the bit mask of changed controls for the given number of robots.
+size_t getControlMaskLength(unsigned int robotCount);
+void controlsToBytes(RobotControls controls, uint8_t* bytesOut);
+RobotControls controlsFromBytes(const uint8_t* bytes);
+
+// Reads a step count stored 7 bits per byte, with the high bit set on every byte but the last.
+bool tryReadReplayVarint(ByteReader* reader, uint64_t* valueOut);
+size_t writeReplayVarint(uint64_t value, uint8_t* bytesOut);
+
+
+void InitReplay(Replay* replayOut, const Simulation* simulation, const ArenaMap* map) {
+  *replayOut = (Replay){
+    .robotCount = (unsigned int)simulation->robotCount,
+    .instructionsPerPhysicsStep = simulation->instructionsPerPhysicsStep,
+    .maxTicks = simulation->maxTicks,
+    .stallWindowTicks = simulation->stallWindowTicks,
+    .useFixedPoint = simulation->physicsWorld.useFixedPoint,
+    .useContinuousCollision = simulation->physicsWorld.useContinuousCollision,
+    .map = *map,
+  };
+
+  // The index can be baked again when the replay is played back, so it isn't worth storing
+  replayOut->map.hasDistanceField = false;
+  replayOut->map.distanceField = (PhysicsDistanceField){ 0 };
+}
+
+void DestroyReplay(Replay* replay) {
+  for (size_t i = 0; i < SIMULATION_MAX_ROBOTS; i++) {
+    free(replay->programTexts[i]);
+  }
+  free(replay->controlStream);
+  *replay = (Replay){ 0 };
+}
+
+bool TrySetReplayProgramText(Replay* replay, size_t robotIndex, const TextContents* programText) {
+  char* text = malloc(programText->length + 1);
+  if (text == NULL) {
+    return false;
+  }
+
+  // Lines are separated by null characters in text contents
+  size_t length = programText->length;
+  while (length > 0 && programText->chars[length - 1] == '\0') { length--; }
+  for (size_t i = 0; i < length; i++) {
+    text[i] = programText->chars[i] == '\0' ? '\n' : programText->chars[i];
+  }
+  text[length] = '\0';
+
+  free(replay->programTexts[robotIndex]);
+  replay->programTexts[robotIndex] = text;
+  replay->programTextLengths[robotIndex] = length;
+  return true;
+}
+
+bool TrySaveReplay(const Replay* replay, const char* filePath) {
+  FILE* file = fopen(filePath, "wb");
+  if (file == NULL) {
+    return false;
+  }
+
+  // Write the header
+  uint32_t flags = (replay->useFixedPoint ? REPLAY_FLAG_FIXED_POINT : 0)
+    | (replay->useContinuousCollision ? REPLAY_FLAG_CONTINUOUS_COLLISION : 0);
+  bool success = fwrite(REPLAY_MAGIC, 1, strlen(REPLAY_MAGIC), file) == strlen(REPLAY_MAGIC)
+    && TryWriteU32(file, REPLAY_VERSION)
+    && TryWriteU32(file, replay->robotCount)
+    && TryWriteU32(file, replay->instructionsPerPhysicsStep)
+    && TryWriteU32(file, flags)
+    && TryWriteU64(file, replay->maxTicks)
+    && TryWriteU64(file, replay->stallWindowTicks)
+    && TryWriteU64(file, replay->tickCount)
+    && TryWriteU32(file, (uint32_t)replay->battleEndReason);
+
+  // Write the map, then go back and fill in its length now that it's known
+  long mapLengthPosition = ftell(file);
+  success = success && mapLengthPosition >= 0 && TryWriteU32(file, 0)
+    && TryWriteArenaMapBinary(&replay->map, file);
+  long mapEndPosition = ftell(file);
+  success = success && mapEndPosition >= 0
+    && fseek(file, mapLengthPosition, SEEK_SET) == 0
+    && TryWriteU32(file, (uint32_t)(mapEndPosition - mapLengthPosition - 4))
+    && fseek(file, mapEndPosition, SEEK_SET) == 0;
+
+  // Write the programs and controls
+  for (unsigned int i = 0; success && i < replay->robotCount; i++) {
+    size_t length = replay->programTexts[i] != NULL ? replay->programTextLengths[i] : 0;
+    success = TryWriteU32(file, (uint32_t)length)
+      && fwrite(replay->programTexts[i], 1, length, file) == length;
+  }
+  success = success && TryWriteU64(file, replay->controlStreamLength)
+    && fwrite(replay->controlStream, 1, replay->controlStreamLength, file) == replay->controlStreamLength;
+
+  return fclose(file) == 0 && success;
+}
+
+bool TryLoadReplay(const char* filePath, Replay* replayOut, const char** error) {
+  *replayOut = (Replay){ 0 };
+  *error = NULL;
+
+  FileBytes contents;
+  if (!TryReadAllBytes(filePath, &contents)) {
+    *error = REPLAY_FILE_UNREADABLE;
+    return false;
+  }
+
+  ByteReader reader = { .bytes = contents.bytes, .length = contents.length };
+  const uint8_t* magic;
+  if (!TryReadBytes(&reader, strlen(REPLAY_MAGIC), &magic) || memcmp(magic, REPLAY_MAGIC, strlen(REPLAY_MAGIC)) != 0) {
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_FILE_UNREADABLE;
+    return false;
+  }
+
+  // Read the header
+  uint32_t version, robotCount, instructionsPerPhysicsStep, flags, battleEndReason;
+  if (!TryReadU32(&reader, &version)) {
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_FILE_TRUNCATED;
+    return false;
+  }
+  if (version != REPLAY_VERSION) {
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_UNSUPPORTED_VERSION;
+    return false;
+  }
+  if (!TryReadU32(&reader, &robotCount) || !TryReadU32(&reader, &instructionsPerPhysicsStep)
+      || !TryReadU32(&reader, &flags) || !TryReadU64(&reader, &replayOut->maxTicks)
+      || !TryReadU64(&reader, &replayOut->stallWindowTicks) || !TryReadU64(&reader, &replayOut->tickCount)
+      || !TryReadU32(&reader, &battleEndReason)) {
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_FILE_TRUNCATED;
+    return false;
+  }
+  if (robotCount > SIMULATION_MAX_ROBOTS || battleEndReason > BATTLE_END_STALL) {
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_INVALID_SETTINGS;
+    return false;
+  }
+  replayOut->robotCount = robotCount;
+  replayOut->instructionsPerPhysicsStep = instructionsPerPhysicsStep;
+  replayOut->useFixedPoint = (flags & REPLAY_FLAG_FIXED_POINT) != 0;
+  replayOut->useContinuousCollision = (flags & REPLAY_FLAG_CONTINUOUS_COLLISION) != 0;
+  replayOut->battleEndReason = (BattleEndReason)battleEndReason;
+
+  // Read the map
+  uint32_t mapLength;
+  const uint8_t* mapBytes;
+  if (!TryReadU32(&reader, &mapLength) || !TryReadBytes(&reader, mapLength, &mapBytes)) {
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_FILE_TRUNCATED;
+    return false;
+  }
+  ArenaMapError mapError;
+  if (!TryReadArenaMapBinary(mapBytes, mapLength, &replayOut->map, &mapError)) {
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_INVALID_MAP;
+    return false;
+  }
+
+  // Read the programs
+  for (unsigned int i = 0; i < robotCount; i++) {
+    uint32_t textLength;
+    const uint8_t* textBytes;
+    if (!TryReadU32(&reader, &textLength) || !TryReadBytes(&reader, textLength, &textBytes)) {
+      DestroyReplay(replayOut);
+      ReleaseFileBytes(&contents);
+      *error = REPLAY_FILE_TRUNCATED;
+      return false;
+    }
+
+    replayOut->programTexts[i] = malloc(textLength + 1);
+    if (replayOut->programTexts[i] == NULL) {
+      DestroyReplay(replayOut);
+      ReleaseFileBytes(&contents);
+      *error = REPLAY_OUT_OF_MEMORY;
+      return false;
+    }
+    memcpy(replayOut->programTexts[i], textBytes, textLength);
+    replayOut->programTexts[i][textLength] = '\0';
+    replayOut->programTextLengths[i] = textLength;
+  }
+
+  // Read the controls
+  uint64_t streamLength;
+  const uint8_t* streamBytes;
+  if (!TryReadU64(&reader, &streamLength) || streamLength > SIZE_MAX
+      || !TryReadBytes(&reader, (size_t)streamLength, &streamBytes)) {
+    DestroyReplay(replayOut);
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_FILE_TRUNCATED;
+    return false;
+  }
+
+  replayOut->controlStream = malloc(streamLength > 0 ? (size_t)streamLength : 1);
+  if (replayOut->controlStream == NULL) {
+    DestroyReplay(replayOut);
+    ReleaseFileBytes(&contents);
+    *error = REPLAY_OUT_OF_MEMORY;
+    return false;
+  }
+  memcpy(replayOut->controlStream, streamBytes, (size_t)streamLength);
+  replayOut->controlStreamLength = (size_t)streamLength;
+  replayOut->controlStreamCapacity = (size_t)streamLength;
+
+  ReleaseFileBytes(&contents);
+  return true;
+}
+
+void ApplyReplayToSimulation(const Replay* replay, Simulation* simulation) {
+  simulation->instructionsPerPhysicsStep = replay->instructionsPerPhysicsStep;
+  simulation->maxTicks = replay->maxTicks;
+  simulation->stallWindowTicks = replay->stallWindowTicks;
+  simulation->physicsWorld.useFixedPoint = replay->useFixedPoint;
+  simulation->physicsWorld.useContinuousCollision = replay->useContinuousCollision;
+  ApplyArenaMapToSimulation(&replay->map, simulation);
+}
+
+ReplayRecorder InitReplayRecorder(Replay* replay) {
+  return (ReplayRecorder){ .replay = replay };
+}
+
+void RecordReplayTick(ReplayRecorder* recorder, const RobotControls* controls) {
+  Replay* replay = recorder->replay;
+  if (recorder->hasFailed) {
+    return;
+  }
+  replay->tickCount++;
+
+  // Find the control bytes that changed and by how much
+  uint8_t mask[(SIMULATION_MAX_ROBOTS * REPLAY_CONTROL_COUNT + 7) / 8] = { 0 };
+  uint8_t deltas[SIMULATION_MAX_ROBOTS * REPLAY_CONTROL_COUNT];
+  size_t deltaCount = 0;
+  for (unsigned int i = 0; i < replay->robotCount; i++) {
+    uint8_t lastBytes[REPLAY_CONTROL_COUNT], bytes[REPLAY_CONTROL_COUNT];
+    controlsToBytes(recorder->lastControls[i], lastBytes);
+    controlsToBytes(controls[i], bytes);
+    for (unsigned int k = 0; k < REPLAY_CONTROL_COUNT; k++) {
+      if (bytes[k] != lastBytes[k]) {
+        unsigned int bit = i * REPLAY_CONTROL_COUNT + k;
+        mask[bit / 8] |= 1 << (bit % 8);
+        deltas[deltaCount++] = (uint8_t)(bytes[k] - lastBytes[k]);
+      }
+    }
+  }
+  if (deltaCount == 0) {
+    recorder->unchangedTickCount++;
+    return;
+  }
+
+  // Make room for the change
+  if (replay->controlStreamCapacity - replay->controlStreamLength < REPLAY_MAX_CHANGE_LENGTH) {
+    size_t capacity = replay->controlStreamCapacity > 0 ? replay->controlStreamCapacity * 2 : REPLAY_INITIAL_STREAM_CAPACITY;
+    uint8_t* stream = realloc(replay->controlStream, capacity);
+    if (stream == NULL) {
+      recorder->hasFailed = true;
+      return;
+    }
+    replay->controlStream = stream;
+    replay->controlStreamCapacity = capacity;
+  }
+
+  // Write the number of unchanged steps before the change, then the mask and differences
+  uint8_t* out = &replay->controlStream[replay->controlStreamLength];
+  size_t length = writeReplayVarint(recorder->unchangedTickCount, out);
+  size_t maskLength = getControlMaskLength(replay->robotCount);
+  memcpy(&out[length], mask, maskLength);
+  length += maskLength;
+  memcpy(&out[length], deltas, deltaCount);
+  length += deltaCount;
+  replay->controlStreamLength += length;
+
+  for (unsigned int i = 0; i < replay->robotCount; i++) {
+    recorder->lastControls[i] = controls[i];
+  }
+  recorder->unchangedTickCount = 0;
+}
+
+void FinishReplayRecording(ReplayRecorder* recorder, const Simulation* simulation) {
+  recorder->replay->battleEndReason = simulation->battleEndReason;
+}
+
+ReplayPlayer InitReplayPlayer(const Replay* replay) {
+  return (ReplayPlayer){ .replay = replay };
+}
+
+void ReadReplayTick(ReplayPlayer* player, RobotControls* controlsOut) {
+  const Replay* replay = player->replay;
+  ByteReader reader = { .bytes = replay->controlStream, .length = replay->controlStreamLength, .offset = player->streamOffset };
+
+  if (!player->hasPendingChange && tryReadReplayVarint(&reader, &player->ticksUntilChange)) {
+    player->hasPendingChange = true;
+  }
+
+  if (player->hasPendingChange && player->ticksUntilChange > 0) {
+    player->ticksUntilChange--;
+  } else if (player->hasPendingChange) {
+    // Apply the differences to each of the control bytes in the mask
+    const uint8_t* mask;
+    size_t maskLength = getControlMaskLength(replay->robotCount);
+    if (TryReadBytes(&reader, maskLength, &mask)) {
+      for (unsigned int i = 0; i < replay->robotCount; i++) {
+        uint8_t bytes[REPLAY_CONTROL_COUNT];
+        controlsToBytes(player->controls[i], bytes);
+        for (unsigned int k = 0; k < REPLAY_CONTROL_COUNT; k++) {
+          unsigned int bit = i * REPLAY_CONTROL_COUNT + k;
+          const uint8_t* delta;
+          if ((mask[bit / 8] & (1 << (bit % 8))) && TryReadBytes(&reader, 1, &delta)) {
+            bytes[k] = (uint8_t)(bytes[k] + *delta);
+          }
+        }
+        player->controls[i] = controlsFromBytes(bytes);
+      }
+    }
+    player->hasPendingChange = false;
+  }
+
+  player->streamOffset = reader.offset;
+  for (unsigned int i = 0; i < replay->robotCount; i++) {
+    controlsOut[i] = player->controls[i];
+  }
+}
+
+
+size_t getControlMaskLength(unsigned int robotCount) {
+  return (robotCount * REPLAY_CONTROL_COUNT + 7) / 8;
+}
+
+void controlsToBytes(RobotControls controls, uint8_t* bytesOut) {
+  bytesOut[0] = controls.move;
+  bytesOut[1] = controls.rotate;
+  bytesOut[2] = controls.weapon;
+  bytesOut[3] = controls.sensorDirection;
+}
+
+RobotControls controlsFromBytes(const uint8_t* bytes) {
+  return (RobotControls){ .move = bytes[0], .rotate = bytes[1], .weapon = bytes[2], .sensorDirection = bytes[3] };
+}
+
+bool tryReadReplayVarint(ByteReader* reader, uint64_t* valueOut) {
+  uint64_t value = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7) {
+    const uint8_t* byte;
+    if (!TryReadBytes(reader, 1, &byte)) {
+      return false;
+    }
+    value |= (uint64_t)(*byte & 0x7F) << shift;
+    if ((*byte & 0x80) == 0) {
+      *valueOut = value;
+      return true;
+    }
+  }
+  return false;
+}
+
+size_t writeReplayVarint(uint64_t value, uint8_t* bytesOut) {
+  size_t length = 0;
+  while (value >= 0x80) {
+    bytesOut[length++] = (uint8_t)(value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  bytesOut[length++] = (uint8_t)value;
+  return length;
+}
@@ -1,16 +1,21 @@
 #include "arena/robot.h"
 #include <stdlib.h>
+#include <math.h>
 #include <raymath.h>
 #include <assert.h>
-#include "arena/raycast.h"
+#include "arena/fixed.h"
+#include "arena/trig.h"
 
 #define MOVE_ADDRESS       0xF000
 #define ROTATE_ADDRESS     0xF001
 #define WEAPON_ADDRESS     0xF002
 #define SENSOR_DIR_ADDRESS 0xF003
+#define SCAN_COUNT_ADDRESS 0xF004
 
 #define SENSOR_DIST_ADDRESS 0xE000
 #define SENSOR_KIND_ADDRESS 0xE001
+#define SCAN_DIST_ADDRESS   0xE100
+#define SCAN_KIND_ADDRESS   (SCAN_DIST_ADDRESS + ROBOT_SCAN_MAX_RAYS)
 
 #define MOVE_SPEED    300.0
 #define ROTATE_SPEED  6.0
@@ -23,10 +28,30 @@
 #define SENSORS_FOV_RAD (DEG2RAD * 90.0)
 #define MAX_SENSOR_DIST 500.0
 
+// Extra distance kept between a moved body and a cached sensor ray to absorb rounding error.
+#define SENSOR_CACHE_MARGIN 1.0
+
 #define MAX(a, b) ((a) > (b)) ? (a) : (b)
 #define MIN(a, b) ((a) < (b)) ? (a) : (b)
 
 
+// Computes a ray that starts just outside of a robot's body and points in the given direction relative to its
+// rotation, where the direction is given in 256ths of a full turn.
+void getRobotBodyRay(const PhysicsWorld* physicsWorld, const PhysicsBody* body, unsigned char relativeDirection, Vector2* originOut, Vector2* directionOut);
+
+// Checks whether a body's bounding circle comes within the cache margin of the first length units of a ray.
+bool checkBodyNearRaySegment(const PhysicsBody* body, Vector2 origin, Vector2 direction, float length);
+
+// Converts the result of a sensor raycast to the distance it covers, the body it detected, if any,
+// and the values written to sensor memory.
+void getSensorReadingValues(const PhysicsWorld* physicsWorld, RaycastResult result, float* distanceOut, int* detectedBodyIndexOut, unsigned char* distanceValueOut, unsigned char* kindValueOut);
+
+// Gets the direction of one of a scan's rays relative to the robot's rotation, in 256ths of a full turn.
+unsigned char getScanRayDirection(unsigned int rayIndex, unsigned int rayCount);
+// Marks the scan rays that a moved body could now block, skipping the rays whose line passes too far from it.
+void markScanRaysNearBody(const RobotScanCache* cache, const PhysicsBody* robotBody, const PhysicsBody* body, bool* isStale);
+
+
 Robot InitRobot(size_t physicsBodyIndex) {
   return (Robot){
     .physicsBodyIndex = physicsBodyIndex,
@@ -34,9 +59,26 @@ Robot InitRobot(size_t physicsBodyIndex) {
   };
 }
 
-void ApplyRobotControls(Robot* robot, PhysicsWorld* physicsWorld, WeaponDamageCallback weaponDamageCallback) {
+RobotControls ReadRobotControls(const Robot* robot) {
+  return (RobotControls){
+    .move = robot->processState.memory[MOVE_ADDRESS],
+    .rotate = robot->processState.memory[ROTATE_ADDRESS],
+    .weapon = robot->processState.memory[WEAPON_ADDRESS],
+    .sensorDirection = robot->processState.memory[SENSOR_DIR_ADDRESS],
+  };
+}
+
+void WriteRobotControls(Robot* robot, RobotControls controls) {
+  robot->processState.memory[MOVE_ADDRESS] = controls.move;
+  robot->processState.memory[ROTATE_ADDRESS] = controls.rotate;
+  robot->processState.memory[WEAPON_ADDRESS] = controls.weapon;
+  robot->processState.memory[SENSOR_DIR_ADDRESS] = controls.sensorDirection;
+}
+
+void ApplyRobotControls(Robot* robot, PhysicsWorld* physicsWorld, RobotControls controls, WeaponHit* weaponHitOut) {
   PhysicsBody* body = &physicsWorld->bodies[robot->physicsBodyIndex];
   assert(body->collider.kind == PHYSICS_COLLIDER_CIRCLE);
+  *weaponHitOut = (WeaponHit){ .isHit = false };
 
   if (robot->weaponCooldownRemaining > 0) {
     robot->weaponCooldownRemaining--;
@@ -49,28 +91,9 @@ void ApplyRobotControls(Robot* robot, PhysicsWorld* physicsWorld, WeaponDamageCa
     return;
   }
 
-  signed char moveControl = MAX((signed char)robot->processState.memory[MOVE_ADDRESS], -127);
-  signed char rotateControl = MAX((signed char)robot->processState.memory[ROTATE_ADDRESS], -127);
-  unsigned char weaponControl = robot->processState.memory[WEAPON_ADDRESS];
-
-  // Temporary user control code
-  if (robot->physicsBodyIndex == 0) {
-    if (IsKeyDown(KEY_UP)) {
-      moveControl = 127;
-    } else if (IsKeyDown(KEY_DOWN)) {
-      moveControl = -127;
-    }
-
-    if (IsKeyDown(KEY_RIGHT)) {
-      rotateControl = 127;
-    } else if (IsKeyDown(KEY_LEFT)) {
-      rotateControl = -127;
-    }
-
-    if (IsKeyDown(KEY_SPACE)) {
-      weaponControl = 255;
-    }
-  }
+  signed char moveControl = MAX((signed char)controls.move, -127);
+  signed char rotateControl = MAX((signed char)controls.rotate, -127);
+  unsigned char weaponControl = controls.weapon;
 
   robot->energyRemaining -= abs(moveControl) * MOVE_COST;
   robot->energyRemaining -= abs(rotateControl) * ROTATE_COST;
@@ -82,36 +105,215 @@ void ApplyRobotControls(Robot* robot, PhysicsWorld* physicsWorld, WeaponDamageCa
     robot->weaponCooldownRemaining = ROBOT_WEAPON_COOLDOWN_STEPS;
   }
 
-  double moveVelocity = MOVE_SPEED * (moveControl / 127.0);
-  body->linearVelocity = (Vector2){ cos(body->rotation) * moveVelocity, sin(body->rotation) * moveVelocity };
-  body->angularVelocity = ROTATE_SPEED * (rotateControl / 127.0);
+  if (physicsWorld->useFixedPoint) {
+    Fixed moveVelocity = (Fixed)((int64_t)FixedFromFloat(MOVE_SPEED) * moveControl / 127);
+    Fixed rotation = FixedFromFloat(body->rotation);
+    body->linearVelocity = (Vector2){
+      FixedToFloat(FixedMul(FixedCos(rotation), moveVelocity)),
+      FixedToFloat(FixedMul(FixedSin(rotation), moveVelocity))
+    };
+    body->angularVelocity = FixedToFloat((Fixed)((int64_t)FixedFromFloat(ROTATE_SPEED) * rotateControl / 127));
+  } else {
+    double moveVelocity = MOVE_SPEED * (moveControl / 127.0);
+    float sinRotation, cosRotation;
+    FastSinCos(body->rotation, &sinRotation, &cosRotation);
+    body->linearVelocity = (Vector2){ cosRotation * moveVelocity, sinRotation * moveVelocity };
+    body->angularVelocity = ROTATE_SPEED * (rotateControl / 127.0);
+  }
 
   if (weaponControl > 0) {
     // Fire laser at other robots using a raycast.
-    Vector2 rayDirection = (Vector2){ cos(body->rotation), sin(body->rotation) };
-    Vector2 rayOrigin = Vector2Add(body->position, Vector2Scale(rayDirection, body->collider.radius + 1));
+    Vector2 rayOrigin, rayDirection;
+    getRobotBodyRay(physicsWorld, body, 0, &rayOrigin, &rayDirection);
     RaycastResult result = ComputeRaycast(physicsWorld, rayOrigin, rayDirection);
     if (result.type != INTERSECTION_NONE) {
       robot->lastWeaponFire.start = rayOrigin;
       robot->lastWeaponFire.end = Vector2Add(rayOrigin, Vector2Scale(rayDirection, result.distance));
       
       if (result.type == INTERSECTION_BODY && result.bodyIndex >= 0) {
-        weaponDamageCallback.func(weaponDamageCallback.context, result.bodyIndex, weaponControl * WEAPON_DAMAGE);
+        *weaponHitOut = (WeaponHit){
+          .isHit = true,
+          .physicsBodyIndex = result.bodyIndex,
+          .damageAmount = weaponControl * WEAPON_DAMAGE,
+        };
       }
     }
   }
 }
 
 void UpdateRobotSensor(Robot* robot, PhysicsWorld* physicsWorld) {
-  PhysicsBody* body = &physicsWorld->bodies[robot->physicsBodyIndex];
+  if (!TryReuseRobotSensorReading(robot, physicsWorld)) {
+    Vector2 rayOrigin, rayDirection;
+    GetRobotSensorRay(robot, physicsWorld, &rayOrigin, &rayDirection);
+    RaycastResult result = ComputeRaycast(physicsWorld, rayOrigin, rayDirection);
+    ApplyRobotSensorReading(robot, physicsWorld, rayOrigin, rayDirection, result);
+  }
+
+  unsigned char rayIndices[ROBOT_SCAN_MAX_RAYS];
+  Vector2 rayOrigins[ROBOT_SCAN_MAX_RAYS], rayDirections[ROBOT_SCAN_MAX_RAYS];
+  RaycastResult results[ROBOT_SCAN_MAX_RAYS];
+  size_t rayCount = GetRobotScanRays(robot, physicsWorld, rayIndices, rayOrigins, rayDirections);
+  ComputeRaycastBatch(physicsWorld, rayCount, rayOrigins, rayDirections, results);
+  ApplyRobotScanReadings(robot, physicsWorld, rayCount, rayIndices, rayOrigins, rayDirections, results);
+}
+
+void GetRobotSensorRay(const Robot* robot, const PhysicsWorld* physicsWorld, Vector2* originOut, Vector2* directionOut) {
+  const PhysicsBody* body = &physicsWorld->bodies[robot->physicsBodyIndex];
   assert(body->collider.kind == PHYSICS_COLLIDER_CIRCLE);
 
   unsigned char sensorDirectionControl = robot->processState.memory[SENSOR_DIR_ADDRESS];
-  float sensorAngle = body->rotation + (sensorDirectionControl / 256.0) * (2 * M_PI);
+  getRobotBodyRay(physicsWorld, body, sensorDirectionControl, originOut, directionOut);
+}
+
+bool TryReuseRobotSensorReading(Robot* robot, const PhysicsWorld* physicsWorld) {
+  if (!robot->sensorCache.isValid || robot->processState.memory[SENSOR_DIR_ADDRESS] != robot->sensorCache.sensorDirection) {
+    return false;
+  }
+
+  if (physicsWorld->version != robot->sensorCache.worldVersion) {
+    for (unsigned int i = 0; i < physicsWorld->bodyCount; i++) {
+      if (physicsWorld->bodyVersions[i] <= robot->sensorCache.worldVersion) {
+        continue; // Body hasn't moved since the reading
+      }
+
+      // The reading must be redone if the robot itself, the detected body, or any body that
+      // could now be in front of the detected point has moved.
+      if (i == robot->physicsBodyIndex || (int)i == robot->sensorCache.detectedBodyIndex ||
+          checkBodyNearRaySegment(&physicsWorld->bodies[i], robot->sensorCache.rayOrigin, robot->sensorCache.rayDirection, robot->sensorCache.relevantDistance)) {
+        return false;
+      }
+    }
+    robot->sensorCache.worldVersion = physicsWorld->version;
+  }
+
+  // The program may have overwritten the sensor memory since the last reading
+  robot->processState.memory[SENSOR_DIST_ADDRESS] = robot->sensorCache.distanceValue;
+  robot->processState.memory[SENSOR_KIND_ADDRESS] = robot->sensorCache.kindValue;
+  return true;
+}
+
+void ApplyRobotSensorReading(Robot* robot, const PhysicsWorld* physicsWorld, Vector2 rayOrigin, Vector2 rayDirection, RaycastResult result) {
+  float distance;
+  int detectedBodyIndex;
+  unsigned char distanceValue, kindValue;
+  getSensorReadingValues(physicsWorld, result, &distance, &detectedBodyIndex, &distanceValue, &kindValue);
+
+  robot->lastSensorReading.start = rayOrigin;
+  robot->lastSensorReading.end = Vector2Add(rayOrigin, Vector2Scale(rayDirection, distance));
+  robot->processState.memory[SENSOR_DIST_ADDRESS] = distanceValue;
+  robot->processState.memory[SENSOR_KIND_ADDRESS] = kindValue;
+
+  robot->sensorCache = (RobotSensorCache){
+    .isValid = true,
+    .worldVersion = physicsWorld->version,
+    .sensorDirection = robot->processState.memory[SENSOR_DIR_ADDRESS],
+    .rayOrigin = rayOrigin,
+    .rayDirection = rayDirection,
+    .relevantDistance = distance,
+    .detectedBodyIndex = detectedBodyIndex,
+    .distanceValue = distanceValue,
+    .kindValue = kindValue,
+  };
+}
+
+size_t GetRobotScanRays(Robot* robot, const PhysicsWorld* physicsWorld, unsigned char* rayIndicesOut, Vector2* originsOut, Vector2* directionsOut) {
+  RobotScanCache* cache = &robot->scanCache;
+  const PhysicsBody* body = &physicsWorld->bodies[robot->physicsBodyIndex];
+  unsigned int rayCount = MIN(robot->processState.memory[SCAN_COUNT_ADDRESS], ROBOT_SCAN_MAX_RAYS);
+  if (rayCount == 0) {
+    cache->isValid = false;
+    return 0;
+  }
+
+  // Every ray must be cast if the robot itself has moved, since every ray starts from it
+  bool isStale[ROBOT_SCAN_MAX_RAYS] = { 0 };
+  if (!cache->isValid || cache->rayCount != rayCount || physicsWorld->bodyVersions[robot->physicsBodyIndex] > cache->worldVersion) {
+    for (unsigned int k = 0; k < rayCount; k++) {
+      isStale[k] = true;
+    }
+  } else if (physicsWorld->version != cache->worldVersion) {
+    // Otherwise, only the rays that detected a moved body or that a moved body could now block must be cast
+    for (unsigned int i = 0; i < physicsWorld->bodyCount; i++) {
+      if (physicsWorld->bodyVersions[i] <= cache->worldVersion) {
+        continue; // Body hasn't moved since the scan
+      }
+      for (unsigned int k = 0; k < rayCount; k++) {
+        if (cache->detectedBodyIndices[k] == (int)i) {
+          isStale[k] = true;
+        }
+      }
+      markScanRaysNearBody(cache, body, &physicsWorld->bodies[i], isStale);
+    }
+  }
+  cache->isValid = true;
+  cache->worldVersion = physicsWorld->version;
+  cache->rayCount = (unsigned char)rayCount;
+
+  // Output the rays to cast, and rewrite the other readings since the program may have overwritten them
+  size_t staleRayCount = 0;
+  for (unsigned int k = 0; k < rayCount; k++) {
+    if (isStale[k]) {
+      rayIndicesOut[staleRayCount] = (unsigned char)k;
+      getRobotBodyRay(physicsWorld, body, getScanRayDirection(k, rayCount), &originsOut[staleRayCount], &directionsOut[staleRayCount]);
+      staleRayCount++;
+    } else {
+      robot->processState.memory[SCAN_DIST_ADDRESS + k] = cache->distanceValues[k];
+      robot->processState.memory[SCAN_KIND_ADDRESS + k] = cache->kindValues[k];
+    }
+  }
+  return staleRayCount;
+}
+
+void ApplyRobotScanReadings(Robot* robot, const PhysicsWorld* physicsWorld, size_t rayCount, const unsigned char* rayIndices, const Vector2* origins, const Vector2* directions, const RaycastResult* results) {
+  RobotScanCache* cache = &robot->scanCache;
+  for (size_t i = 0; i < rayCount; i++) {
+    unsigned int k = rayIndices[i];
+    float distance;
+    int detectedBodyIndex;
+    unsigned char distanceValue, kindValue;
+    getSensorReadingValues(physicsWorld, results[i], &distance, &detectedBodyIndex, &distanceValue, &kindValue);
+
+    cache->rayOrigins[k] = origins[i];
+    cache->rayDirections[k] = directions[i];
+    cache->relevantDistances[k] = distance;
+    cache->detectedBodyIndices[k] = detectedBodyIndex;
+    cache->distanceValues[k] = distanceValue;
+    cache->kindValues[k] = kindValue;
+    robot->processState.memory[SCAN_DIST_ADDRESS + k] = distanceValue;
+    robot->processState.memory[SCAN_KIND_ADDRESS + k] = kindValue;
+  }
+}
 
-  Vector2 rayDirection = (Vector2){ cos(sensorAngle), sin(sensorAngle) };
-  Vector2 rayOrigin = Vector2Add(body->position, Vector2Scale(rayDirection, body->collider.radius + 1));
-  RaycastResult result = ComputeRaycast(physicsWorld, rayOrigin, rayDirection);
+
+void getRobotBodyRay(const PhysicsWorld* physicsWorld, const PhysicsBody* body, unsigned char relativeDirection, Vector2* originOut, Vector2* directionOut) {
+  if (physicsWorld->useFixedPoint) {
+    Fixed angle = FixedFromFloat(body->rotation) + (Fixed)((int64_t)FIXED_TWO_PI * relativeDirection / 256);
+    FixedVector2 direction = { FixedCos(angle), FixedSin(angle) };
+    FixedVector2 origin = FixedVector2Add(
+      FixedVector2FromFloat(body->position.x, body->position.y),
+      FixedVector2Scale(direction, FixedFromFloat(body->collider.radius + 1)));
+
+    *directionOut = (Vector2){ FixedToFloat(direction.x), FixedToFloat(direction.y) };
+    *originOut = (Vector2){ FixedToFloat(origin.x), FixedToFloat(origin.y) };
+    return;
+  }
+
+  float sinAngle, cosAngle;
+  FastSinCosWithDirection(body->rotation, relativeDirection, &sinAngle, &cosAngle);
+  *directionOut = (Vector2){ cosAngle, sinAngle };
+  *originOut = Vector2Add(body->position, Vector2Scale(*directionOut, body->collider.radius + 1));
+}
+
+bool checkBodyNearRaySegment(const PhysicsBody* body, Vector2 origin, Vector2 direction, float length) {
+  float boundingRadius = GetPhysicsBodyBoundingRadius(body);
+  Vector2 relativePosition = Vector2Subtract(body->position, origin);
+  float projectedDistanceAlongRay = Clamp(Vector2DotProduct(relativePosition, direction), 0, length);
+  Vector2 nearestPoint = Vector2Scale(direction, projectedDistanceAlongRay);
+  float maxDistance = boundingRadius + SENSOR_CACHE_MARGIN;
+  return Vector2LengthSqr(Vector2Subtract(relativePosition, nearestPoint)) <= maxDistance * maxDistance;
+}
+
+void getSensorReadingValues(const PhysicsWorld* physicsWorld, RaycastResult result, float* distanceOut, int* detectedBodyIndexOut, unsigned char* distanceValueOut, unsigned char* kindValueOut) {
   float distance = result.distance;
   IntersectionType type = result.type;
   if (distance > MAX_SENSOR_DIST) {
@@ -119,24 +321,49 @@ void UpdateRobotSensor(Robot* robot, PhysicsWorld* physicsWorld) {
     type = INTERSECTION_NONE;
   }
 
-  unsigned char kindValue;
   switch (type) {
-    case INTERSECTION_NONE: {
-      kindValue = 0;
+    case INTERSECTION_NONE:
+    default: {
+      *kindValueOut = 0;
       break;
     }
     case INTERSECTION_BODY: {
-      kindValue = physicsWorld->bodies[result.bodyIndex].isStatic ? 2 : 1;
+      *kindValueOut = physicsWorld->bodies[result.bodyIndex].isStatic ? 2 : 1;
       break;
     }
     case INTERSECTION_BOUNDARY: {
-      kindValue = 2;
+      *kindValueOut = 2;
       break;
     }
   }
 
-  robot->lastSensorReading.start = rayOrigin;
-  robot->lastSensorReading.end = Vector2Add(rayOrigin, Vector2Scale(rayDirection, distance));
-  robot->processState.memory[SENSOR_DIST_ADDRESS] = (unsigned char)(distance / MAX_SENSOR_DIST * 255.0);
-  robot->processState.memory[SENSOR_KIND_ADDRESS] = kindValue;
+  *distanceOut = distance;
+  *detectedBodyIndexOut = type == INTERSECTION_BODY ? result.bodyIndex : -1;
+  if (physicsWorld->useFixedPoint) {
+    *distanceValueOut = (unsigned char)((int64_t)FixedFromFloat(distance) * 255 / FixedFromFloat(MAX_SENSOR_DIST));
+  } else {
+    *distanceValueOut = (unsigned char)(distance / MAX_SENSOR_DIST * 255.0);
+  }
+}
+
+unsigned char getScanRayDirection(unsigned int rayIndex, unsigned int rayCount) {
+  return (unsigned char)(rayIndex * 256 / rayCount);
+}
+
+void markScanRaysNearBody(const RobotScanCache* cache, const PhysicsBody* robotBody, const PhysicsBody* body, bool* isStale) {
+  // Every ray points straight out from the robot's center, so the cross product with a ray's direction gives the
+  // body's distance from the ray's line and the dot product tells whether the body is behind the robot. Either one
+  // rules out most rays before the full check against the ray's segment.
+  Vector2 relativePosition = Vector2Subtract(body->position, robotBody->position);
+  float maxDistance = GetPhysicsBodyBoundingRadius(body) + SENSOR_CACHE_MARGIN;
+  for (unsigned int k = 0; k < cache->rayCount; k++) {
+    Vector2 direction = cache->rayDirections[k];
+    float lineDistance = fabsf(direction.x * relativePosition.y - direction.y * relativePosition.x);
+    if (isStale[k] || lineDistance > maxDistance || Vector2DotProduct(direction, relativePosition) < -maxDistance) {
+      continue;
+    }
+    if (checkBodyNearRaySegment(body, cache->rayOrigins[k], direction, cache->relevantDistances[k])) {
+      isStale[k] = true;
+    }
+  }
 }
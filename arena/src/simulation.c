@@ -2,12 +2,18 @@
 #include <math.h>
 #include <time.h>
 #include <limits.h>
+#include <string.h>
 #include <raylib.h>
 #include <raymath.h>
 #include "arena/raycast.h"
+#include "arena/replay.h"
+#include "arena/timeline.h"
 #include "utilities/sleep.h"
 #if defined(PLATFORM_WEB)
 #include "emscripten.h"
+#else
+#include "arena/thread_pool.h"
+#define USE_SIMULATION_THREAD_POOL
 #endif
 
 
@@ -16,9 +22,49 @@
 #define MAX(a, b) ((a) > (b)) ? (a) : (b)
 #define MIN(a, b) ((a) < (b)) ? (a) : (b)
 
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME        1099511628211ULL
 
-void stepSimulation(Simulation* simulation);
-void onWeaponDamage(void* context, size_t physicsBodyIndex, int damageAmount);
+
+// A phase of a simulation step that can be run independently for each robot in [startIndex, endIndex).
+typedef void (*RobotPhaseFunc)(Simulation* simulation, size_t startIndex, size_t endIndex);
+
+// A per-robot phase being run as a batch of tasks.
+typedef struct {
+  Simulation* simulation;
+  RobotPhaseFunc phaseFunc;
+  size_t robotsPerTask;
+} RobotPhaseTasks;
+
+
+// Runs a per-robot phase for all robots in tasks of robotsPerTask robots, using the thread pool if there is one.
+// Returns once the phase has finished for every robot.
+void runRobotPhase(Simulation* simulation, RobotPhaseFunc phaseFunc);
+void runRobotPhaseTask(void* context, size_t taskIndex);
+
+// Ends the battle if one or fewer robots are left standing, the tick limit is reached or the battle has stalled.
+void checkBattleEnd(Simulation* simulation);
+// Ends the battle in favor of the robot with the most energy remaining, or as a draw if the most energy is shared.
+void endBattleByEnergy(Simulation* simulation, BattleEndReason reason);
+// Returns whether robot poses and energy have stayed the same for the whole stall window, and the rest of the robots'
+// state is the same at both of its ends.
+bool checkBattleStalled(Simulation* simulation);
+uint64_t hashRobotPosesAndEnergy(const Simulation* simulation);
+// Hashes the robot state that poses and energy leave out but that affects later steps: each robot's processor
+// registers and memory, weapon cooldown and the velocity of its body.
+uint64_t hashRobotState(const Simulation* simulation);
+uint64_t hashBytes(uint64_t hash, const void* bytes, size_t byteCount);
+
+void stepRobotProcesses(Simulation* simulation, size_t startIndex, size_t endIndex);
+void applyRobotControls(Simulation* simulation, size_t startIndex, size_t endIndex);
+// Overrides a robot's controls with the keyboard, which is recorded in replays like any other control.
+void applyUserControls(const Robot* robot, unsigned int heldUserKeys, RobotControls* controls);
+void updateRobotSensors(Simulation* simulation, size_t startIndex, size_t endIndex);
+
+// Applies the damage from every weapon hit made during the current step. Robots hit by several weapons take the
+// damage of each, regardless of the order of the hits. Only robots with energy left after paying for their controls
+// take damage.
+void resolveWeaponHits(Simulation* simulation);
 
 
 void AddRobotToSimulation(Simulation* simulation, Vector2 position, float rotation) {
@@ -34,10 +80,12 @@ void AddRobotToSimulation(Simulation* simulation, Vector2 position, float rotati
       .radius = ROBOT_RADIUS,
     }
   };
+  MarkPhysicsBodyChanged(&simulation->physicsWorld, bodyIndex);
 
   size_t robotIndex = simulation->robotCount;
   simulation->robotCount++;
   simulation->robots[robotIndex] = InitRobot(bodyIndex);
+  simulation->robotIndicesByBody[bodyIndex] = (int)robotIndex;
 }
 
 void AddObstacleToSimulation(Simulation* simulation, Vector2 position, float rotation, PhysicsCollider collider) {
@@ -51,53 +99,202 @@ void AddObstacleToSimulation(Simulation* simulation, Vector2 position, float rot
     .rotation = rotation,
     .collider = collider,
   };
+  MarkPhysicsBodyChanged(&simulation->physicsWorld, bodyIndex);
+  simulation->robotIndicesByBody[bodyIndex] = -1;
 }
 
 void PrepSimulation(Simulation* simulation) {
-  for (unsigned int i = 0; i < simulation->robotCount; i++) {
-    UpdateRobotSensor(&simulation->robots[i], &simulation->physicsWorld);
+  if (simulation->physicsWorld.useStaticDistanceField && !simulation->physicsWorld.staticDistanceField.isBaked) {
+    BakePhysicsDistanceField(&simulation->physicsWorld);
   }
+  runRobotPhase(simulation, updateRobotSensors);
+
+  simulation->stallWindowStartTick = simulation->tickCount;
+  simulation->stallPoseEnergyHash = hashRobotPosesAndEnergy(simulation);
+  simulation->isStallStateHashValid = true;
+  simulation->stallStateHash = hashRobotState(simulation);
 }
 
 void UpdateSimulation(Simulation* simulation) {
-  int64_t elapsedTicks = GetTimerTicks(&simulation->timer);
-  if (simulation->forceStep) {
-    simulation->forceStep = false;
-    stepSimulation(simulation);
+  int64_t elapsedTicks = GetTimerTicks(&simulation->host.timer);
+  if (simulation->host.forceStep) {
+    simulation->host.forceStep = false;
+    StepSimulation(simulation);
   }
-  if (elapsedTicks > 0) {
+  if (simulation->host.timer.ticksPerSec == SIMULATION_MAX_SPEED_TICKS_PER_SECOND && simulation->host.timer.source.kind != TIME_SOURCE_VIRTUAL) {
+    // Step for a slice of time rather than a number of ticks, so that the caller's overhead between updates is
+    // spread over as many steps as the machine can run
+    int64_t sliceNanoseconds = simulation->host.maxSpeedSliceNanoseconds > 0 ? simulation->host.maxSpeedSliceNanoseconds : SIMULATION_DEFAULT_MAX_SPEED_SLICE_NANOSECONDS;
+    int64_t sliceEndTime = ReadTimeSource(&simulation->host.timer.source) + sliceNanoseconds;
+    do {
+      StepSimulation(simulation);
+    } while (ReadTimeSource(&simulation->host.timer.source) < sliceEndTime);
+    AddTimerTicks(&simulation->host.timer, -elapsedTicks);
+  } else if (elapsedTicks > 0) {
     for (int64_t i = 0; i < elapsedTicks; i++) {
-      stepSimulation(simulation);
+      StepSimulation(simulation);
     }
-    AddTimerTicks(&simulation->timer, -elapsedTicks);
+    AddTimerTicks(&simulation->host.timer, -elapsedTicks);
   }
 }
 
 
-void stepSimulation(Simulation* simulation) {
+void StepSimulation(Simulation* simulation) {
   PhysicsWorld* physicsWorld = &simulation->physicsWorld;
 
-  // Step robot processes
-  for (unsigned int i = 0; i < simulation->robotCount; i++) {
+  // Take a keyframe of the state before this step, if it's due
+  if (simulation->host.timeline != NULL && simulation->tickCount % simulation->host.timeline->intervalTicks == 0) {
+    CaptureTimelineKeyframe(simulation->host.timeline, simulation);
+  }
+
+  // Step robot processes, or write the recorded controls in their place when playing back a replay
+  if (simulation->host.replayPlayer != NULL) {
+    RobotControls controls[SIMULATION_MAX_ROBOTS];
+    ReadReplayTick(simulation->host.replayPlayer, controls);
+    for (size_t i = 0; i < simulation->robotCount; i++) {
+      WriteRobotControls(&simulation->robots[i], controls[i]);
+    }
+  } else {
+    runRobotPhase(simulation, stepRobotProcesses);
+  }
+
+  // Apply robot controls, then the damage from any weapon hits once every robot has fired
+  runRobotPhase(simulation, applyRobotControls);
+  resolveWeaponHits(simulation);
+  if (simulation->host.replayRecorder != NULL) {
+    RecordReplayTick(simulation->host.replayRecorder, simulation->robotControls);
+  }
+
+  // Step physics world once every instructionsPerPhysicsStep steps
+  unsigned int instructionsPerPhysicsStep = MAX(simulation->instructionsPerPhysicsStep, 1);
+  if ((simulation->tickCount + 1) % instructionsPerPhysicsStep == 0) {
+    StepPhysicsWorld(physicsWorld, DELTA_TIME_SEC * instructionsPerPhysicsStep);
+  }
+
+  // Update robot sensors
+  runRobotPhase(simulation, updateRobotSensors);
+
+  simulation->tickCount++;
+  if (!simulation->battleEnded) {
+    checkBattleEnd(simulation);
+  }
+}
+
+void ReplaceSimulationBattle(Simulation* simulation, const Simulation* battle) {
+  SimulationHost host = simulation->host;
+  if (battle != NULL) {
+    *simulation = *battle;
+  } else {
+    memset(simulation, 0x00, sizeof(Simulation));
+  }
+  simulation->host = host;
+}
+
+void runRobotPhase(Simulation* simulation, RobotPhaseFunc phaseFunc) {
+  size_t robotsPerTask = simulation->host.robotsPerTask > 0 ? simulation->host.robotsPerTask : SIMULATION_DEFAULT_ROBOTS_PER_TASK;
+  size_t taskCount = (simulation->robotCount + robotsPerTask - 1) / robotsPerTask;
+  RobotPhaseTasks tasks = { simulation, phaseFunc, robotsPerTask };
+
+  #ifdef USE_SIMULATION_THREAD_POOL
+  if (simulation->host.threadPool != NULL && taskCount > 1) {
+    RunThreadPoolTasks(simulation->host.threadPool, taskCount, runRobotPhaseTask, &tasks);
+    return;
+  }
+  #endif
+
+  for (size_t i = 0; i < taskCount; i++) {
+    runRobotPhaseTask(&tasks, i);
+  }
+}
+
+void runRobotPhaseTask(void* context, size_t taskIndex) {
+  RobotPhaseTasks* tasks = context;
+  size_t startIndex = taskIndex * tasks->robotsPerTask;
+  size_t endIndex = MIN(startIndex + tasks->robotsPerTask, tasks->simulation->robotCount);
+  tasks->phaseFunc(tasks->simulation, startIndex, endIndex);
+}
+
+void stepRobotProcesses(Simulation* simulation, size_t startIndex, size_t endIndex) {
+  for (size_t i = startIndex; i < endIndex; i++) {
     if (simulation->robots[i].energyRemaining > 0) {
       stepProcess(&simulation->robots[i].processState);
     }
   }
+}
 
-  // Apply robot controls
-  for (unsigned int i = 0; i < simulation->robotCount; i++) {
-    ApplyRobotControls(&simulation->robots[i], &simulation->physicsWorld, (WeaponDamageCallback){ simulation, onWeaponDamage });
+void applyRobotControls(Simulation* simulation, size_t startIndex, size_t endIndex) {
+  for (size_t i = startIndex; i < endIndex; i++) {
+    RobotControls controls = ReadRobotControls(&simulation->robots[i]);
+    if (simulation->host.replayPlayer == NULL) {
+      applyUserControls(&simulation->robots[i], simulation->host.heldUserKeys, &controls);
+    }
+    simulation->robotControls[i] = controls;
+    ApplyRobotControls(&simulation->robots[i], &simulation->physicsWorld, controls, &simulation->weaponHits[i]);
   }
+}
 
-  // Step physics world
-  StepPhysicsWorld(physicsWorld, DELTA_TIME_SEC);
+void applyUserControls(const Robot* robot, unsigned int heldUserKeys, RobotControls* controls) {
+  // Temporary user control code
+  if (robot->physicsBodyIndex == 0) {
+    if (heldUserKeys & SIMULATION_USER_KEY_FORWARD) {
+      controls->move = 127;
+    } else if (heldUserKeys & SIMULATION_USER_KEY_BACKWARD) {
+      controls->move = (unsigned char)-127;
+    }
 
-  // Update robot sensors
-  for (unsigned int i = 0; i < simulation->robotCount; i++) {
-    UpdateRobotSensor(&simulation->robots[i], &simulation->physicsWorld);
+    if (heldUserKeys & SIMULATION_USER_KEY_RIGHT) {
+      controls->rotate = 127;
+    } else if (heldUserKeys & SIMULATION_USER_KEY_LEFT) {
+      controls->rotate = (unsigned char)-127;
+    }
+
+    if (heldUserKeys & SIMULATION_USER_KEY_FIRE) {
+      controls->weapon = 255;
+    }
   }
+}
 
-  // Check if there is only one robot left alive
+void updateRobotSensors(Simulation* simulation, size_t startIndex, size_t endIndex) {
+  // Gather the sensor and scan rays of robots whose previous readings can't be reused
+  size_t rayCount = 0;
+  size_t sensorRayCount = 0;
+  size_t robotIndices[SIMULATION_MAX_ROBOTS];
+  size_t scanRayStarts[SIMULATION_MAX_ROBOTS], scanRayCounts[SIMULATION_MAX_ROBOTS];
+  unsigned char scanRayIndices[SIMULATION_MAX_ROBOTS * ROBOT_SCAN_MAX_RAYS];
+  Vector2 rayOrigins[SIMULATION_MAX_ROBOTS * (1 + ROBOT_SCAN_MAX_RAYS)] = { 0 };
+  Vector2 rayDirections[SIMULATION_MAX_ROBOTS * (1 + ROBOT_SCAN_MAX_RAYS)] = { 0 };
+  RaycastResult results[SIMULATION_MAX_ROBOTS * (1 + ROBOT_SCAN_MAX_RAYS)];
+  for (size_t i = startIndex; i < endIndex; i++) {
+    if (!TryReuseRobotSensorReading(&simulation->robots[i], &simulation->physicsWorld)) {
+      robotIndices[sensorRayCount++] = i;
+      GetRobotSensorRay(&simulation->robots[i], &simulation->physicsWorld, &rayOrigins[rayCount], &rayDirections[rayCount]);
+      rayCount++;
+    }
+  }
+  size_t scanRayCount = 0;
+  for (size_t i = startIndex; i < endIndex; i++) {
+    scanRayStarts[i - startIndex] = rayCount;
+    scanRayCounts[i - startIndex] = GetRobotScanRays(&simulation->robots[i], &simulation->physicsWorld,
+      &scanRayIndices[scanRayCount], &rayOrigins[rayCount], &rayDirections[rayCount]);
+    rayCount += scanRayCounts[i - startIndex];
+    scanRayCount += scanRayCounts[i - startIndex];
+  }
+
+  // Cast all remaining rays in a single batch
+  ComputeRaycastBatch(&simulation->physicsWorld, rayCount, rayOrigins, rayDirections, results);
+
+  for (size_t k = 0; k < sensorRayCount; k++) {
+    ApplyRobotSensorReading(&simulation->robots[robotIndices[k]], &simulation->physicsWorld, rayOrigins[k], rayDirections[k], results[k]);
+  }
+  for (size_t i = startIndex; i < endIndex; i++) {
+    size_t start = scanRayStarts[i - startIndex];
+    ApplyRobotScanReadings(&simulation->robots[i], &simulation->physicsWorld, scanRayCounts[i - startIndex],
+      &scanRayIndices[start - sensorRayCount], &rayOrigins[start], &rayDirections[start], &results[start]);
+  }
+}
+
+void checkBattleEnd(Simulation* simulation) {
+  // Check if there is one or no robot left alive
   size_t numRobotsAlive = 0;
   size_t lastSurvivingRobotIndex = 0;
   for (unsigned int i = 0; i < simulation->robotCount && numRobotsAlive < 2; i++) {
@@ -106,26 +303,130 @@ void stepSimulation(Simulation* simulation) {
       lastSurvivingRobotIndex = i;
     }
   }
-  if (numRobotsAlive == 1) {
+  if (numRobotsAlive <= 1) {
     simulation->battleEnded = true;
-    simulation->lastSurvivingRobotIndex = lastSurvivingRobotIndex;
+    simulation->battleEndReason = BATTLE_END_ELIMINATION;
+    simulation->battleDrawn = numRobotsAlive == 0;
+    simulation->winningRobotIndex = lastSurvivingRobotIndex;
+    return;
+  }
+
+  if (simulation->maxTicks > 0 && simulation->tickCount >= simulation->maxTicks) {
+    endBattleByEnergy(simulation, BATTLE_END_TICK_LIMIT);
+    return;
+  }
+
+  // Robot memory isn't simulated during playback, so a stall is taken from the recorded outcome instead
+  if (simulation->host.replayPlayer != NULL) {
+    const Replay* replay = simulation->host.replayPlayer->replay;
+    if (replay->battleEndReason == BATTLE_END_STALL && simulation->tickCount >= replay->tickCount) {
+      endBattleByEnergy(simulation, BATTLE_END_STALL);
+    }
+  } else if (simulation->stallWindowTicks > 0 && checkBattleStalled(simulation)) {
+    endBattleByEnergy(simulation, BATTLE_END_STALL);
+  }
+}
+
+void endBattleByEnergy(Simulation* simulation, BattleEndReason reason) {
+  size_t winningRobotIndex = 0;
+  bool isTied = false;
+  for (unsigned int i = 1; i < simulation->robotCount; i++) {
+    int energy = simulation->robots[i].energyRemaining;
+    int winningEnergy = simulation->robots[winningRobotIndex].energyRemaining;
+    if (energy > winningEnergy) {
+      winningRobotIndex = i;
+      isTied = false;
+    } else if (energy == winningEnergy) {
+      isTied = true;
+    }
   }
+
+  simulation->battleEnded = true;
+  simulation->battleEndReason = reason;
+  simulation->battleDrawn = isTied;
+  simulation->winningRobotIndex = winningRobotIndex;
 }
 
-void onWeaponDamage(void* context, size_t physicsBodyIndex, int damageAmount) {
-  Simulation* simulation = context;
+bool checkBattleStalled(Simulation* simulation) {
+  // Poses and energy are cheap to hash, so any change to them restarts the window immediately.
+  uint64_t poseEnergyHash = hashRobotPosesAndEnergy(simulation);
+  if (poseEnergyHash != simulation->stallPoseEnergyHash) {
+    simulation->stallWindowStartTick = simulation->tickCount;
+    simulation->stallPoseEnergyHash = poseEnergyHash;
+    simulation->isStallStateHashValid = false;
+    return false;
+  }
+
+  // The rest of the state is only hashed once per window, so a window that starts without a hash is used to take one.
+  // Steps are deterministic, so the same state at both ends means the robots will repeat the window forever.
+  if (simulation->tickCount - simulation->stallWindowStartTick < simulation->stallWindowTicks) {
+    return false;
+  }
+  uint64_t stateHash = hashRobotState(simulation);
+  if (simulation->isStallStateHashValid && stateHash == simulation->stallStateHash) {
+    return true;
+  }
 
-  // Find the robot index corresponding to the body index
-  Robot* otherRobot = NULL;
-  for (unsigned int j = 0; j < simulation->robotCount; j++) {
-    if (simulation->robots[j].physicsBodyIndex == physicsBodyIndex) {
-      otherRobot = &simulation->robots[j];
-      break;
+  simulation->stallWindowStartTick = simulation->tickCount;
+  simulation->isStallStateHashValid = true;
+  simulation->stallStateHash = stateHash;
+  return false;
+}
+
+uint64_t hashRobotPosesAndEnergy(const Simulation* simulation) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (unsigned int i = 0; i < simulation->robotCount; i++) {
+    const Robot* robot = &simulation->robots[i];
+    const PhysicsBody* body = &simulation->physicsWorld.bodies[robot->physicsBodyIndex];
+    hash = hashBytes(hash, &body->position, sizeof(body->position));
+    hash = hashBytes(hash, &body->rotation, sizeof(body->rotation));
+    hash = hashBytes(hash, &robot->energyRemaining, sizeof(robot->energyRemaining));
+  }
+  return hash;
+}
+
+uint64_t hashRobotState(const Simulation* simulation) {
+  uint64_t hash = FNV_OFFSET_BASIS;
+  for (unsigned int i = 0; i < simulation->robotCount; i++) {
+    const Robot* robot = &simulation->robots[i];
+    const PhysicsBody* body = &simulation->physicsWorld.bodies[robot->physicsBodyIndex];
+    hash = hashBytes(hash, &robot->processState.registers, sizeof(robot->processState.registers));
+    hash = hashBytes(hash, robot->processState.memory, MEMORY_SIZE);
+    hash = hashBytes(hash, &robot->weaponCooldownRemaining, sizeof(robot->weaponCooldownRemaining));
+    // Adding zero turns a negative zero velocity, left by stopping from a negative direction, into a positive one
+    Vector2 linearVelocity = { body->linearVelocity.x + 0.0f, body->linearVelocity.y + 0.0f };
+    float angularVelocity = body->angularVelocity + 0.0f;
+    hash = hashBytes(hash, &linearVelocity, sizeof(linearVelocity));
+    hash = hashBytes(hash, &angularVelocity, sizeof(angularVelocity));
+  }
+  return hash;
+}
+
+uint64_t hashBytes(uint64_t hash, const void* bytes, size_t byteCount) {
+  // FNV-1a
+  const unsigned char* byteArray = bytes;
+  for (size_t i = 0; i < byteCount; i++) {
+    hash = (hash ^ byteArray[i]) * FNV_PRIME;
+  }
+  return hash;
+}
+
+void resolveWeaponHits(Simulation* simulation) {
+  // Total the damage to each robot first, so that no hit depends on whether an earlier hit was fatal
+  int damageAmounts[SIMULATION_MAX_ROBOTS] = { 0 };
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    const WeaponHit* hit = &simulation->weaponHits[i];
+    if (!hit->isHit) { continue; }
+
+    int targetRobotIndex = simulation->robotIndicesByBody[hit->physicsBodyIndex];
+    if (targetRobotIndex >= 0) {
+      damageAmounts[targetRobotIndex] += hit->damageAmount;
     }
   }
 
-  // Apply damage to the other robot
-  if (otherRobot != NULL && otherRobot->energyRemaining > 0) {
-    otherRobot->energyRemaining -= damageAmount;
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    if (damageAmounts[i] > 0 && simulation->robots[i].energyRemaining > 0) {
+      simulation->robots[i].energyRemaining -= damageAmounts[i];
+    }
   }
 }
@@ -0,0 +1,230 @@
+#include "arena/snapshot.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include "utilities/file.h"
+
+#define SNAPSHOT_PAGE_COUNT (MEMORY_SIZE / SNAPSHOT_PAGE_SIZE)
+#define SNAPSHOT_PAGE_MASK_LENGTH ((SNAPSHOT_PAGE_COUNT + 7) / 8)
+// Written in the header in native byte order, so that snapshots from a machine with a different byte order are rejected.
+#define SNAPSHOT_BYTE_ORDER_MARK 0x01020304u
+
+// Snapshots are stored in native byte order and layout, since they are only meant to be loaded by the same build.
+// The header is followed by the simulation with its robot memory left out, then for each robot a bit mask of the
+// pages of memory that are stored followed by those pages.
+typedef struct {
+  char magic[4];
+  uint32_t version;
+  uint32_t byteOrderMark;
+  uint32_t simulationSize;
+  uint32_t memorySize;
+  uint32_t pageSize;
+} SnapshotHeader;
+
+const char SNAPSHOT_FILE_UNREADABLE[] = "Snapshot file could not be read";
+const char SNAPSHOT_FILE_TRUNCATED[] = "Snapshot file ends unexpectedly";
+const char SNAPSHOT_UNSUPPORTED_VERSION[] = "Snapshot file version is not supported";
+const char SNAPSHOT_INCOMPATIBLE_LAYOUT[] = "Snapshot was saved by an incompatible build";
+const char SNAPSHOT_INVALID_STATE[] = "Snapshot state is invalid";
+const char SNAPSHOT_OUT_OF_MEMORY[] = "Out of memory";
+
+
+// Gets the offset of a robot's memory within a simulation, which is stored separately from the rest of the simulation.
+size_t getRobotMemoryOffset(size_t robotIndex);
+// Gets the number of bytes stored for a simulation without its robot memory.
+size_t getStoredSimulationSize(void);
+
+// Checks that the counts and indices of a loaded simulation are within the bounds of its arrays.
+bool validateSimulationSnapshot(const Simulation* simulation);
+bool isMemoryPageZero(const uint8_t* page);
+
+
+bool TrySaveSimulationSnapshot(const Simulation* simulation, const char* filePath) {
+  // Clear the parts of the simulation that can't be restored
+  Simulation* storedSimulation = malloc(sizeof(Simulation));
+  if (storedSimulation == NULL) {
+    return false;
+  }
+  *storedSimulation = *simulation;
+  storedSimulation->host = (SimulationHost){ 0 };
+
+  FILE* file = fopen(filePath, "wb");
+  if (file == NULL) {
+    free(storedSimulation);
+    return false;
+  }
+
+  SnapshotHeader header = {
+    .version = SNAPSHOT_VERSION,
+    .byteOrderMark = SNAPSHOT_BYTE_ORDER_MARK,
+    .simulationSize = sizeof(Simulation),
+    .memorySize = MEMORY_SIZE,
+    .pageSize = SNAPSHOT_PAGE_SIZE,
+  };
+  memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+  bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+
+  // Write the simulation around each robot's memory
+  size_t offset = 0;
+  for (size_t i = 0; success && i <= SIMULATION_MAX_ROBOTS; i++) {
+    size_t endOffset = i < SIMULATION_MAX_ROBOTS ? getRobotMemoryOffset(i) : sizeof(Simulation);
+    success = fwrite((const uint8_t*)storedSimulation + offset, 1, endOffset - offset, file) == endOffset - offset;
+    offset = endOffset + MEMORY_SIZE;
+  }
+  free(storedSimulation);
+
+  // Write the non-zero pages of each robot's memory
+  for (size_t i = 0; success && i < SIMULATION_MAX_ROBOTS; i++) {
+    const uint8_t* memory = simulation->robots[i].processState.memory;
+    uint8_t pageMask[SNAPSHOT_PAGE_MASK_LENGTH] = { 0 };
+    for (size_t k = 0; k < SNAPSHOT_PAGE_COUNT; k++) {
+      if (!isMemoryPageZero(&memory[k * SNAPSHOT_PAGE_SIZE])) {
+        pageMask[k / 8] |= 1 << (k % 8);
+      }
+    }
+
+    success = fwrite(pageMask, sizeof(pageMask), 1, file) == 1;
+    for (size_t k = 0; success && k < SNAPSHOT_PAGE_COUNT; k++) {
+      if (pageMask[k / 8] & (1 << (k % 8))) {
+        success = fwrite(&memory[k * SNAPSHOT_PAGE_SIZE], SNAPSHOT_PAGE_SIZE, 1, file) == 1;
+      }
+    }
+  }
+
+  return fclose(file) == 0 && success;
+}
+
+bool TryLoadSimulationSnapshot(const char* filePath, Simulation* simulation, const char** error) {
+  *error = NULL;
+
+  FileBytes contents;
+  if (!TryReadAllBytes(filePath, &contents)) {
+    *error = SNAPSHOT_FILE_UNREADABLE;
+    return false;
+  }
+
+  bool success = TryReadSimulationSnapshot(contents.bytes, contents.length, simulation, error);
+  ReleaseFileBytes(&contents);
+  return success;
+}
+
+bool TryReadSimulationSnapshot(const uint8_t* bytes, size_t length, Simulation* simulation, const char** error) {
+  *error = NULL;
+
+  // Check that the snapshot was written by a compatible build
+  SnapshotHeader header;
+  if (length < sizeof(header)) {
+    *error = length >= strlen(SNAPSHOT_MAGIC) && memcmp(bytes, SNAPSHOT_MAGIC, strlen(SNAPSHOT_MAGIC)) == 0
+      ? SNAPSHOT_FILE_TRUNCATED : SNAPSHOT_FILE_UNREADABLE;
+    return false;
+  }
+  memcpy(&header, bytes, sizeof(header));
+  if (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0) {
+    *error = SNAPSHOT_FILE_UNREADABLE;
+    return false;
+  }
+  if (header.version != SNAPSHOT_VERSION) {
+    *error = SNAPSHOT_UNSUPPORTED_VERSION;
+    return false;
+  }
+  if (header.byteOrderMark != SNAPSHOT_BYTE_ORDER_MARK || header.simulationSize != sizeof(Simulation)
+      || header.memorySize != MEMORY_SIZE || header.pageSize != SNAPSHOT_PAGE_SIZE) {
+    *error = SNAPSHOT_INCOMPATIBLE_LAYOUT;
+    return false;
+  }
+  size_t offset = sizeof(header);
+  if (length - offset < getStoredSimulationSize()) {
+    *error = SNAPSHOT_FILE_TRUNCATED;
+    return false;
+  }
+
+  // Load into a separate simulation so that the given one is left unchanged on failure
+  Simulation* loadedSimulation = malloc(sizeof(Simulation));
+  if (loadedSimulation == NULL) {
+    *error = SNAPSHOT_OUT_OF_MEMORY;
+    return false;
+  }
+  size_t simulationOffset = 0;
+  for (size_t i = 0; i <= SIMULATION_MAX_ROBOTS; i++) {
+    size_t endOffset = i < SIMULATION_MAX_ROBOTS ? getRobotMemoryOffset(i) : sizeof(Simulation);
+    memcpy((uint8_t*)loadedSimulation + simulationOffset, &bytes[offset], endOffset - simulationOffset);
+    offset += endOffset - simulationOffset;
+    simulationOffset = endOffset + MEMORY_SIZE;
+  }
+  if (!validateSimulationSnapshot(loadedSimulation)) {
+    free(loadedSimulation);
+    *error = SNAPSHOT_INVALID_STATE;
+    return false;
+  }
+
+  // Read the stored pages of each robot's memory
+  for (size_t i = 0; i < SIMULATION_MAX_ROBOTS; i++) {
+    if (length - offset < SNAPSHOT_PAGE_MASK_LENGTH) {
+      free(loadedSimulation);
+      *error = SNAPSHOT_FILE_TRUNCATED;
+      return false;
+    }
+    const uint8_t* pageMask = &bytes[offset];
+    offset += SNAPSHOT_PAGE_MASK_LENGTH;
+
+    uint8_t* memory = loadedSimulation->robots[i].processState.memory;
+    memset(memory, 0x00, MEMORY_SIZE);
+    for (size_t k = 0; k < SNAPSHOT_PAGE_COUNT; k++) {
+      if (pageMask[k / 8] & (1 << (k % 8))) {
+        if (length - offset < SNAPSHOT_PAGE_SIZE) {
+          free(loadedSimulation);
+          *error = SNAPSHOT_FILE_TRUNCATED;
+          return false;
+        }
+        memcpy(&memory[k * SNAPSHOT_PAGE_SIZE], &bytes[offset], SNAPSHOT_PAGE_SIZE);
+        offset += SNAPSHOT_PAGE_SIZE;
+      }
+    }
+  }
+
+  ReplaceSimulationBattle(simulation, loadedSimulation);
+  free(loadedSimulation);
+  return true;
+}
+
+
+size_t getRobotMemoryOffset(size_t robotIndex) {
+  return offsetof(Simulation, robots) + robotIndex * sizeof(Robot) + offsetof(Robot, processState) + offsetof(ProcessState, memory);
+}
+
+size_t getStoredSimulationSize(void) {
+  return sizeof(Simulation) - SIMULATION_MAX_ROBOTS * MEMORY_SIZE;
+}
+
+bool validateSimulationSnapshot(const Simulation* simulation) {
+  const PhysicsWorld* physicsWorld = &simulation->physicsWorld;
+  if (simulation->robotCount > SIMULATION_MAX_ROBOTS || physicsWorld->bodyCount > MAX_PHYSICS_BODIES) {
+    return false;
+  }
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    if (simulation->robots[i].physicsBodyIndex >= physicsWorld->bodyCount) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < physicsWorld->bodyCount; i++) {
+    int robotIndex = simulation->robotIndicesByBody[i];
+    if (robotIndex < -1 || robotIndex >= (int)simulation->robotCount) {
+      return false;
+    }
+  }
+  if (physicsWorld->staticDistanceField.columnCount > PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1
+      || physicsWorld->staticDistanceField.rowCount > PHYSICS_DISTANCE_FIELD_MAX_CELLS + 1) {
+    return false;
+  }
+  return true;
+}
+
+bool isMemoryPageZero(const uint8_t* page) {
+  for (size_t i = 0; i < SNAPSHOT_PAGE_SIZE; i++) {
+    if (page[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
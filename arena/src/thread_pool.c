@@ -0,0 +1,123 @@
+#include "arena/thread_pool.h"
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+
+void* threadPoolThread(void* arg);
+
+// Claims and runs tasks from the current batch until none are left. Must be called with the state mutex locked.
+void runAvailableTasks(ThreadPool* pool);
+
+
+bool TryInitThreadPool(ThreadPool* pool, size_t threadCount) {
+  *pool = (ThreadPool){ 0 };
+  if (pthread_mutex_init(&pool->stateMutex, NULL)) {
+    return false;
+  }
+  if (pthread_cond_init(&pool->tasksAvailable, NULL)) {
+    pthread_mutex_destroy(&pool->stateMutex);
+    return false;
+  }
+  if (pthread_cond_init(&pool->tasksFinished, NULL)) {
+    pthread_cond_destroy(&pool->tasksAvailable);
+    pthread_mutex_destroy(&pool->stateMutex);
+    return false;
+  }
+
+  if (threadCount > THREAD_POOL_MAX_THREADS) {
+    threadCount = THREAD_POOL_MAX_THREADS;
+  }
+  for (size_t i = 0; i < threadCount; i++) {
+    if (pthread_create(&pool->threads[i], NULL, threadPoolThread, pool)) {
+      break;
+    }
+    pool->threadCount++;
+  }
+  return true;
+}
+
+void DestroyThreadPool(ThreadPool* pool) {
+  pthread_mutex_lock(&pool->stateMutex); {
+    pool->shouldStop = true;
+    pthread_cond_broadcast(&pool->tasksAvailable);
+  } pthread_mutex_unlock(&pool->stateMutex);
+
+  for (size_t i = 0; i < pool->threadCount; i++) {
+    pthread_join(pool->threads[i], NULL);
+  }
+
+  pthread_cond_destroy(&pool->tasksFinished);
+  pthread_cond_destroy(&pool->tasksAvailable);
+  pthread_mutex_destroy(&pool->stateMutex);
+  *pool = (ThreadPool){ 0 };
+}
+
+size_t GetDefaultThreadPoolThreadCount(void) {
+  #if defined(WIN32)
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  long processorCount = (long)systemInfo.dwNumberOfProcessors;
+  #else
+  long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+  #endif
+  return processorCount > 1 ? (size_t)(processorCount - 1) : 0;
+}
+
+void RunThreadPoolTasks(ThreadPool* pool, size_t taskCount, ThreadPoolTaskFunc taskFunc, void* taskContext) {
+  if (taskCount == 0) { return; }
+
+  pthread_mutex_lock(&pool->stateMutex); {
+    pool->taskFunc = taskFunc;
+    pool->taskContext = taskContext;
+    pool->taskCount = taskCount;
+    pool->nextTaskIndex = 0;
+    pool->unfinishedTaskCount = taskCount;
+    pool->batchGeneration++;
+    pthread_cond_broadcast(&pool->tasksAvailable);
+
+    // Work on the batch alongside the pool's threads, then wait for any tasks they are still running.
+    runAvailableTasks(pool);
+    while (pool->unfinishedTaskCount > 0) {
+      pthread_cond_wait(&pool->tasksFinished, &pool->stateMutex);
+    }
+  } pthread_mutex_unlock(&pool->stateMutex);
+}
+
+
+void* threadPoolThread(void* arg) {
+  ThreadPool* pool = (ThreadPool*)arg;
+  uint64_t lastBatchGeneration = 0;
+
+  pthread_mutex_lock(&pool->stateMutex); {
+    while (true) {
+      while (!pool->shouldStop && pool->batchGeneration == lastBatchGeneration) {
+        pthread_cond_wait(&pool->tasksAvailable, &pool->stateMutex);
+      }
+      if (pool->shouldStop) { break; }
+
+      lastBatchGeneration = pool->batchGeneration;
+      runAvailableTasks(pool);
+    }
+  } pthread_mutex_unlock(&pool->stateMutex);
+  return NULL;
+}
+
+void runAvailableTasks(ThreadPool* pool) {
+  while (pool->nextTaskIndex < pool->taskCount) {
+    size_t taskIndex = pool->nextTaskIndex++;
+    ThreadPoolTaskFunc taskFunc = pool->taskFunc;
+    void* taskContext = pool->taskContext;
+
+    pthread_mutex_unlock(&pool->stateMutex);
+    taskFunc(taskContext, taskIndex);
+    pthread_mutex_lock(&pool->stateMutex);
+
+    pool->unfinishedTaskCount--;
+    if (pool->unfinishedTaskCount == 0) {
+      pthread_cond_signal(&pool->tasksFinished);
+    }
+  }
+}
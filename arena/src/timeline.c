@@ -0,0 +1,255 @@
+#include "arena/timeline.h"
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+#define TIMELINE_PAGES_PER_ROBOT (MEMORY_SIZE / TIMELINE_PAGE_SIZE)
+#define TIMELINE_PAGE_COUNT (SIMULATION_MAX_ROBOTS * TIMELINE_PAGES_PER_ROBOT)
+// The number of ranges of a simulation that are left out of keyframes: the static distance field, robot memory and
+// the host, which belongs to the running process and is kept when a keyframe is restored.
+#define TIMELINE_EXCLUDED_RANGE_COUNT (2 + SIMULATION_MAX_ROBOTS)
+
+
+// A range of bytes within a simulation.
+typedef struct {
+  size_t offset;
+  size_t size;
+} SimulationRange;
+
+
+// Gets the ranges of a simulation that are left out of keyframes, in order of offset.
+void getExcludedRanges(SimulationRange* rangesOut);
+// Gets the number of bytes in a keyframe's state.
+size_t getKeyframeStateSize(void);
+void storeKeyframeState(const Simulation* simulation, uint8_t* stateOut);
+void restoreKeyframeState(const uint8_t* state, Simulation* simulation);
+
+const uint8_t* getRobotMemoryPage(const Simulation* simulation, size_t pageIndex);
+// Gets the number of bytes taken by the memory changes stored in a keyframe.
+size_t getKeyframeChangeBytes(const TimelineKeyframe* keyframe);
+TimelineKeyframe* getKeyframe(Timeline* timeline, size_t index);
+void freeKeyframeChanges(Timeline* timeline, TimelineKeyframe* keyframe);
+void dropOldestKeyframe(Timeline* timeline);
+void dropNewestKeyframe(Timeline* timeline);
+
+
+bool TryInitTimeline(Timeline* timelineOut, uint64_t intervalTicks, size_t memoryCapBytes) {
+  *timelineOut = (Timeline){
+    .intervalTicks = intervalTicks > 0 ? intervalTicks : 1,
+    .memoryCapBytes = memoryCapBytes,
+  };
+  timelineOut->latestMemory = malloc(TIMELINE_PAGE_COUNT * TIMELINE_PAGE_SIZE);
+  return timelineOut->latestMemory != NULL;
+}
+
+void DestroyTimeline(Timeline* timeline) {
+  ClearTimeline(timeline);
+  free(timeline->latestMemory);
+  timeline->latestMemory = NULL;
+}
+
+void ClearTimeline(Timeline* timeline) {
+  while (timeline->keyframeCount > 0) {
+    dropNewestKeyframe(timeline);
+  }
+}
+
+void CaptureTimelineKeyframe(Timeline* timeline, const Simulation* simulation) {
+  TimelineKeyframe* newestKeyframe = timeline->keyframeCount > 0 ? getKeyframe(timeline, timeline->keyframeCount - 1) : NULL;
+  if (newestKeyframe != NULL && newestKeyframe->tickCount >= simulation->tickCount) {
+    return;
+  }
+
+  // Find the pages of memory that changed since the newest keyframe, which it will hold in place of its full memory
+  uint32_t changedPageIndices[TIMELINE_PAGE_COUNT];
+  size_t changedPageCount = 0;
+  if (newestKeyframe != NULL) {
+    for (size_t i = 0; i < TIMELINE_PAGE_COUNT; i++) {
+      const uint8_t* page = getRobotMemoryPage(simulation, i);
+      if (memcmp(page, &timeline->latestMemory[i * TIMELINE_PAGE_SIZE], TIMELINE_PAGE_SIZE) != 0) {
+        changedPageIndices[changedPageCount++] = (uint32_t)i;
+      }
+    }
+  }
+
+  // Allocate everything up front so that a failure leaves the timeline unchanged
+  uint8_t* state = malloc(getKeyframeStateSize());
+  uint32_t* newestChangedPageIndices = changedPageCount > 0 ? malloc(changedPageCount * sizeof(uint32_t)) : NULL;
+  uint8_t* newestChangedPages = changedPageCount > 0 ? malloc(changedPageCount * TIMELINE_PAGE_SIZE) : NULL;
+  if (state == NULL || (changedPageCount > 0 && (newestChangedPageIndices == NULL || newestChangedPages == NULL))) {
+    free(state);
+    free(newestChangedPageIndices);
+    free(newestChangedPages);
+    return;
+  }
+
+  // Move the newest keyframe's copy of the changed pages into it, then replace them with the current memory
+  if (newestKeyframe != NULL) {
+    for (size_t k = 0; k < changedPageCount; k++) {
+      uint8_t* latestPage = &timeline->latestMemory[changedPageIndices[k] * TIMELINE_PAGE_SIZE];
+      newestChangedPageIndices[k] = changedPageIndices[k];
+      memcpy(&newestChangedPages[k * TIMELINE_PAGE_SIZE], latestPage, TIMELINE_PAGE_SIZE);
+      memcpy(latestPage, getRobotMemoryPage(simulation, changedPageIndices[k]), TIMELINE_PAGE_SIZE);
+    }
+    newestKeyframe->changedPageCount = changedPageCount;
+    newestKeyframe->changedPageIndices = newestChangedPageIndices;
+    newestKeyframe->changedPages = newestChangedPages;
+    timeline->memoryUsedBytes += getKeyframeChangeBytes(newestKeyframe);
+  } else {
+    for (size_t i = 0; i < TIMELINE_PAGE_COUNT; i++) {
+      memcpy(&timeline->latestMemory[i * TIMELINE_PAGE_SIZE], getRobotMemoryPage(simulation, i), TIMELINE_PAGE_SIZE);
+    }
+  }
+
+  // Add the new keyframe, making room for it in the ring if needed
+  if (timeline->keyframeCount == TIMELINE_MAX_KEYFRAMES) {
+    dropOldestKeyframe(timeline);
+  }
+  TimelineKeyframe* keyframe = getKeyframe(timeline, timeline->keyframeCount++);
+  *keyframe = (TimelineKeyframe){ .tickCount = simulation->tickCount, .state = state };
+  storeKeyframeState(simulation, state);
+  timeline->memoryUsedBytes += getKeyframeStateSize();
+
+  while (timeline->memoryUsedBytes > timeline->memoryCapBytes && timeline->keyframeCount > 1) {
+    dropOldestKeyframe(timeline);
+  }
+}
+
+uint64_t GetTimelineStartTick(const Timeline* timeline) {
+  return timeline->keyframeCount > 0 ? timeline->keyframes[timeline->firstKeyframeIndex].tickCount : UINT64_MAX;
+}
+
+bool TrySeekTimeline(Timeline* timeline, Simulation* simulation, uint64_t tick) {
+  if (tick < simulation->tickCount) {
+    if (tick < GetTimelineStartTick(timeline)) {
+      return false;
+    }
+
+    // Drop the keyframes after the requested step, undoing their memory changes along the way
+    while (getKeyframe(timeline, timeline->keyframeCount - 1)->tickCount > tick) {
+      dropNewestKeyframe(timeline);
+    }
+
+    // Restore the newest remaining keyframe
+    restoreKeyframeState(getKeyframe(timeline, timeline->keyframeCount - 1)->state, simulation);
+    for (size_t i = 0; i < SIMULATION_MAX_ROBOTS; i++) {
+      memcpy(simulation->robots[i].processState.memory, &timeline->latestMemory[i * MEMORY_SIZE], MEMORY_SIZE);
+    }
+    if (simulation->host.replayRecorder != NULL) {
+      simulation->host.replayRecorder->hasFailed = true;
+    }
+  }
+
+  while (simulation->tickCount < tick) {
+    StepSimulation(simulation);
+  }
+  return true;
+}
+
+
+void getExcludedRanges(SimulationRange* rangesOut) {
+  rangesOut[0] = (SimulationRange){
+    .offset = offsetof(Simulation, physicsWorld) + offsetof(PhysicsWorld, staticDistanceField),
+    .size = sizeof(PhysicsDistanceField),
+  };
+  for (size_t i = 0; i < SIMULATION_MAX_ROBOTS; i++) {
+    rangesOut[1 + i] = (SimulationRange){
+      .offset = offsetof(Simulation, robots) + i * sizeof(Robot) + offsetof(Robot, processState) + offsetof(ProcessState, memory),
+      .size = MEMORY_SIZE,
+    };
+  }
+  rangesOut[1 + SIMULATION_MAX_ROBOTS] = (SimulationRange){
+    .offset = offsetof(Simulation, host),
+    .size = sizeof(SimulationHost),
+  };
+}
+
+size_t getKeyframeStateSize(void) {
+  return sizeof(Simulation) - sizeof(PhysicsDistanceField) - SIMULATION_MAX_ROBOTS * MEMORY_SIZE - sizeof(SimulationHost)
+    + sizeof(ReplayPlayer);
+}
+
+void storeKeyframeState(const Simulation* simulation, uint8_t* stateOut) {
+  SimulationRange excludedRanges[TIMELINE_EXCLUDED_RANGE_COUNT];
+  getExcludedRanges(excludedRanges);
+
+  size_t offset = 0;
+  for (size_t i = 0; i <= TIMELINE_EXCLUDED_RANGE_COUNT; i++) {
+    size_t endOffset = i < TIMELINE_EXCLUDED_RANGE_COUNT ? excludedRanges[i].offset : sizeof(Simulation);
+    memcpy(stateOut, (const uint8_t*)simulation + offset, endOffset - offset);
+    stateOut += endOffset - offset;
+    offset = i < TIMELINE_EXCLUDED_RANGE_COUNT ? endOffset + excludedRanges[i].size : endOffset;
+  }
+
+  ReplayPlayer replayPlayer = simulation->host.replayPlayer != NULL ? *simulation->host.replayPlayer : (ReplayPlayer){ 0 };
+  memcpy(stateOut, &replayPlayer, sizeof(replayPlayer));
+}
+
+void restoreKeyframeState(const uint8_t* state, Simulation* simulation) {
+  SimulationRange excludedRanges[TIMELINE_EXCLUDED_RANGE_COUNT];
+  getExcludedRanges(excludedRanges);
+
+  size_t offset = 0;
+  for (size_t i = 0; i <= TIMELINE_EXCLUDED_RANGE_COUNT; i++) {
+    size_t endOffset = i < TIMELINE_EXCLUDED_RANGE_COUNT ? excludedRanges[i].offset : sizeof(Simulation);
+    memcpy((uint8_t*)simulation + offset, state, endOffset - offset);
+    state += endOffset - offset;
+    offset = i < TIMELINE_EXCLUDED_RANGE_COUNT ? endOffset + excludedRanges[i].size : endOffset;
+  }
+
+  if (simulation->host.replayPlayer != NULL) {
+    memcpy(simulation->host.replayPlayer, state, sizeof(ReplayPlayer));
+  }
+}
+
+const uint8_t* getRobotMemoryPage(const Simulation* simulation, size_t pageIndex) {
+  size_t robotIndex = pageIndex / TIMELINE_PAGES_PER_ROBOT;
+  return &simulation->robots[robotIndex].processState.memory[(pageIndex % TIMELINE_PAGES_PER_ROBOT) * TIMELINE_PAGE_SIZE];
+}
+
+size_t getKeyframeChangeBytes(const TimelineKeyframe* keyframe) {
+  return keyframe->changedPageCount * (sizeof(uint32_t) + TIMELINE_PAGE_SIZE);
+}
+
+TimelineKeyframe* getKeyframe(Timeline* timeline, size_t index) {
+  return &timeline->keyframes[(timeline->firstKeyframeIndex + index) % TIMELINE_MAX_KEYFRAMES];
+}
+
+void freeKeyframeChanges(Timeline* timeline, TimelineKeyframe* keyframe) {
+  timeline->memoryUsedBytes -= getKeyframeChangeBytes(keyframe);
+  free(keyframe->changedPageIndices);
+  free(keyframe->changedPages);
+  keyframe->changedPageCount = 0;
+  keyframe->changedPageIndices = NULL;
+  keyframe->changedPages = NULL;
+}
+
+void dropOldestKeyframe(Timeline* timeline) {
+  TimelineKeyframe* keyframe = getKeyframe(timeline, 0);
+  freeKeyframeChanges(timeline, keyframe);
+  free(keyframe->state);
+  timeline->memoryUsedBytes -= getKeyframeStateSize();
+  *keyframe = (TimelineKeyframe){ 0 };
+
+  timeline->firstKeyframeIndex = (timeline->firstKeyframeIndex + 1) % TIMELINE_MAX_KEYFRAMES;
+  timeline->keyframeCount--;
+}
+
+void dropNewestKeyframe(Timeline* timeline) {
+  TimelineKeyframe* keyframe = getKeyframe(timeline, timeline->keyframeCount - 1);
+  freeKeyframeChanges(timeline, keyframe);
+  free(keyframe->state);
+  timeline->memoryUsedBytes -= getKeyframeStateSize();
+  *keyframe = (TimelineKeyframe){ 0 };
+  timeline->keyframeCount--;
+
+  // Undo the memory changes between the keyframe before it and the dropped keyframe, which makes it the newest
+  if (timeline->keyframeCount > 0) {
+    TimelineKeyframe* previousKeyframe = getKeyframe(timeline, timeline->keyframeCount - 1);
+    for (size_t k = 0; k < previousKeyframe->changedPageCount; k++) {
+      memcpy(&timeline->latestMemory[previousKeyframe->changedPageIndices[k] * TIMELINE_PAGE_SIZE],
+        &previousKeyframe->changedPages[k * TIMELINE_PAGE_SIZE], TIMELINE_PAGE_SIZE);
+    }
+    freeKeyframeChanges(timeline, previousKeyframe);
+  }
+}
@@ -1,37 +1,103 @@
 #include "arena/timer.h"
+#include <stdbool.h>
+#include <assert.h>
+
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+
+// Restarts the timer's tick count at the given time and its current rate.
+void restartTimerEpoch(Timer* timer, int64_t time);
+
+// Computes value * multiplier / divisor rounded down for non-negative values, saturating at INT64_MAX.
+int64_t multiplyDivideSaturating(int64_t value, int64_t multiplier, int64_t divisor);
+
+
+TimeSource InitMonotonicTimeSource() {
+  return (TimeSource){ .kind = TIME_SOURCE_MONOTONIC };
+}
+
+TimeSource InitVirtualTimeSource() {
+  return (TimeSource){ .kind = TIME_SOURCE_VIRTUAL };
+}
+
+TimeSource InitFixedStepTimeSource(int64_t stepNanoseconds) {
+  return (TimeSource){ .kind = TIME_SOURCE_FIXED_STEP, .stepNanoseconds = stepNanoseconds };
+}
+
+int64_t ReadTimeSource(TimeSource* source) {
+  switch (source->kind) {
+    case TIME_SOURCE_MONOTONIC: {
+      #if defined(WIN32)
+      LARGE_INTEGER counter, frequency;
+      QueryPerformanceCounter(&counter);
+      QueryPerformanceFrequency(&frequency);
+      return multiplyDivideSaturating(counter.QuadPart, TIMER_NANOSECONDS_PER_SECOND, frequency.QuadPart);
+      #else
+      struct timespec time;
+      clock_gettime(CLOCK_MONOTONIC, &time);
+      return (int64_t)time.tv_sec * TIMER_NANOSECONDS_PER_SECOND + time.tv_nsec;
+      #endif
+    }
+    case TIME_SOURCE_VIRTUAL: {
+      return source->nanoseconds;
+    }
+    case TIME_SOURCE_FIXED_STEP: {
+      AdvanceTimeSource(source, source->stepNanoseconds);
+      return source->nanoseconds;
+    }
+  }
+
+  assert(false);
+  return 0;
+}
+
+void AdvanceTimeSource(TimeSource* source, int64_t nanoseconds) {
+  if (nanoseconds <= 0) { return; }
+  source->nanoseconds = (source->nanoseconds > INT64_MAX - nanoseconds) ? INT64_MAX : source->nanoseconds + nanoseconds;
+}
 
 Timer InitTimer(int64_t ticksPerSec, int64_t maxTicks) {
-  return (Timer){
+  return InitTimerWithSource(ticksPerSec, maxTicks, InitMonotonicTimeSource());
+}
+
+Timer InitTimerWithSource(int64_t ticksPerSec, int64_t maxTicks, TimeSource source) {
+  Timer timer = {
     .ticksPerSec = ticksPerSec,
     .maxTicks = maxTicks,
-    ._lastClock = clock(),
+    .source = source,
     ._lastTicks = 0,
-    ._lastRemainder = 0,
   };
+  timer._lastTime = ReadTimeSource(&timer.source);
+  restartTimerEpoch(&timer, timer._lastTime);
+  return timer;
 }
 
 int64_t GetTimerTicks(Timer* timer) {
+  // Start counting again if the rate was changed without SetTimerTicksPerSec
+  if (timer->ticksPerSec != timer->_epochTicksPerSec) {
+    restartTimerEpoch(timer, timer->_lastTime);
+  }
+
+  int64_t currentTime = ReadTimeSource(&timer->source);
+  if (currentTime < timer->_lastTime) { currentTime = timer->_lastTime; }
+  timer->_lastTime = currentTime;
+
   int64_t ticksPerSec = timer->ticksPerSec;
   if (ticksPerSec < 0) { ticksPerSec = 0; }
 
-  clock_t currentClock = clock();
-  clock_t elapsedClocks = currentClock - timer->_lastClock;
-  if (elapsedClocks < 0) { elapsedClocks = 0; }
-  
-  int64_t elapsedTicksClocksPerSec;
-  if (ticksPerSec != 0 && (int64_t)elapsedClocks > ((INT64_MAX - timer->_lastRemainder) / ticksPerSec)) {
-    elapsedTicksClocksPerSec = INT64_MAX;
+  int64_t totalTicks = multiplyDivideSaturating(currentTime - timer->_epochTime, ticksPerSec, TIMER_NANOSECONDS_PER_SECOND);
+  int64_t elapsedTicks = totalTicks - timer->_epochTicks;
+  if (totalTicks == INT64_MAX) {
+    restartTimerEpoch(timer, currentTime); // The count can't go any higher, so start again from here
   } else {
-    elapsedTicksClocksPerSec = (int64_t)elapsedClocks * ticksPerSec + timer->_lastRemainder;
+    timer->_epochTicks = totalTicks;
   }
 
-  int64_t elapsedTicks = elapsedTicksClocksPerSec / CLOCKS_PER_SEC;
-  int64_t newRemainder = elapsedTicksClocksPerSec % CLOCKS_PER_SEC;
-  
-  timer->_lastClock = currentClock;
   AddTimerTicks(timer, elapsedTicks);
-  timer->_lastRemainder = newRemainder;
-
   return timer->_lastTicks;
 }
 
@@ -41,3 +107,82 @@ void AddTimerTicks(Timer* timer, int64_t ticks) {
   if (newTicks > timer->_lastTicks && ticks < 0) { newTicks = INT64_MIN; } // Underflow check
   timer->_lastTicks = (newTicks > timer->maxTicks) ? timer->maxTicks : newTicks;
 }
+
+void SetTimerTicksPerSec(Timer* timer, int64_t ticksPerSec) {
+  GetTimerTicks(timer);
+  timer->ticksPerSec = ticksPerSec;
+  restartTimerEpoch(timer, timer->_lastTime);
+}
+
+int64_t GetTimerNanosecondsUntilTick(const Timer* timer) {
+  if (timer->_lastTicks > 0) { return 0; }
+  if (timer->ticksPerSec != timer->_epochTicksPerSec) { return 0; } // The rate changed, so the next update will tell
+  if (timer->ticksPerSec <= 0) { return -1; }
+  if (timer->ticksPerSec >= TIMER_NANOSECONDS_PER_SECOND) { return 0; }
+
+  // Find when the next tick passes, rounding up so that it has passed by then
+  int64_t nextTick = timer->_epochTicks + 1;
+  int64_t wholeSeconds = nextTick / timer->ticksPerSec;
+  int64_t remainderTicks = nextTick % timer->ticksPerSec;
+  int64_t remainderNanoseconds = remainderTicks * TIMER_NANOSECONDS_PER_SECOND;
+  int64_t nextTickTime = wholeSeconds * TIMER_NANOSECONDS_PER_SECOND
+    + remainderNanoseconds / timer->ticksPerSec + (remainderNanoseconds % timer->ticksPerSec != 0);
+
+  int64_t remainingTime = nextTickTime - (timer->_lastTime - timer->_epochTime);
+  return remainingTime > 0 ? remainingTime : 0;
+}
+
+TickRateMeter InitTickRateMeter(int64_t windowNanoseconds, TimeSource source, uint64_t tickCount) {
+  TickRateMeter meter = {
+    .source = source,
+    .windowNanoseconds = windowNanoseconds,
+    .ticksPerSec = 0,
+    ._windowStartTicks = tickCount,
+  };
+  meter._windowStartTime = ReadTimeSource(&meter.source);
+  return meter;
+}
+
+void UpdateTickRateMeter(TickRateMeter* meter, uint64_t tickCount) {
+  int64_t currentTime = ReadTimeSource(&meter->source);
+  if (tickCount < meter->_windowStartTicks) {
+    meter->_windowStartTime = currentTime;
+    meter->_windowStartTicks = tickCount;
+    return;
+  }
+
+  int64_t elapsedTime = currentTime - meter->_windowStartTime;
+  if (elapsedTime < meter->windowNanoseconds || elapsedTime <= 0) { return; }
+
+  meter->ticksPerSec = (double)(tickCount - meter->_windowStartTicks) * TIMER_NANOSECONDS_PER_SECOND / (double)elapsedTime;
+  meter->_windowStartTime = currentTime;
+  meter->_windowStartTicks = tickCount;
+}
+
+
+void restartTimerEpoch(Timer* timer, int64_t time) {
+  timer->_epochTime = time;
+  timer->_epochTicksPerSec = timer->ticksPerSec;
+  timer->_epochTicks = 0;
+}
+
+int64_t multiplyDivideSaturating(int64_t value, int64_t multiplier, int64_t divisor) {
+  // Divide first, then scale the remainder, splitting the multiplier as well if the remainder would overflow
+  int64_t wholeQuotient = value / divisor;
+  int64_t remainder = value % divisor;
+  if (multiplier != 0 && wholeQuotient > INT64_MAX / multiplier) { return INT64_MAX; }
+  int64_t result = wholeQuotient * multiplier;
+
+  int64_t multiplierQuotient = multiplier / divisor;
+  int64_t multiplierRemainder = multiplier % divisor;
+  if (multiplierQuotient != 0 && remainder > INT64_MAX / multiplierQuotient) { return INT64_MAX; }
+  int64_t remainderPart = remainder * multiplierQuotient;
+  if (multiplierRemainder != 0 && remainder > INT64_MAX / multiplierRemainder) {
+    remainderPart = INT64_MAX; // Only reached for divisors near the limits of int64_t
+  } else {
+    int64_t fractionPart = remainder * multiplierRemainder / divisor;
+    remainderPart = (remainderPart > INT64_MAX - fractionPart) ? INT64_MAX : remainderPart + fractionPart;
+  }
+
+  return (result > INT64_MAX - remainderPart) ? INT64_MAX : result + remainderPart;
+}
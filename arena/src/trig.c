@@ -0,0 +1,105 @@
+#include "arena/trig.h"
+#include <math.h>
+
+// pi/2 split into three parts whose leading parts have trailing zero bits, so range reduction stays exact.
+#define PI_OVER_2_PART1 1.5703125f
+#define PI_OVER_2_PART2 4.837512969970703125e-4f
+#define PI_OVER_2_PART3 7.54978995489188216e-8f
+#define TWO_OVER_PI     0.636619772f
+
+// sin(2*pi * i / TRIG_DIRECTION_COUNT) for i in [0, TRIG_DIRECTION_COUNT * 5/4), so that the cosine of
+// direction i can be read from index i + TRIG_DIRECTION_COUNT / 4.
+static const float directionSineTable[TRIG_DIRECTION_COUNT + TRIG_DIRECTION_COUNT / 4] = {
+  0.0f, 0.024541229f, 0.049067676f, 0.07356457f, 0.09801714f, 0.12241068f, 0.14673047f, 0.17096189f,
+  0.19509032f, 0.21910124f, 0.24298018f, 0.26671275f, 0.29028466f, 0.31368175f, 0.33688986f, 0.35989505f,
+  0.38268343f, 0.4052413f, 0.42755508f, 0.44961134f, 0.47139674f, 0.4928982f, 0.51410276f, 0.53499764f,
+  0.55557024f, 0.57580817f, 0.5956993f, 0.6152316f, 0.6343933f, 0.65317285f, 0.671559f, 0.68954057f,
+  0.70710677f, 0.7242471f, 0.7409511f, 0.7572088f, 0.77301043f, 0.7883464f, 0.8032075f, 0.8175848f,
+  0.8314696f, 0.8448536f, 0.8577286f, 0.87008697f, 0.8819213f, 0.8932243f, 0.9039893f, 0.9142098f,
+  0.9238795f, 0.9329928f, 0.94154406f, 0.94952816f, 0.95694035f, 0.96377605f, 0.97003126f, 0.9757021f,
+  0.98078525f, 0.98527765f, 0.9891765f, 0.99247956f, 0.9951847f, 0.99729043f, 0.99879545f, 0.9996988f,
+  1.0f, 0.9996988f, 0.99879545f, 0.99729043f, 0.9951847f, 0.99247956f, 0.9891765f, 0.98527765f,
+  0.98078525f, 0.9757021f, 0.97003126f, 0.96377605f, 0.95694035f, 0.94952816f, 0.94154406f, 0.9329928f,
+  0.9238795f, 0.9142098f, 0.9039893f, 0.8932243f, 0.8819213f, 0.87008697f, 0.8577286f, 0.8448536f,
+  0.8314696f, 0.8175848f, 0.8032075f, 0.7883464f, 0.77301043f, 0.7572088f, 0.7409511f, 0.7242471f,
+  0.70710677f, 0.68954057f, 0.671559f, 0.65317285f, 0.6343933f, 0.6152316f, 0.5956993f, 0.57580817f,
+  0.55557024f, 0.53499764f, 0.51410276f, 0.4928982f, 0.47139674f, 0.44961134f, 0.42755508f, 0.4052413f,
+  0.38268343f, 0.35989505f, 0.33688986f, 0.31368175f, 0.29028466f, 0.26671275f, 0.24298018f, 0.21910124f,
+  0.19509032f, 0.17096189f, 0.14673047f, 0.12241068f, 0.09801714f, 0.07356457f, 0.049067676f, 0.024541229f,
+  0.0f, -0.024541229f, -0.049067676f, -0.07356457f, -0.09801714f, -0.12241068f, -0.14673047f, -0.17096189f,
+  -0.19509032f, -0.21910124f, -0.24298018f, -0.26671275f, -0.29028466f, -0.31368175f, -0.33688986f, -0.35989505f,
+  -0.38268343f, -0.4052413f, -0.42755508f, -0.44961134f, -0.47139674f, -0.4928982f, -0.51410276f, -0.53499764f,
+  -0.55557024f, -0.57580817f, -0.5956993f, -0.6152316f, -0.6343933f, -0.65317285f, -0.671559f, -0.68954057f,
+  -0.70710677f, -0.7242471f, -0.7409511f, -0.7572088f, -0.77301043f, -0.7883464f, -0.8032075f, -0.8175848f,
+  -0.8314696f, -0.8448536f, -0.8577286f, -0.87008697f, -0.8819213f, -0.8932243f, -0.9039893f, -0.9142098f,
+  -0.9238795f, -0.9329928f, -0.94154406f, -0.94952816f, -0.95694035f, -0.96377605f, -0.97003126f, -0.9757021f,
+  -0.98078525f, -0.98527765f, -0.9891765f, -0.99247956f, -0.9951847f, -0.99729043f, -0.99879545f, -0.9996988f,
+  -1.0f, -0.9996988f, -0.99879545f, -0.99729043f, -0.9951847f, -0.99247956f, -0.9891765f, -0.98527765f,
+  -0.98078525f, -0.9757021f, -0.97003126f, -0.96377605f, -0.95694035f, -0.94952816f, -0.94154406f, -0.9329928f,
+  -0.9238795f, -0.9142098f, -0.9039893f, -0.8932243f, -0.8819213f, -0.87008697f, -0.8577286f, -0.8448536f,
+  -0.8314696f, -0.8175848f, -0.8032075f, -0.7883464f, -0.77301043f, -0.7572088f, -0.7409511f, -0.7242471f,
+  -0.70710677f, -0.68954057f, -0.671559f, -0.65317285f, -0.6343933f, -0.6152316f, -0.5956993f, -0.57580817f,
+  -0.55557024f, -0.53499764f, -0.51410276f, -0.4928982f, -0.47139674f, -0.44961134f, -0.42755508f, -0.4052413f,
+  -0.38268343f, -0.35989505f, -0.33688986f, -0.31368175f, -0.29028466f, -0.26671275f, -0.24298018f, -0.21910124f,
+  -0.19509032f, -0.17096189f, -0.14673047f, -0.12241068f, -0.09801714f, -0.07356457f, -0.049067676f, -0.024541229f,
+  0.0f, 0.024541229f, 0.049067676f, 0.07356457f, 0.09801714f, 0.12241068f, 0.14673047f, 0.17096189f,
+  0.19509032f, 0.21910124f, 0.24298018f, 0.26671275f, 0.29028466f, 0.31368175f, 0.33688986f, 0.35989505f,
+  0.38268343f, 0.4052413f, 0.42755508f, 0.44961134f, 0.47139674f, 0.4928982f, 0.51410276f, 0.53499764f,
+  0.55557024f, 0.57580817f, 0.5956993f, 0.6152316f, 0.6343933f, 0.65317285f, 0.671559f, 0.68954057f,
+  0.70710677f, 0.7242471f, 0.7409511f, 0.7572088f, 0.77301043f, 0.7883464f, 0.8032075f, 0.8175848f,
+  0.8314696f, 0.8448536f, 0.8577286f, 0.87008697f, 0.8819213f, 0.8932243f, 0.9039893f, 0.9142098f,
+  0.9238795f, 0.9329928f, 0.94154406f, 0.94952816f, 0.95694035f, 0.96377605f, 0.97003126f, 0.9757021f,
+  0.98078525f, 0.98527765f, 0.9891765f, 0.99247956f, 0.9951847f, 0.99729043f, 0.99879545f, 0.9996988f,
+};
+
+
+// Computes the sine of an angle in the range [-pi/4, pi/4].
+float sinKernel(float x);
+
+// Computes the cosine of an angle in the range [-pi/4, pi/4].
+float cosKernel(float x);
+
+
+void FastSinCos(float angle, float* sinOut, float* cosOut) {
+  // Reduce the angle to the range [-pi/4, pi/4] and determine its quadrant
+  float quadrantFloat = nearbyintf(angle * TWO_OVER_PI);
+  float reduced = ((angle - quadrantFloat * PI_OVER_2_PART1) - quadrantFloat * PI_OVER_2_PART2) - quadrantFloat * PI_OVER_2_PART3;
+  int quadrant = (int)quadrantFloat & 3;
+
+  float sinReduced = sinKernel(reduced);
+  float cosReduced = cosKernel(reduced);
+  switch (quadrant) {
+    case 0: *sinOut = sinReduced;  *cosOut = cosReduced;  break;
+    case 1: *sinOut = cosReduced;  *cosOut = -sinReduced; break;
+    case 2: *sinOut = -sinReduced; *cosOut = -cosReduced; break;
+    default: *sinOut = -cosReduced; *cosOut = sinReduced; break;
+  }
+}
+
+void GetDirectionSinCos(unsigned char direction, float* sinOut, float* cosOut) {
+  *sinOut = directionSineTable[direction];
+  *cosOut = directionSineTable[direction + TRIG_DIRECTION_COUNT / 4];
+}
+
+void FastSinCosWithDirection(float angle, unsigned char direction, float* sinOut, float* cosOut) {
+  float sinAngle, cosAngle, sinDirection, cosDirection;
+  FastSinCos(angle, &sinAngle, &cosAngle);
+  GetDirectionSinCos(direction, &sinDirection, &cosDirection);
+
+  // Angle sum identities
+  *sinOut = sinAngle * cosDirection + cosAngle * sinDirection;
+  *cosOut = cosAngle * cosDirection - sinAngle * sinDirection;
+}
+
+
+float sinKernel(float x) {
+  // Minimax polynomial from the Cephes library
+  float z = x * x;
+  return ((-1.9515295891e-4f * z + 8.3321608736e-3f) * z - 1.6666654611e-1f) * z * x + x;
+}
+
+float cosKernel(float x) {
+  // Minimax polynomial from the Cephes library
+  float z = x * x;
+  return ((2.443315711809948e-5f * z - 1.388731625493765e-3f) * z + 4.166664568298827e-2f) * z * z - 0.5f * z + 1.0f;
+}
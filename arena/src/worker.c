@@ -1,11 +1,15 @@
 #include "arena/worker.h"
-//#include "utilities/sleep.h"
+#include <time.h>
 
 
 void* workerThread(void* arg);
 
+// Waits on the worker's wake condition until it is woken or the given number of nanoseconds have passed.
+// Waits until woken if the duration is negative. Must be called while holding wakeMutex.
+void waitForWorkerWake(Worker* worker, int64_t durationNs);
 
-bool TryInitWorker(Worker* worker, void (*onStep)(void* state), void* state) {
+
+bool TryInitWorker(Worker* worker, int64_t (*onStep)(void* state), void* state) {
   *worker = (Worker){
     .onStep = onStep,
     .state = state,
@@ -13,11 +17,36 @@ bool TryInitWorker(Worker* worker, void (*onStep)(void* state), void* state) {
   if (pthread_mutex_init(&worker->stateMutex, NULL)) {
     return false;
   }
+  if (pthread_mutex_init(&worker->wakeMutex, NULL)) {
+    pthread_mutex_destroy(&worker->stateMutex);
+    return false;
+  }
+
+  // Timed waits are measured on the monotonic clock so that changes to the system time don't stall or rush the worker.
+  // macOS can't choose the clock of a condition, but waits there are relative instead.
+  #if defined(__APPLE__)
+  bool isConditionValid = !pthread_cond_init(&worker->wakeCondition, NULL);
+  #else
+  pthread_condattr_t conditionAttributes;
+  bool isConditionValid = !pthread_condattr_init(&conditionAttributes);
+  if (isConditionValid) {
+    isConditionValid = !pthread_condattr_setclock(&conditionAttributes, CLOCK_MONOTONIC)
+      && !pthread_cond_init(&worker->wakeCondition, &conditionAttributes);
+    pthread_condattr_destroy(&conditionAttributes);
+  }
+  #endif
+  if (!isConditionValid) {
+    pthread_mutex_destroy(&worker->wakeMutex);
+    pthread_mutex_destroy(&worker->stateMutex);
+    return false;
+  }
   return true;
 }
 
 void DestroyWorker(Worker* worker) {
   StopWorker(worker);
+  pthread_cond_destroy(&worker->wakeCondition);
+  pthread_mutex_destroy(&worker->wakeMutex);
   pthread_mutex_destroy(&worker->stateMutex);
   *worker = (Worker){ 0 };
 }
@@ -34,20 +63,70 @@ void StartWorker(Worker* worker) {
 void StopWorker(Worker* worker) {
   if (!worker->isThreadValid) { return; }
 
-  worker->shouldStop = true;
+  pthread_mutex_lock(&worker->wakeMutex); {
+    worker->shouldStop = true;
+    pthread_cond_signal(&worker->wakeCondition);
+  } pthread_mutex_unlock(&worker->wakeMutex);
   pthread_join(worker->thread, NULL);
   worker->isThreadValid = false;
 }
 
+void WakeWorker(Worker* worker) {
+  pthread_mutex_lock(&worker->wakeMutex); {
+    worker->isWakePending = true;
+    pthread_cond_signal(&worker->wakeCondition);
+  } pthread_mutex_unlock(&worker->wakeMutex);
+}
+
 
 void* workerThread(void* arg) {
   Worker* worker = (Worker*)arg;
-  while (!worker->shouldStop) {
-    //uint32_t waitMs;
+  bool shouldStop = false;
+  while (!shouldStop) {
+    int64_t waitNs;
     pthread_mutex_lock(&worker->stateMutex); {
-      /*waitMs =*/ worker->onStep(worker->state);
+      waitNs = worker->onStep(worker->state);
     } pthread_mutex_unlock(&worker->stateMutex);
-    //psleep(waitMs);
+
+    // Wait unless the worker was woken during the step, in which case the step may have missed what woke it
+    pthread_mutex_lock(&worker->wakeMutex); {
+      if (waitNs != 0) {
+        waitForWorkerWake(worker, waitNs);
+      }
+      worker->isWakePending = false;
+      shouldStop = worker->shouldStop;
+    } pthread_mutex_unlock(&worker->wakeMutex);
   }
   return NULL;
 }
+
+void waitForWorkerWake(Worker* worker, int64_t durationNs) {
+  if (durationNs < 0) {
+    while (!worker->isWakePending && !worker->shouldStop) {
+      pthread_cond_wait(&worker->wakeCondition, &worker->wakeMutex);
+    }
+    return;
+  }
+
+  #if defined(__APPLE__)
+  struct timespec duration = { .tv_sec = (time_t)(durationNs / 1000000000), .tv_nsec = (long)(durationNs % 1000000000) };
+  while (!worker->isWakePending && !worker->shouldStop) {
+    if (pthread_cond_timedwait_relative_np(&worker->wakeCondition, &worker->wakeMutex, &duration)) {
+      break; // Timed out
+    }
+  }
+  #else
+  // Condition waits take an absolute deadline on the condition's clock, which TryInitWorker set to the monotonic clock
+  struct timespec deadline;
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  int64_t deadlineNs = (int64_t)deadline.tv_nsec + durationNs % 1000000000;
+  deadline.tv_sec += (time_t)(durationNs / 1000000000 + deadlineNs / 1000000000);
+  deadline.tv_nsec = (long)(deadlineNs % 1000000000);
+
+  while (!worker->isWakePending && !worker->shouldStop) {
+    if (pthread_cond_timedwait(&worker->wakeCondition, &worker->wakeMutex, &deadline)) {
+      break; // Timed out
+    }
+  }
+  #endif
+}
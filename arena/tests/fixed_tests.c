@@ -0,0 +1,49 @@
+#include <unity.h>
+#include <math.h>
+#include "arena/fixed.h"
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+#pragma region FixedFromFloat
+
+void test_FixedFromFloat_should_truncateTowardsZero_when_valueIsInRange() {
+  // Arrange
+  float values[] = { 0.0f, 1.5f, -1.5f, 32767.99f, -32767.99f, 1.0f / 131072.0f };
+  Fixed expectedValues[] = { 0, 98304, -98304, 2147483008, -2147483008, 0 };
+
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    // Act
+    Fixed value = FixedFromFloat(values[i]);
+
+    // Assert
+    TEST_ASSERT_EQUAL_INT64(expectedValues[i], value);
+  }
+}
+
+void test_FixedFromFloat_should_saturate_when_valueIsOutOfRange() {
+  // Arrange
+  float values[] = { 32768.0f, -32768.0f, 1e9f, -1e9f, INFINITY, -INFINITY };
+  Fixed expectedValues[] = { FIXED_MAX, -FIXED_MAX, FIXED_MAX, -FIXED_MAX, FIXED_MAX, -FIXED_MAX };
+
+  for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+    // Act
+    Fixed value = FixedFromFloat(values[i]);
+
+    // Assert
+    TEST_ASSERT_EQUAL_INT64(expectedValues[i], value);
+  }
+}
+
+void test_FixedFromFloat_should_returnZero_when_valueIsNaN() {
+  // Act
+  Fixed value = FixedFromFloat(NAN);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(0, value);
+}
+
+#pragma endregion
@@ -0,0 +1,183 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena/map.h"
+#include "utilities/file.h"
+
+// The file that binary maps are saved to and loaded from, relative to the directory the tests run in.
+#define MAP_TEST_FILE_PATH "map_tests.emap"
+
+// Maps hold their index inline, which is too large to keep on the stack.
+ArenaMap expectedMap, actualMap;
+FileBytes mapBytes;
+
+// Loads the default map from its text file.
+void loadDefaultTextMap(ArenaMap* mapOut) {
+  ArenaMapError error;
+  TEST_ASSERT_TRUE(TryLoadArenaMap(ARENA_RESOURCES_DIR "/maps/default.map", mapOut, &error));
+}
+
+// Saves a map in its binary form and reads back the bytes of the file.
+void saveBinaryMap(const ArenaMap* map) {
+  TEST_ASSERT_TRUE(TrySaveArenaMapBinary(map, MAP_TEST_FILE_PATH));
+  TEST_ASSERT_TRUE(TryReadAllBytes(MAP_TEST_FILE_PATH, &mapBytes));
+}
+
+void assertSameArenaMap(const ArenaMap* expected, const ArenaMap* actual) {
+  TEST_ASSERT_EQUAL_FLOAT(expected->boundary.x, actual->boundary.x);
+  TEST_ASSERT_EQUAL_FLOAT(expected->boundary.y, actual->boundary.y);
+  TEST_ASSERT_EQUAL_FLOAT(expected->boundary.width, actual->boundary.width);
+  TEST_ASSERT_EQUAL_FLOAT(expected->boundary.height, actual->boundary.height);
+
+  TEST_ASSERT_EQUAL(expected->obstacleCount, actual->obstacleCount);
+  for (unsigned int i = 0; i < expected->obstacleCount; i++) {
+    const MapObstacle* expectedObstacle = &expected->obstacles[i];
+    const MapObstacle* actualObstacle = &actual->obstacles[i];
+    TEST_ASSERT_EQUAL_FLOAT(expectedObstacle->position.x, actualObstacle->position.x);
+    TEST_ASSERT_EQUAL_FLOAT(expectedObstacle->position.y, actualObstacle->position.y);
+    TEST_ASSERT_EQUAL_FLOAT(expectedObstacle->rotation, actualObstacle->rotation);
+    TEST_ASSERT_EQUAL(expectedObstacle->collider.kind, actualObstacle->collider.kind);
+    if (expectedObstacle->collider.kind == PHYSICS_COLLIDER_CIRCLE) {
+      TEST_ASSERT_EQUAL_FLOAT(expectedObstacle->collider.radius, actualObstacle->collider.radius);
+    } else {
+      TEST_ASSERT_EQUAL_FLOAT(expectedObstacle->collider.widthHeight.x, actualObstacle->collider.widthHeight.x);
+      TEST_ASSERT_EQUAL_FLOAT(expectedObstacle->collider.widthHeight.y, actualObstacle->collider.widthHeight.y);
+    }
+  }
+
+  TEST_ASSERT_EQUAL(expected->spawnCount, actual->spawnCount);
+  for (unsigned int i = 0; i < expected->spawnCount; i++) {
+    TEST_ASSERT_EQUAL_FLOAT(expected->spawns[i].position.x, actual->spawns[i].position.x);
+    TEST_ASSERT_EQUAL_FLOAT(expected->spawns[i].position.y, actual->spawns[i].position.y);
+    TEST_ASSERT_EQUAL_FLOAT(expected->spawns[i].rotation, actual->spawns[i].rotation);
+  }
+}
+
+void setUp() {
+  mapBytes = (FileBytes){ 0 };
+}
+
+void tearDown() {
+  ReleaseFileBytes(&mapBytes);
+  remove(MAP_TEST_FILE_PATH);
+}
+
+#pragma region TryParseArenaMapText
+
+void test_TryParseArenaMapText_should_fail_when_spawnIsOutOfBounds() {
+  // Arrange
+  const char* text =
+    "boundary -500 -500 1000 1000\n"
+    "spawn -400 0\n"
+    "spawn 600 0 180\n";
+
+  // Act
+  ArenaMapError error;
+  bool isParsed = TryParseArenaMapText(text, strlen(text), &actualMap, &error);
+
+  // Assert
+  TEST_ASSERT_FALSE(isParsed);
+  TEST_ASSERT_EQUAL_PTR(MAP_SPAWN_OUT_OF_BOUNDS, error.message);
+}
+
+void test_TryParseArenaMapText_should_fail_when_spawnsAreFewerThanRobots() {
+  // Arrange
+  const char* text =
+    "boundary -500 -500 1000 1000\n"
+    "spawn -400 0\n";
+
+  // Act
+  ArenaMapError error;
+  bool isParsed = TryParseArenaMapText(text, strlen(text), &actualMap, &error);
+
+  // Assert
+  TEST_ASSERT_FALSE(isParsed);
+  TEST_ASSERT_EQUAL_PTR(MAP_TOO_FEW_SPAWNS, error.message);
+}
+
+#pragma endregion
+
+#pragma region TryReadArenaMapBinary
+
+void test_TryReadArenaMapBinary_should_matchTextMap_when_defaultMapIsSavedAsBinary() {
+  // Arrange
+  loadDefaultTextMap(&expectedMap);
+  saveBinaryMap(&expectedMap);
+
+  // Act
+  ArenaMapError error;
+  bool isRead = TryReadArenaMapBinary(mapBytes.bytes, mapBytes.length, &actualMap, &error);
+
+  // Assert
+  TEST_ASSERT_TRUE(isRead);
+  assertSameArenaMap(&expectedMap, &actualMap);
+  TEST_ASSERT_FALSE(actualMap.hasDistanceField);
+}
+
+void test_TryReadArenaMapBinary_should_keepIndex_when_mapWasBaked() {
+  // Arrange
+  loadDefaultTextMap(&expectedMap);
+  BakeArenaMapDistanceField(&expectedMap);
+  TEST_ASSERT_TRUE(expectedMap.hasDistanceField);
+  saveBinaryMap(&expectedMap);
+
+  // Act
+  ArenaMapError error;
+  bool isRead = TryReadArenaMapBinary(mapBytes.bytes, mapBytes.length, &actualMap, &error);
+
+  // Assert
+  TEST_ASSERT_TRUE(isRead);
+  assertSameArenaMap(&expectedMap, &actualMap);
+  TEST_ASSERT_TRUE(actualMap.hasDistanceField);
+  const PhysicsDistanceField* expectedField = &expectedMap.distanceField;
+  const PhysicsDistanceField* actualField = &actualMap.distanceField;
+  TEST_ASSERT_EQUAL(expectedField->columnCount, actualField->columnCount);
+  TEST_ASSERT_EQUAL(expectedField->rowCount, actualField->rowCount);
+  TEST_ASSERT_EQUAL_MEMORY(expectedField->distances, actualField->distances, expectedField->columnCount * expectedField->rowCount * sizeof(float));
+}
+
+void test_TryReadArenaMapBinary_should_fail_when_obstaclesDifferFromIndex() {
+  // Arrange
+  loadDefaultTextMap(&expectedMap);
+  BakeArenaMapDistanceField(&expectedMap);
+  saveBinaryMap(&expectedMap);
+  uint8_t* bytes = malloc(mapBytes.length);
+  TEST_ASSERT_NOT_NULL(bytes);
+  memcpy(bytes, mapBytes.bytes, mapBytes.length);
+  // The first obstacle's x position follows the magic, version, flags, geometry hash, boundary, counts and its kind
+  size_t positionOffset = strlen(MAP_BINARY_MAGIC) + 2 * sizeof(uint32_t) + sizeof(uint64_t) + 7 * sizeof(uint32_t);
+  float positionX;
+  memcpy(&positionX, &bytes[positionOffset], sizeof(positionX));
+  TEST_ASSERT_EQUAL_FLOAT(expectedMap.obstacles[0].position.x, positionX);
+  positionX += 100;
+  memcpy(&bytes[positionOffset], &positionX, sizeof(positionX));
+
+  // Act
+  ArenaMapError error;
+  bool isRead = TryReadArenaMapBinary(bytes, mapBytes.length, &actualMap, &error);
+  free(bytes);
+
+  // Assert
+  TEST_ASSERT_FALSE(isRead);
+  TEST_ASSERT_EQUAL_PTR(MAP_INDEX_MISMATCH, error.message);
+}
+
+void test_TryReadArenaMapBinary_should_fail_when_fileIsTruncated() {
+  // Arrange
+  loadDefaultTextMap(&expectedMap);
+  BakeArenaMapDistanceField(&expectedMap);
+  saveBinaryMap(&expectedMap);
+
+  for (size_t length = strlen(MAP_BINARY_MAGIC); length < mapBytes.length; length++) {
+    // Act
+    ArenaMapError error;
+    bool isRead = TryReadArenaMapBinary(mapBytes.bytes, length, &actualMap, &error);
+
+    // Assert
+    TEST_ASSERT_FALSE(isRead);
+    TEST_ASSERT_EQUAL_PTR(MAP_FILE_TRUNCATED, error.message);
+  }
+}
+
+#pragma endregion
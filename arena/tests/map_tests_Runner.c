@@ -0,0 +1,87 @@
+/* AUTOGENERATED FILE. DO NOT EDIT. */
+
+/*=======Automagically Detected Files To Include=====*/
+#include "unity.h"
+#include "arena/map.h"
+
+/*=======External Functions This Runner Calls=====*/
+extern void setUp(void);
+extern void tearDown(void);
+extern void test_TryParseArenaMapText_should_fail_when_spawnIsOutOfBounds();
+extern void test_TryParseArenaMapText_should_fail_when_spawnsAreFewerThanRobots();
+extern void test_TryReadArenaMapBinary_should_matchTextMap_when_defaultMapIsSavedAsBinary();
+extern void test_TryReadArenaMapBinary_should_keepIndex_when_mapWasBaked();
+extern void test_TryReadArenaMapBinary_should_fail_when_obstaclesDifferFromIndex();
+extern void test_TryReadArenaMapBinary_should_fail_when_fileIsTruncated();
+
+
+/*=======Mock Management=====*/
+static void CMock_Init(void)
+{
+}
+static void CMock_Verify(void)
+{
+}
+static void CMock_Destroy(void)
+{
+}
+
+/*=======Test Reset Options=====*/
+void resetTest(void);
+void resetTest(void)
+{
+  tearDown();
+  CMock_Verify();
+  CMock_Destroy();
+  CMock_Init();
+  setUp();
+}
+void verifyTest(void);
+void verifyTest(void)
+{
+  CMock_Verify();
+}
+
+/*=======Test Runner Used To Run Each Test=====*/
+static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE line_num)
+{
+    Unity.CurrentTestName = name;
+    Unity.CurrentTestLineNumber = (UNITY_UINT) line_num;
+#ifdef UNITY_USE_COMMAND_LINE_ARGS
+    if (!UnityTestMatches())
+        return;
+#endif
+    Unity.NumberOfTests++;
+    UNITY_CLR_DETAILS();
+    UNITY_EXEC_TIME_START();
+    CMock_Init();
+    if (TEST_PROTECT())
+    {
+        setUp();
+        func();
+    }
+    if (TEST_PROTECT())
+    {
+        tearDown();
+        CMock_Verify();
+    }
+    CMock_Destroy();
+    UNITY_EXEC_TIME_STOP();
+    UnityConcludeTest();
+}
+
+/*=======Parameterized Test Wrappers=====*/
+
+/*=======MAIN=====*/
+int main(void)
+{
+  UnityBegin("./arena/tests/map_tests.c");
+  run_test(test_TryParseArenaMapText_should_fail_when_spawnIsOutOfBounds, "test_TryParseArenaMapText_should_fail_when_spawnIsOutOfBounds", 68);
+  run_test(test_TryParseArenaMapText_should_fail_when_spawnsAreFewerThanRobots, "test_TryParseArenaMapText_should_fail_when_spawnsAreFewerThanRobots", 84);
+  run_test(test_TryReadArenaMapBinary_should_matchTextMap_when_defaultMapIsSavedAsBinary, "test_TryReadArenaMapBinary_should_matchTextMap_when_defaultMapIsSavedAsBinary", 103);
+  run_test(test_TryReadArenaMapBinary_should_keepIndex_when_mapWasBaked, "test_TryReadArenaMapBinary_should_keepIndex_when_mapWasBaked", 118);
+  run_test(test_TryReadArenaMapBinary_should_fail_when_obstaclesDifferFromIndex, "test_TryReadArenaMapBinary_should_fail_when_obstaclesDifferFromIndex", 140);
+  run_test(test_TryReadArenaMapBinary_should_fail_when_fileIsTruncated, "test_TryReadArenaMapBinary_should_fail_when_fileIsTruncated", 166);
+
+  return UNITY_END();
+}
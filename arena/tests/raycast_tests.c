@@ -0,0 +1,101 @@
+#include <unity.h>
+#include <math.h>
+#include "arena/map.h"
+#include "arena/raycast.h"
+#include "arena/simulation.h"
+
+// The number of random rays cast in each batch, which leaves a partly filled group of lanes at the end.
+#define RAY_COUNT 1023
+// The largest absolute difference accepted between a batched distance and the reference distance.
+#define DISTANCE_TOLERANCE 1e-3f
+
+// Simulations and worlds are too large to keep on the stack.
+Simulation simulation;
+PhysicsWorld referenceWorld;
+Vector2 origins[RAY_COUNT], directions[RAY_COUNT];
+RaycastResult results[RAY_COUNT];
+
+// Sets up the default map with its robots, baking the distance field into the simulation's world and leaving the
+// reference world without one, so that its rays are tested exactly against every body.
+void initDefaultMapWorlds() {
+  simulation = (Simulation){ .physicsWorld.useStaticDistanceField = true };
+  ArenaMap map = InitDefaultArenaMap();
+  ApplyArenaMapToSimulation(&map, &simulation);
+  referenceWorld = simulation.physicsWorld;
+  referenceWorld.useStaticDistanceField = false;
+  BakePhysicsDistanceField(&simulation.physicsWorld);
+  TEST_ASSERT_TRUE(simulation.physicsWorld.staticDistanceField.isBaked);
+}
+
+// Fills the rays with random origins within the boundary and random directions of varying length using xorshift,
+// so that every run of a seed casts the same rays. Every 16th ray has no direction.
+void initRandomRays(uint32_t seed) {
+  const Rectangle* boundary = &simulation.physicsWorld.boundary;
+  uint32_t state = seed;
+  float values[4];
+  for (size_t i = 0; i < RAY_COUNT; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      values[j] = (float)(state >> 8) / (float)(1 << 24);
+    }
+
+    origins[i] = (Vector2){ boundary->x + values[0] * boundary->width, boundary->y + values[1] * boundary->height };
+    float angle = values[2] * 2 * PI;
+    float length = i % 16 == 0 ? 0 : 0.1f + values[3] * 10;
+    directions[i] = (Vector2){ cosf(angle) * length, sinf(angle) * length };
+  }
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+#pragma region ComputeRaycastBatch
+
+void test_ComputeRaycastBatch_should_matchUnbatchedExactRaycasts_when_tracingDistanceFieldOfDefaultMap() {
+  initDefaultMapWorlds();
+  for (uint32_t seed = 1; seed <= 8; seed++) {
+    // Arrange
+    initRandomRays(seed);
+
+    // Act
+    ComputeRaycastBatch(&simulation.physicsWorld, RAY_COUNT, origins, directions, results);
+
+    // Assert
+    for (size_t i = 0; i < RAY_COUNT; i++) {
+      RaycastResult expected = ComputeRaycast(&referenceWorld, origins[i], directions[i]);
+      TEST_ASSERT_EQUAL(expected.type, results[i].type);
+      TEST_ASSERT_EQUAL_INT(expected.bodyIndex, results[i].bodyIndex);
+      if (expected.type == INTERSECTION_NONE) {
+        TEST_ASSERT_TRUE(isinf(results[i].distance));
+      } else {
+        TEST_ASSERT_FLOAT_WITHIN(DISTANCE_TOLERANCE, expected.distance, results[i].distance);
+      }
+    }
+  }
+}
+
+void test_ComputeRaycastBatch_should_matchSingleRaycasts_when_batchEndsPartWayThroughLanes() {
+  initDefaultMapWorlds();
+  for (size_t rayCount = 1; rayCount <= 7; rayCount++) {
+    // Arrange
+    initRandomRays((uint32_t)rayCount);
+
+    // Act
+    ComputeRaycastBatch(&simulation.physicsWorld, rayCount, origins, directions, results);
+
+    // Assert
+    for (size_t i = 0; i < rayCount; i++) {
+      RaycastResult expected = ComputeRaycast(&simulation.physicsWorld, origins[i], directions[i]);
+      TEST_ASSERT_EQUAL(expected.type, results[i].type);
+      TEST_ASSERT_EQUAL_INT(expected.bodyIndex, results[i].bodyIndex);
+      TEST_ASSERT_EQUAL_MEMORY(&expected.distance, &results[i].distance, sizeof(float));
+    }
+  }
+}
+
+#pragma endregion
@@ -0,0 +1,150 @@
+#include <unity.h>
+#include "arena/render_state.h"
+
+// The number of nanoseconds taken by one tick at the default speed.
+#define TICK_NANOSECONDS (TIMER_NANOSECONDS_PER_SECOND / SIMULATION_DEFAULT_TICKS_PER_SECOND)
+
+// A robot that has moved and turned between the previous and latest states.
+RenderStateHistory history;
+
+void setUp() {
+  InitRenderStateHistory(&history);
+  history.previous.tickCount = 100;
+  history.previous.ticksPerSec = SIMULATION_DEFAULT_TICKS_PER_SECOND;
+  history.previous.bodyCount = 1;
+  history.previous.bodies[0].position = (Vector2){ 0.0f, 0.0f };
+  history.previous.bodies[0].rotation = 0.0f;
+  history.previous.robotCount = 1;
+  history.previous.robots[0].position = (Vector2){ 0.0f, 0.0f };
+  history.previous.robots[0].rotation = 0.0f;
+  history.previous.robots[0].energyRemaining = 100;
+
+  history.latest = history.previous;
+  history.latest.tickCount = 164;
+  history.latest.bodies[0].position = (Vector2){ 64.0f, 32.0f };
+  history.latest.bodies[0].rotation = 1.0f;
+  history.latest.robots[0].position = (Vector2){ 64.0f, 32.0f };
+  history.latest.robots[0].rotation = 1.0f;
+  history.latest.robots[0].energyRemaining = 90;
+  history.latestTime = 1000;
+}
+
+void tearDown() {
+}
+
+#pragma region InterpolateRenderState
+
+void test_InterpolateRenderState_should_interpolatePositionsAndRotations_when_partWayBetweenStates() {
+  // Arrange
+  RenderState state;
+
+  // Act
+  InterpolateRenderState(&history, history.latestTime + 32 * TICK_NANOSECONDS, &state);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(132, state.tickCount);
+  TEST_ASSERT_EQUAL_FLOAT(32.0f, state.bodies[0].position.x);
+  TEST_ASSERT_EQUAL_FLOAT(16.0f, state.bodies[0].position.y);
+  TEST_ASSERT_EQUAL_FLOAT(0.5f, state.bodies[0].rotation);
+  TEST_ASSERT_EQUAL_FLOAT(32.0f, state.robots[0].position.x);
+  TEST_ASSERT_EQUAL_FLOAT(16.0f, state.robots[0].position.y);
+  TEST_ASSERT_EQUAL_FLOAT(0.5f, state.robots[0].rotation);
+}
+
+void test_InterpolateRenderState_should_takeOtherFieldsFromNearerState_when_partWayBetweenStates() {
+  // Arrange
+  RenderState stateNearPrevious, stateNearLatest;
+
+  // Act
+  InterpolateRenderState(&history, history.latestTime + 16 * TICK_NANOSECONDS, &stateNearPrevious);
+  InterpolateRenderState(&history, history.latestTime + 48 * TICK_NANOSECONDS, &stateNearLatest);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT(100, stateNearPrevious.robots[0].energyRemaining);
+  TEST_ASSERT_EQUAL_INT(90, stateNearLatest.robots[0].energyRemaining);
+}
+
+void test_InterpolateRenderState_should_turnTheShorterWay_when_rotationWrapsAround() {
+  // Arrange
+  history.previous.robots[0].rotation = 3.0f;
+  history.latest.robots[0].rotation = -3.0f;
+  RenderState state;
+
+  // Act
+  InterpolateRenderState(&history, history.latestTime + 32 * TICK_NANOSECONDS, &state);
+
+  // Assert
+  TEST_ASSERT_FLOAT_WITHIN(0.0001f, PI, state.robots[0].rotation);
+}
+
+void test_InterpolateRenderState_should_returnLatestState_when_timeHasPassedIt() {
+  // Arrange
+  RenderState state;
+
+  // Act
+  InterpolateRenderState(&history, history.latestTime + 100 * TICK_NANOSECONDS, &state);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(164, state.tickCount);
+  TEST_ASSERT_EQUAL_FLOAT(64.0f, state.robots[0].position.x);
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, state.robots[0].rotation);
+}
+
+void test_InterpolateRenderState_should_returnLatestState_when_paused() {
+  // Arrange
+  history.latest.ticksPerSec = 0;
+  RenderState state;
+
+  // Act
+  InterpolateRenderState(&history, history.latestTime, &state);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(164, state.tickCount);
+  TEST_ASSERT_EQUAL_FLOAT(64.0f, state.robots[0].position.x);
+}
+
+void test_InterpolateRenderState_should_returnLatestState_when_tickCountGoesBack() {
+  // Arrange
+  history.latest.tickCount = 50;
+  RenderState state;
+
+  // Act
+  InterpolateRenderState(&history, history.latestTime, &state);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(50, state.tickCount);
+  TEST_ASSERT_EQUAL_FLOAT(64.0f, state.robots[0].position.x);
+}
+
+void test_InterpolateRenderState_should_returnLatestState_when_statesAreTooFarApart() {
+  // Arrange
+  history.latest.tickCount = history.previous.tickCount + RENDER_STATE_MAX_INTERPOLATED_TICKS + 1;
+  RenderState state;
+
+  // Act
+  InterpolateRenderState(&history, history.latestTime, &state);
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(history.latest.tickCount, state.tickCount);
+  TEST_ASSERT_EQUAL_FLOAT(64.0f, state.robots[0].position.x);
+}
+
+#pragma endregion
+
+#pragma region TryAcquireNewRenderState
+
+void test_TryAcquireNewRenderState_should_returnFalse_when_nothingWasPublished() {
+  // Arrange
+  static RenderStateBuffer buffer;
+  InitRenderStateBuffer(&buffer);
+  const RenderState* state = NULL;
+
+  // Act
+  bool isAcquired = TryAcquireNewRenderState(&buffer, &state);
+
+  // Assert
+  TEST_ASSERT_FALSE(isAcquired);
+  TEST_ASSERT_NULL(state);
+}
+
+#pragma endregion
@@ -0,0 +1,91 @@
+/* AUTOGENERATED FILE. DO NOT EDIT. */
+
+/*=======Automagically Detected Files To Include=====*/
+#include "unity.h"
+#include "arena/render_state.h"
+
+/*=======External Functions This Runner Calls=====*/
+extern void setUp(void);
+extern void tearDown(void);
+extern void test_InterpolateRenderState_should_interpolatePositionsAndRotations_when_partWayBetweenStates();
+extern void test_InterpolateRenderState_should_takeOtherFieldsFromNearerState_when_partWayBetweenStates();
+extern void test_InterpolateRenderState_should_turnTheShorterWay_when_rotationWrapsAround();
+extern void test_InterpolateRenderState_should_returnLatestState_when_timeHasPassedIt();
+extern void test_InterpolateRenderState_should_returnLatestState_when_paused();
+extern void test_InterpolateRenderState_should_returnLatestState_when_tickCountGoesBack();
+extern void test_InterpolateRenderState_should_returnLatestState_when_statesAreTooFarApart();
+extern void test_TryAcquireNewRenderState_should_returnFalse_when_nothingWasPublished();
+
+
+/*=======Mock Management=====*/
+static void CMock_Init(void)
+{
+}
+static void CMock_Verify(void)
+{
+}
+static void CMock_Destroy(void)
+{
+}
+
+/*=======Test Reset Options=====*/
+void resetTest(void);
+void resetTest(void)
+{
+  tearDown();
+  CMock_Verify();
+  CMock_Destroy();
+  CMock_Init();
+  setUp();
+}
+void verifyTest(void);
+void verifyTest(void)
+{
+  CMock_Verify();
+}
+
+/*=======Test Runner Used To Run Each Test=====*/
+static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE line_num)
+{
+    Unity.CurrentTestName = name;
+    Unity.CurrentTestLineNumber = (UNITY_UINT) line_num;
+#ifdef UNITY_USE_COMMAND_LINE_ARGS
+    if (!UnityTestMatches())
+        return;
+#endif
+    Unity.NumberOfTests++;
+    UNITY_CLR_DETAILS();
+    UNITY_EXEC_TIME_START();
+    CMock_Init();
+    if (TEST_PROTECT())
+    {
+        setUp();
+        func();
+    }
+    if (TEST_PROTECT())
+    {
+        tearDown();
+        CMock_Verify();
+    }
+    CMock_Destroy();
+    UNITY_EXEC_TIME_STOP();
+    UnityConcludeTest();
+}
+
+/*=======Parameterized Test Wrappers=====*/
+
+/*=======MAIN=====*/
+int main(void)
+{
+  UnityBegin("./arena/tests/render_state_tests.c");
+  run_test(test_InterpolateRenderState_should_interpolatePositionsAndRotations_when_partWayBetweenStates, "test_InterpolateRenderState_should_interpolatePositionsAndRotations_when_partWayBetweenStates", 37);
+  run_test(test_InterpolateRenderState_should_takeOtherFieldsFromNearerState_when_partWayBetweenStates, "test_InterpolateRenderState_should_takeOtherFieldsFromNearerState_when_partWayBetweenStates", 54);
+  run_test(test_InterpolateRenderState_should_turnTheShorterWay_when_rotationWrapsAround, "test_InterpolateRenderState_should_turnTheShorterWay_when_rotationWrapsAround", 67);
+  run_test(test_InterpolateRenderState_should_returnLatestState_when_timeHasPassedIt, "test_InterpolateRenderState_should_returnLatestState_when_timeHasPassedIt", 80);
+  run_test(test_InterpolateRenderState_should_returnLatestState_when_paused, "test_InterpolateRenderState_should_returnLatestState_when_paused", 93);
+  run_test(test_InterpolateRenderState_should_returnLatestState_when_tickCountGoesBack, "test_InterpolateRenderState_should_returnLatestState_when_tickCountGoesBack", 106);
+  run_test(test_InterpolateRenderState_should_returnLatestState_when_statesAreTooFarApart, "test_InterpolateRenderState_should_returnLatestState_when_statesAreTooFarApart", 119);
+  run_test(test_TryAcquireNewRenderState_should_returnFalse_when_nothingWasPublished, "test_TryAcquireNewRenderState_should_returnFalse_when_nothingWasPublished", 136);
+
+  return UNITY_END();
+}
@@ -0,0 +1,171 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena/map.h"
+#include "arena/replay.h"
+#include "arena/simulation.h"
+#include "assembler/assemble.h"
+#include "parser/parse.h"
+#include "utilities/file.h"
+
+// The file that replays are saved to and loaded from, relative to the directory the tests run in.
+#define REPLAY_TEST_FILE_PATH "replay_tests.erpl"
+// The number of steps the recorded battle may run for, enough for it to end by elimination.
+#define BATTLE_STEPS 40000
+
+// Battles are too large to keep on the stack.
+Simulation recordedSimulation, playedBackSimulation;
+Replay recordedReplay, loadedReplay;
+
+// Sets up a battle on the default map between robots running the example programs with the given file names.
+void initExampleBattle(Simulation* simulation, const ArenaMap* map, const char* fileNameA, const char* fileNameB) {
+  *simulation = (Simulation){
+    .host.timer = InitTimer(0, 100),
+    .physicsWorld.useContinuousCollision = true,
+    .physicsWorld.useStaticDistanceField = true,
+    .instructionsPerPhysicsStep = SIMULATION_DEFAULT_INSTRUCTIONS_PER_PHYSICS_STEP,
+    .stallWindowTicks = SIMULATION_DEFAULT_STALL_WINDOW_TICKS,
+  };
+  ApplyArenaMapToSimulation(map, simulation);
+
+  const char* fileNames[] = { fileNameA, fileNameB };
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    char filePath[256];
+    snprintf(filePath, sizeof(filePath), "%s/%s", EXAMPLES_DIR, fileNames[i]);
+    TextContents text;
+    AssemblyProgram program;
+    ParsingErrorList parsingErrors = { 0 };
+    AssemblingError assemblingError = { 0 };
+    TEST_ASSERT_TRUE(TryInitTextContentsFromFile(filePath, &text));
+    TEST_ASSERT_TRUE(TryParseAssemblyProgram(&text, &program, &parsingErrors));
+    TEST_ASSERT_TRUE(TryAssembleProgram(&text, &program, simulation->robots[i].processState.memory, &assemblingError));
+    DestroyAssemblyProgram(&program);
+    DestroyTextContents(&text);
+  }
+}
+
+// Records a battle between the scanning examples to a replay and saves it.
+void recordExampleBattle() {
+  ArenaMap map = InitDefaultArenaMap();
+  initExampleBattle(&recordedSimulation, &map, "scan_turret.easm", "wander_scan.easm");
+  InitReplay(&recordedReplay, &recordedSimulation, &map);
+  ReplayRecorder recorder = InitReplayRecorder(&recordedReplay);
+  recordedSimulation.host.replayRecorder = &recorder;
+
+  PrepSimulation(&recordedSimulation);
+  for (int i = 0; i < BATTLE_STEPS && !recordedSimulation.battleEnded; i++) {
+    StepSimulation(&recordedSimulation);
+  }
+  FinishReplayRecording(&recorder, &recordedSimulation);
+  recordedSimulation.host.replayRecorder = NULL;
+
+  TEST_ASSERT_FALSE(recorder.hasFailed);
+  TEST_ASSERT_TRUE(TrySaveReplay(&recordedReplay, REPLAY_TEST_FILE_PATH));
+}
+
+// Overwrites the test file with the given bytes.
+void writeReplayTestFile(const uint8_t* bytes, size_t length) {
+  FILE* file = fopen(REPLAY_TEST_FILE_PATH, "wb");
+  TEST_ASSERT_NOT_NULL(file);
+  TEST_ASSERT_EQUAL(length, fwrite(bytes, 1, length, file));
+  TEST_ASSERT_EQUAL(0, fclose(file));
+}
+
+// Outputs a copy of the bytes of the test file, which the caller must free.
+uint8_t* readReplayTestFile(size_t* lengthOut) {
+  FileBytes contents;
+  TEST_ASSERT_TRUE(TryReadAllBytes(REPLAY_TEST_FILE_PATH, &contents));
+  uint8_t* bytes = malloc(contents.length);
+  TEST_ASSERT_NOT_NULL(bytes);
+  memcpy(bytes, contents.bytes, contents.length);
+  *lengthOut = contents.length;
+  ReleaseFileBytes(&contents);
+  return bytes;
+}
+
+void setUp() {
+  recordedReplay = (Replay){ 0 };
+  loadedReplay = (Replay){ 0 };
+}
+
+void tearDown() {
+  DestroyReplay(&recordedReplay);
+  DestroyReplay(&loadedReplay);
+  remove(REPLAY_TEST_FILE_PATH);
+}
+
+#pragma region TryLoadReplay
+
+void test_TryLoadReplay_should_playBackRecordedBattle_when_replayWasSaved() {
+  // Arrange
+  recordExampleBattle();
+  TEST_ASSERT_TRUE(recordedSimulation.battleEnded);
+
+  // Act
+  const char* error;
+  TEST_ASSERT_TRUE(TryLoadReplay(REPLAY_TEST_FILE_PATH, &loadedReplay, &error));
+  playedBackSimulation = (Simulation){
+    .host.timer = InitTimer(0, 100),
+    .physicsWorld.useContinuousCollision = true,
+    .physicsWorld.useStaticDistanceField = true,
+  };
+  ApplyReplayToSimulation(&loadedReplay, &playedBackSimulation);
+  ReplayPlayer player = InitReplayPlayer(&loadedReplay);
+  playedBackSimulation.host.replayPlayer = &player;
+  PrepSimulation(&playedBackSimulation);
+  for (int i = 0; i < BATTLE_STEPS && !playedBackSimulation.battleEnded; i++) {
+    StepSimulation(&playedBackSimulation);
+  }
+
+  // Assert
+  TEST_ASSERT_EQUAL_UINT64(recordedSimulation.tickCount, playedBackSimulation.tickCount);
+  TEST_ASSERT_TRUE(playedBackSimulation.battleEnded);
+  TEST_ASSERT_EQUAL(recordedSimulation.battleEndReason, playedBackSimulation.battleEndReason);
+  TEST_ASSERT_EQUAL(recordedSimulation.winningRobotIndex, playedBackSimulation.winningRobotIndex);
+  TEST_ASSERT_EQUAL_MEMORY(recordedSimulation.physicsWorld.bodies, playedBackSimulation.physicsWorld.bodies, sizeof(recordedSimulation.physicsWorld.bodies));
+  for (size_t i = 0; i < recordedSimulation.robotCount; i++) {
+    TEST_ASSERT_EQUAL_INT(recordedSimulation.robots[i].energyRemaining, playedBackSimulation.robots[i].energyRemaining);
+  }
+}
+
+void test_TryLoadReplay_should_fail_when_fileIsTruncated() {
+  // Arrange
+  recordExampleBattle();
+  size_t length;
+  uint8_t* bytes = readReplayTestFile(&length);
+
+  for (size_t truncatedLength = 0; truncatedLength < length; truncatedLength++) {
+    writeReplayTestFile(bytes, truncatedLength);
+
+    // Act
+    const char* error;
+    bool isLoaded = TryLoadReplay(REPLAY_TEST_FILE_PATH, &loadedReplay, &error);
+
+    // Assert
+    TEST_ASSERT_FALSE(isLoaded);
+    TEST_ASSERT_NOT_NULL(error);
+  }
+  free(bytes);
+}
+
+void test_TryLoadReplay_should_fail_when_versionIsUnsupported() {
+  // Arrange
+  recordExampleBattle();
+  size_t length;
+  uint8_t* bytes = readReplayTestFile(&length);
+  // The version follows the magic as a little-endian 32-bit integer
+  bytes[strlen(REPLAY_MAGIC)] = REPLAY_VERSION + 1;
+  writeReplayTestFile(bytes, length);
+  free(bytes);
+
+  // Act
+  const char* error;
+  bool isLoaded = TryLoadReplay(REPLAY_TEST_FILE_PATH, &loadedReplay, &error);
+
+  // Assert
+  TEST_ASSERT_FALSE(isLoaded);
+  TEST_ASSERT_EQUAL_PTR(REPLAY_UNSUPPORTED_VERSION, error);
+}
+
+#pragma endregion
@@ -0,0 +1,161 @@
+#include <unity.h>
+#include <string.h>
+#include "arena/map.h"
+#include "arena/simulation.h"
+#include "arena/thread_pool.h"
+#include "assembler/assemble.h"
+#include "parser/parse.h"
+
+// The number of steps run in each battle, enough for robots running random programs to move, turn, scan and fire.
+#define BATTLE_STEPS 3000
+
+// Battles run sequentially and through the thread pool, which are too large to keep on the stack.
+Simulation expectedSimulation, actualSimulation;
+ThreadPool threadPool;
+
+// Sets up a battle on the default map between robots running random programs generated from the seed.
+void initRandomBattle(Simulation* simulation, uint32_t seed) {
+  *simulation = (Simulation){ .host.timer = InitTimer(0, 100) };
+  ArenaMap map = InitDefaultArenaMap();
+  ApplyArenaMapToSimulation(&map, simulation);
+
+  // Fill each robot's memory using xorshift, so that every run of a seed has the same programs
+  uint32_t state = seed;
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    for (size_t j = 0; j < MEMORY_SIZE; j++) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      simulation->robots[i].processState.memory[j] = (uint8_t)state;
+    }
+  }
+  PrepSimulation(simulation);
+}
+
+// Sets up a battle on the default map between robots running the given assembly programs.
+void initProgramBattle(Simulation* simulation, const char* sourceA, const char* sourceB) {
+  *simulation = (Simulation){ .host.timer = InitTimer(0, 100), .stallWindowTicks = SIMULATION_DEFAULT_STALL_WINDOW_TICKS };
+  ArenaMap map = InitDefaultArenaMap();
+  ApplyArenaMapToSimulation(&map, simulation);
+
+  const char* sources[] = { sourceA, sourceB };
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    TextContents text = InitTextContentsAsCopyCStr(sources[i]);
+    AssemblyProgram program;
+    ParsingErrorList parsingErrors = { 0 };
+    AssemblingError assemblingError = { 0 };
+    TEST_ASSERT_TRUE(TryParseAssemblyProgram(&text, &program, &parsingErrors));
+    TEST_ASSERT_TRUE(TryAssembleProgram(&text, &program, simulation->robots[i].processState.memory, &assemblingError));
+    DestroyAssemblyProgram(&program);
+    DestroyTextContents(&text);
+  }
+  PrepSimulation(simulation);
+}
+
+void runBattle(Simulation* simulation) {
+  for (int i = 0; i < BATTLE_STEPS && !simulation->battleEnded; i++) {
+    StepSimulation(simulation);
+  }
+}
+
+void assertSameBattleState(const Simulation* expected, const Simulation* actual) {
+  TEST_ASSERT_EQUAL_UINT64(expected->tickCount, actual->tickCount);
+  TEST_ASSERT_EQUAL(expected->battleEnded, actual->battleEnded);
+  TEST_ASSERT_EQUAL_MEMORY(expected->physicsWorld.bodies, actual->physicsWorld.bodies, sizeof(expected->physicsWorld.bodies));
+  for (size_t i = 0; i < expected->robotCount; i++) {
+    TEST_ASSERT_EQUAL_INT(expected->robots[i].energyRemaining, actual->robots[i].energyRemaining);
+    TEST_ASSERT_EQUAL_MEMORY(&expected->robots[i].processState.registers, &actual->robots[i].processState.registers, sizeof(RegistersState));
+    TEST_ASSERT_EQUAL_MEMORY(expected->robots[i].processState.memory, actual->robots[i].processState.memory, MEMORY_SIZE);
+  }
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+#pragma region StepSimulation
+
+void test_StepSimulation_should_matchSequentialRun_when_robotPhasesRunOnOneThread() {
+  TEST_ASSERT_TRUE(TryInitThreadPool(&threadPool, 1));
+  for (uint32_t seed = 1; seed <= 4; seed++) {
+    // Arrange
+    initRandomBattle(&expectedSimulation, seed);
+    runBattle(&expectedSimulation);
+    initRandomBattle(&actualSimulation, seed);
+    actualSimulation.host.threadPool = &threadPool;
+    actualSimulation.host.robotsPerTask = 1;
+
+    // Act
+    runBattle(&actualSimulation);
+
+    // Assert
+    assertSameBattleState(&expectedSimulation, &actualSimulation);
+  }
+  DestroyThreadPool(&threadPool);
+}
+
+void test_StepSimulation_should_matchSequentialRun_when_robotPhasesRunOnSeveralThreads() {
+  TEST_ASSERT_TRUE(TryInitThreadPool(&threadPool, 3));
+  for (uint32_t seed = 1; seed <= 4; seed++) {
+    // Arrange
+    initRandomBattle(&expectedSimulation, seed);
+    runBattle(&expectedSimulation);
+    initRandomBattle(&actualSimulation, seed);
+    actualSimulation.host.threadPool = &threadPool;
+    actualSimulation.host.robotsPerTask = 1;
+
+    // Act
+    runBattle(&actualSimulation);
+
+    // Assert
+    assertSameBattleState(&expectedSimulation, &actualSimulation);
+  }
+  DestroyThreadPool(&threadPool);
+}
+
+void test_StepSimulation_should_notEndByStall_when_robotIsCountingInRegisters() {
+  // Arrange
+  // Counts for about two stall windows without changing memory, then drives forward
+  initProgramBattle(&actualSimulation,
+    "loop:\n"
+    "  add $x0, $x0, 1\n"
+    "  cltu $x1, $x0, 5000\n"
+    "  jmz $x1, @go\n"
+    "  jmp @loop\n"
+    "go:\n"
+    "  stb 0x7F, @move\n"
+    "  jmp @go\n"
+    "move@F000: .data 00\n",
+    "loop:\n"
+    "  jmp @loop\n");
+  Vector2 startPosition = actualSimulation.physicsWorld.bodies[actualSimulation.robots[0].physicsBodyIndex].position;
+
+  // Act
+  for (int i = 0; i < 4 * 5000 + 1000 && !actualSimulation.battleEnded; i++) {
+    StepSimulation(&actualSimulation);
+  }
+
+  // Assert
+  TEST_ASSERT_FALSE(actualSimulation.battleEnded);
+  Vector2 endPosition = actualSimulation.physicsWorld.bodies[actualSimulation.robots[0].physicsBodyIndex].position;
+  TEST_ASSERT_TRUE(startPosition.x != endPosition.x || startPosition.y != endPosition.y);
+}
+
+void test_StepSimulation_should_endByStall_when_robotStateRepeats() {
+  // Arrange
+  initProgramBattle(&actualSimulation, "loop:\n  jmp @loop\n", "loop:\n  jmp @loop\n");
+
+  // Act
+  for (uint64_t i = 0; i < 3 * SIMULATION_DEFAULT_STALL_WINDOW_TICKS && !actualSimulation.battleEnded; i++) {
+    StepSimulation(&actualSimulation);
+  }
+
+  // Assert
+  TEST_ASSERT_TRUE(actualSimulation.battleEnded);
+  TEST_ASSERT_EQUAL(BATTLE_END_STALL, actualSimulation.battleEndReason);
+  TEST_ASSERT_TRUE(actualSimulation.battleDrawn);
+}
+
+#pragma endregion
@@ -0,0 +1,166 @@
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "arena/map.h"
+#include "arena/simulation.h"
+#include "arena/snapshot.h"
+#include "assembler/assemble.h"
+#include "parser/parse.h"
+#include "utilities/file.h"
+
+// The file that snapshots are saved to and loaded from, relative to the directory the tests run in.
+#define SNAPSHOT_TEST_FILE_PATH "snapshot_tests.esnp"
+// The number of steps a battle may run for, enough for it to end by elimination.
+#define BATTLE_STEPS 40000
+// The step at which battles are saved part way through.
+#define SNAPSHOT_TICK 5000
+
+// Battles are too large to keep on the stack.
+Simulation expectedSimulation, actualSimulation;
+FileBytes snapshotBytes;
+
+// Sets up a battle on the default map between robots running the example programs with the given file names.
+void initExampleBattle(Simulation* simulation, const char* fileNameA, const char* fileNameB) {
+  *simulation = (Simulation){
+    .host.timer = InitTimer(0, 100),
+    .physicsWorld.useContinuousCollision = true,
+    .physicsWorld.useStaticDistanceField = true,
+    .instructionsPerPhysicsStep = SIMULATION_DEFAULT_INSTRUCTIONS_PER_PHYSICS_STEP,
+    .stallWindowTicks = SIMULATION_DEFAULT_STALL_WINDOW_TICKS,
+  };
+  ArenaMap map = InitDefaultArenaMap();
+  ApplyArenaMapToSimulation(&map, simulation);
+
+  const char* fileNames[] = { fileNameA, fileNameB };
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    char filePath[256];
+    snprintf(filePath, sizeof(filePath), "%s/%s", EXAMPLES_DIR, fileNames[i]);
+    TextContents text;
+    AssemblyProgram program;
+    ParsingErrorList parsingErrors = { 0 };
+    AssemblingError assemblingError = { 0 };
+    TEST_ASSERT_TRUE(TryInitTextContentsFromFile(filePath, &text));
+    TEST_ASSERT_TRUE(TryParseAssemblyProgram(&text, &program, &parsingErrors));
+    TEST_ASSERT_TRUE(TryAssembleProgram(&text, &program, simulation->robots[i].processState.memory, &assemblingError));
+    DestroyAssemblyProgram(&program);
+    DestroyTextContents(&text);
+  }
+  PrepSimulation(simulation);
+}
+
+void runBattle(Simulation* simulation, uint64_t stopTick) {
+  for (int i = 0; i < BATTLE_STEPS && !simulation->battleEnded && simulation->tickCount < stopTick; i++) {
+    StepSimulation(simulation);
+  }
+}
+
+// Saves a battle between the example programs part way through and reads back the bytes of the snapshot.
+void saveExampleBattleSnapshot() {
+  initExampleBattle(&actualSimulation, "spin_attack.easm", "wander_scan.easm");
+  runBattle(&actualSimulation, SNAPSHOT_TICK);
+  TEST_ASSERT_TRUE(TrySaveSimulationSnapshot(&actualSimulation, SNAPSHOT_TEST_FILE_PATH));
+  TEST_ASSERT_TRUE(TryReadAllBytes(SNAPSHOT_TEST_FILE_PATH, &snapshotBytes));
+}
+
+void assertSameBattleState(const Simulation* expected, const Simulation* actual) {
+  TEST_ASSERT_EQUAL_UINT64(expected->tickCount, actual->tickCount);
+  TEST_ASSERT_EQUAL(expected->battleEnded, actual->battleEnded);
+  TEST_ASSERT_EQUAL(expected->battleEndReason, actual->battleEndReason);
+  TEST_ASSERT_EQUAL_MEMORY(expected->physicsWorld.bodies, actual->physicsWorld.bodies, sizeof(expected->physicsWorld.bodies));
+  for (size_t i = 0; i < expected->robotCount; i++) {
+    TEST_ASSERT_EQUAL_INT(expected->robots[i].energyRemaining, actual->robots[i].energyRemaining);
+    TEST_ASSERT_EQUAL_MEMORY(&expected->robots[i].processState.registers, &actual->robots[i].processState.registers, sizeof(RegistersState));
+    TEST_ASSERT_EQUAL_MEMORY(expected->robots[i].processState.memory, actual->robots[i].processState.memory, MEMORY_SIZE);
+  }
+}
+
+void setUp() {
+  snapshotBytes = (FileBytes){ 0 };
+}
+
+void tearDown() {
+  ReleaseFileBytes(&snapshotBytes);
+  remove(SNAPSHOT_TEST_FILE_PATH);
+}
+
+#pragma region TryLoadSimulationSnapshot
+
+void test_TryLoadSimulationSnapshot_should_finishLikeUninterruptedRun_when_savedPartWayThrough() {
+  // Arrange
+  initExampleBattle(&expectedSimulation, "spin_attack.easm", "wander_scan.easm");
+  runBattle(&expectedSimulation, UINT64_MAX);
+  initExampleBattle(&actualSimulation, "spin_attack.easm", "wander_scan.easm");
+  runBattle(&actualSimulation, SNAPSHOT_TICK);
+  TEST_ASSERT_TRUE(TrySaveSimulationSnapshot(&actualSimulation, SNAPSHOT_TEST_FILE_PATH));
+  actualSimulation = (Simulation){ .host.timer = InitTimer(0, 100) };
+
+  // Act
+  const char* error;
+  TEST_ASSERT_TRUE(TryLoadSimulationSnapshot(SNAPSHOT_TEST_FILE_PATH, &actualSimulation, &error));
+  TEST_ASSERT_EQUAL_UINT64(SNAPSHOT_TICK, actualSimulation.tickCount);
+  runBattle(&actualSimulation, UINT64_MAX);
+
+  // Assert
+  TEST_ASSERT_TRUE(expectedSimulation.battleEnded);
+  assertSameBattleState(&expectedSimulation, &actualSimulation);
+}
+
+#pragma endregion
+
+#pragma region TryReadSimulationSnapshot
+
+void test_TryReadSimulationSnapshot_should_fail_when_layoutDiffers() {
+  // Arrange
+  saveExampleBattleSnapshot();
+  uint8_t* bytes = malloc(snapshotBytes.length);
+  TEST_ASSERT_NOT_NULL(bytes);
+  memcpy(bytes, snapshotBytes.bytes, snapshotBytes.length);
+  // The simulation size follows the magic, version and byte order mark in the header
+  uint32_t simulationSize = (uint32_t)sizeof(Simulation) + 8;
+  memcpy(&bytes[strlen(SNAPSHOT_MAGIC) + 2 * sizeof(uint32_t)], &simulationSize, sizeof(simulationSize));
+  expectedSimulation = (Simulation){ .tickCount = 1 };
+
+  // Act
+  const char* error;
+  bool isRead = TryReadSimulationSnapshot(bytes, snapshotBytes.length, &expectedSimulation, &error);
+  free(bytes);
+
+  // Assert
+  TEST_ASSERT_FALSE(isRead);
+  TEST_ASSERT_EQUAL_PTR(SNAPSHOT_INCOMPATIBLE_LAYOUT, error);
+  TEST_ASSERT_EQUAL_UINT64(1, expectedSimulation.tickCount);
+}
+
+void test_TryReadSimulationSnapshot_should_fail_when_pageMaskIsTruncated() {
+  // Arrange
+  saveExampleBattleSnapshot();
+  // The last robot's page mask comes right before its stored pages, which are the non-zero pages of its memory
+  const uint8_t* memory = actualSimulation.robots[SIMULATION_MAX_ROBOTS - 1].processState.memory;
+  size_t storedPagesLength = 0;
+  for (size_t k = 0; k < MEMORY_SIZE; k += SNAPSHOT_PAGE_SIZE) {
+    for (size_t j = k; j < k + SNAPSHOT_PAGE_SIZE; j++) {
+      if (memory[j] != 0) {
+        storedPagesLength += SNAPSHOT_PAGE_SIZE;
+        break;
+      }
+    }
+  }
+  size_t pageMaskLength = (MEMORY_SIZE / SNAPSHOT_PAGE_SIZE + 7) / 8;
+  size_t pageMaskOffset = snapshotBytes.length - storedPagesLength - pageMaskLength;
+
+  for (size_t length = pageMaskOffset; length < pageMaskOffset + pageMaskLength; length++) {
+    expectedSimulation = (Simulation){ .tickCount = 1 };
+
+    // Act
+    const char* error;
+    bool isRead = TryReadSimulationSnapshot(snapshotBytes.bytes, length, &expectedSimulation, &error);
+
+    // Assert
+    TEST_ASSERT_FALSE(isRead);
+    TEST_ASSERT_EQUAL_PTR(SNAPSHOT_FILE_TRUNCATED, error);
+    TEST_ASSERT_EQUAL_UINT64(1, expectedSimulation.tickCount);
+  }
+}
+
+#pragma endregion
@@ -0,0 +1,128 @@
+#include <unity.h>
+#include "arena/map.h"
+#include "arena/simulation.h"
+#include "arena/thread_pool.h"
+#include "arena/timeline.h"
+
+// The number of steps between keyframes, which seeks are deliberately not aligned to.
+#define KEYFRAME_INTERVAL_TICKS 256
+// The step that battles run to before seeking back.
+#define LATEST_TICK 3000
+// The step that battles seek back to.
+#define SEEK_TICK 1234
+
+// Battles are too large to keep on the stack.
+Simulation expectedSimulation, actualSimulation;
+Timeline timeline;
+ThreadPool threadPool;
+
+// Sets up a battle on the default map between robots running random programs generated from the seed.
+void initRandomBattle(Simulation* simulation, uint32_t seed) {
+  *simulation = (Simulation){ .host.timer = InitTimer(0, 100) };
+  ArenaMap map = InitDefaultArenaMap();
+  ApplyArenaMapToSimulation(&map, simulation);
+
+  // Fill each robot's memory using xorshift, so that every run of a seed has the same programs
+  uint32_t state = seed;
+  for (size_t i = 0; i < simulation->robotCount; i++) {
+    for (size_t j = 0; j < MEMORY_SIZE; j++) {
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      simulation->robots[i].processState.memory[j] = (uint8_t)state;
+    }
+  }
+  PrepSimulation(simulation);
+}
+
+void runBattle(Simulation* simulation, uint64_t stopTick) {
+  while (!simulation->battleEnded && simulation->tickCount < stopTick) {
+    StepSimulation(simulation);
+  }
+}
+
+void assertSameBattleState(const Simulation* expected, const Simulation* actual) {
+  TEST_ASSERT_EQUAL_UINT64(expected->tickCount, actual->tickCount);
+  TEST_ASSERT_EQUAL(expected->battleEnded, actual->battleEnded);
+  TEST_ASSERT_EQUAL_MEMORY(expected->physicsWorld.bodies, actual->physicsWorld.bodies, sizeof(expected->physicsWorld.bodies));
+  for (size_t i = 0; i < expected->robotCount; i++) {
+    TEST_ASSERT_EQUAL_INT(expected->robots[i].energyRemaining, actual->robots[i].energyRemaining);
+    TEST_ASSERT_EQUAL_MEMORY(&expected->robots[i].processState.registers, &actual->robots[i].processState.registers, sizeof(RegistersState));
+    TEST_ASSERT_EQUAL_MEMORY(expected->robots[i].processState.memory, actual->robots[i].processState.memory, MEMORY_SIZE);
+  }
+}
+
+void setUp() {
+  TEST_ASSERT_TRUE(TryInitTimeline(&timeline, KEYFRAME_INTERVAL_TICKS, TIMELINE_DEFAULT_MEMORY_CAP_BYTES));
+  TEST_ASSERT_TRUE(TryInitThreadPool(&threadPool, 1));
+}
+
+void tearDown() {
+  DestroyTimeline(&timeline);
+  DestroyThreadPool(&threadPool);
+}
+
+#pragma region TrySeekTimeline
+
+void test_TrySeekTimeline_should_matchFreshRun_when_seekingBack() {
+  for (uint32_t seed = 1; seed <= 4; seed++) {
+    // Arrange
+    initRandomBattle(&expectedSimulation, seed);
+    runBattle(&expectedSimulation, SEEK_TICK);
+    ClearTimeline(&timeline);
+    initRandomBattle(&actualSimulation, seed);
+    actualSimulation.host.timeline = &timeline;
+    runBattle(&actualSimulation, LATEST_TICK);
+
+    // Act
+    bool isSeeked = TrySeekTimeline(&timeline, &actualSimulation, SEEK_TICK);
+
+    // Assert
+    TEST_ASSERT_TRUE(isSeeked);
+    assertSameBattleState(&expectedSimulation, &actualSimulation);
+  }
+}
+
+void test_TrySeekTimeline_should_matchFreshRun_when_steppingForwardAfterSeekingBack() {
+  for (uint32_t seed = 1; seed <= 4; seed++) {
+    // Arrange
+    initRandomBattle(&expectedSimulation, seed);
+    runBattle(&expectedSimulation, LATEST_TICK);
+    ClearTimeline(&timeline);
+    initRandomBattle(&actualSimulation, seed);
+    actualSimulation.host.timeline = &timeline;
+    runBattle(&actualSimulation, LATEST_TICK);
+
+    // Act
+    TEST_ASSERT_TRUE(TrySeekTimeline(&timeline, &actualSimulation, SEEK_TICK));
+    runBattle(&actualSimulation, LATEST_TICK);
+
+    // Assert
+    assertSameBattleState(&expectedSimulation, &actualSimulation);
+  }
+}
+
+void test_TrySeekTimeline_should_keepHost_when_seekingBack() {
+  // Arrange
+  initRandomBattle(&actualSimulation, 1);
+  actualSimulation.host.timeline = &timeline;
+  actualSimulation.host.threadPool = &threadPool;
+  actualSimulation.host.robotsPerTask = 2;
+  runBattle(&actualSimulation, LATEST_TICK);
+  actualSimulation.host.maxSpeedSliceNanoseconds = 1000;
+  actualSimulation.host.heldUserKeys = SIMULATION_USER_KEY_FIRE;
+  SimulationHost expectedHost = actualSimulation.host;
+
+  // Act
+  TEST_ASSERT_TRUE(TrySeekTimeline(&timeline, &actualSimulation, SEEK_TICK));
+
+  // Assert
+  TEST_ASSERT_EQUAL_PTR(expectedHost.timeline, actualSimulation.host.timeline);
+  TEST_ASSERT_EQUAL_PTR(expectedHost.threadPool, actualSimulation.host.threadPool);
+  TEST_ASSERT_EQUAL(expectedHost.robotsPerTask, actualSimulation.host.robotsPerTask);
+  TEST_ASSERT_EQUAL_INT64(expectedHost.maxSpeedSliceNanoseconds, actualSimulation.host.maxSpeedSliceNanoseconds);
+  TEST_ASSERT_EQUAL(expectedHost.heldUserKeys, actualSimulation.host.heldUserKeys);
+  TEST_ASSERT_EQUAL_MEMORY(&expectedHost.timer, &actualSimulation.host.timer, sizeof(Timer));
+}
+
+#pragma endregion
@@ -0,0 +1,81 @@
+/* AUTOGENERATED FILE. DO NOT EDIT. */
+
+/*=======Automagically Detected Files To Include=====*/
+#include "unity.h"
+#include "arena/timeline.h"
+
+/*=======External Functions This Runner Calls=====*/
+extern void setUp(void);
+extern void tearDown(void);
+extern void test_TrySeekTimeline_should_matchFreshRun_when_seekingBack();
+extern void test_TrySeekTimeline_should_matchFreshRun_when_steppingForwardAfterSeekingBack();
+extern void test_TrySeekTimeline_should_keepHost_when_seekingBack();
+
+
+/*=======Mock Management=====*/
+static void CMock_Init(void)
+{
+}
+static void CMock_Verify(void)
+{
+}
+static void CMock_Destroy(void)
+{
+}
+
+/*=======Test Reset Options=====*/
+void resetTest(void);
+void resetTest(void)
+{
+  tearDown();
+  CMock_Verify();
+  CMock_Destroy();
+  CMock_Init();
+  setUp();
+}
+void verifyTest(void);
+void verifyTest(void)
+{
+  CMock_Verify();
+}
+
+/*=======Test Runner Used To Run Each Test=====*/
+static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE line_num)
+{
+    Unity.CurrentTestName = name;
+    Unity.CurrentTestLineNumber = (UNITY_UINT) line_num;
+#ifdef UNITY_USE_COMMAND_LINE_ARGS
+    if (!UnityTestMatches())
+        return;
+#endif
+    Unity.NumberOfTests++;
+    UNITY_CLR_DETAILS();
+    UNITY_EXEC_TIME_START();
+    CMock_Init();
+    if (TEST_PROTECT())
+    {
+        setUp();
+        func();
+    }
+    if (TEST_PROTECT())
+    {
+        tearDown();
+        CMock_Verify();
+    }
+    CMock_Destroy();
+    UNITY_EXEC_TIME_STOP();
+    UnityConcludeTest();
+}
+
+/*=======Parameterized Test Wrappers=====*/
+
+/*=======MAIN=====*/
+int main(void)
+{
+  UnityBegin("./arena/tests/timeline_tests.c");
+  run_test(test_TrySeekTimeline_should_matchFreshRun_when_seekingBack, "test_TrySeekTimeline_should_matchFreshRun_when_seekingBack", 67);
+  run_test(test_TrySeekTimeline_should_matchFreshRun_when_steppingForwardAfterSeekingBack, "test_TrySeekTimeline_should_matchFreshRun_when_steppingForwardAfterSeekingBack", 86);
+  run_test(test_TrySeekTimeline_should_keepHost_when_seekingBack, "test_TrySeekTimeline_should_keepHost_when_seekingBack", 105);
+
+  return UNITY_END();
+}
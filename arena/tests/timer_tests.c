@@ -0,0 +1,237 @@
+#include <unity.h>
+#include "arena/timer.h"
+
+// The number of nanoseconds in one frame at 60 frames per second, rounded up.
+#define FRAME_NANOSECONDS 16666667
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+#pragma region GetTimerTicks
+
+void test_GetTimerTicks_should_returnZero_when_timeHasNotPassed() {
+  // Arrange
+  Timer timer = InitTimerWithSource(1024, 100, InitVirtualTimeSource());
+
+  // Act
+  int64_t ticks = GetTimerTicks(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(0, ticks);
+}
+
+void test_GetTimerTicks_should_returnZero_when_stopped() {
+  // Arrange
+  Timer timer = InitTimerWithSource(0, 100, InitVirtualTimeSource());
+  AdvanceTimeSource(&timer.source, 10LL * TIMER_NANOSECONDS_PER_SECOND);
+
+  // Act
+  int64_t ticks = GetTimerTicks(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(0, ticks);
+}
+
+void test_GetTimerTicks_should_countTicksAtRate_when_timePasses() {
+  // Arrange
+  Timer timer = InitTimerWithSource(1024, 2000, InitVirtualTimeSource());
+  AdvanceTimeSource(&timer.source, TIMER_NANOSECONDS_PER_SECOND + TIMER_NANOSECONDS_PER_SECOND / 2);
+
+  // Act
+  int64_t ticks = GetTimerTicks(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(1536, ticks);
+}
+
+void test_GetTimerTicks_should_notDrift_when_updatedInUnevenSteps() {
+  // Arrange
+  Timer timer = InitTimerWithSource(1024, 100, InitFixedStepTimeSource(FRAME_NANOSECONDS));
+  int64_t totalTicks = 0;
+
+  // Act
+  for (int i = 0; i < 60 * 60; i++) {
+    int64_t ticks = GetTimerTicks(&timer);
+    AddTimerTicks(&timer, -ticks);
+    totalTicks += ticks;
+  }
+
+  // Assert
+  int64_t expectedTicks = (int64_t)60 * 60 * FRAME_NANOSECONDS * 1024 / TIMER_NANOSECONDS_PER_SECOND;
+  TEST_ASSERT_EQUAL_INT64(expectedTicks, totalTicks);
+}
+
+void test_GetTimerTicks_should_notDrift_when_ticksAreLongerThanSteps() {
+  // Arrange
+  Timer timer = InitTimerWithSource(3, 100, InitFixedStepTimeSource(1000));
+  int64_t totalTicks = 0;
+
+  // Act
+  for (int i = 0; i < 1000000; i++) {
+    int64_t ticks = GetTimerTicks(&timer);
+    AddTimerTicks(&timer, -ticks);
+    totalTicks += ticks;
+  }
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(3, totalTicks);
+}
+
+void test_GetTimerTicks_should_holdAtMostMaxTicks_when_fallingBehind() {
+  // Arrange
+  Timer timer = InitTimerWithSource(1024, 100, InitVirtualTimeSource());
+  AdvanceTimeSource(&timer.source, TIMER_NANOSECONDS_PER_SECOND);
+
+  // Act
+  int64_t ticks = GetTimerTicks(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(100, ticks);
+}
+
+void test_GetTimerTicks_should_dropTicksBeyondMaxTicks_when_fallingBehind() {
+  // Arrange
+  Timer timer = InitTimerWithSource(1024, 100, InitVirtualTimeSource());
+  AdvanceTimeSource(&timer.source, TIMER_NANOSECONDS_PER_SECOND);
+  AddTimerTicks(&timer, -GetTimerTicks(&timer));
+  AdvanceTimeSource(&timer.source, TIMER_NANOSECONDS_PER_SECOND / 1024 + 1);
+
+  // Act
+  int64_t ticks = GetTimerTicks(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(1, ticks);
+}
+
+void test_GetTimerTicks_should_returnMaxTicks_when_rateIsUnbounded() {
+  // Arrange
+  Timer timer = InitTimerWithSource(INT64_MAX, 100, InitFixedStepTimeSource(1));
+
+  for (int i = 0; i < 3; i++) {
+    // Act
+    int64_t ticks = GetTimerTicks(&timer);
+    AddTimerTicks(&timer, -ticks);
+
+    // Assert
+    TEST_ASSERT_EQUAL_INT64(100, ticks);
+  }
+}
+
+#pragma endregion
+
+#pragma region SetTimerTicksPerSec
+
+void test_SetTimerTicksPerSec_should_keepTicksAtOldRate_when_rateChanges() {
+  // Arrange
+  Timer timer = InitTimerWithSource(1024, 10000, InitVirtualTimeSource());
+  AdvanceTimeSource(&timer.source, TIMER_NANOSECONDS_PER_SECOND);
+
+  // Act
+  SetTimerTicksPerSec(&timer, 2048);
+  AdvanceTimeSource(&timer.source, TIMER_NANOSECONDS_PER_SECOND);
+  int64_t ticks = GetTimerTicks(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(1024 + 2048, ticks);
+}
+
+void test_SetTimerTicksPerSec_should_notCountPausedTime_when_resumed() {
+  // Arrange
+  Timer timer = InitTimerWithSource(1024, 10000, InitVirtualTimeSource());
+  SetTimerTicksPerSec(&timer, 0);
+  AdvanceTimeSource(&timer.source, 5LL * TIMER_NANOSECONDS_PER_SECOND);
+
+  // Act
+  SetTimerTicksPerSec(&timer, 1024);
+  AdvanceTimeSource(&timer.source, TIMER_NANOSECONDS_PER_SECOND);
+  int64_t ticks = GetTimerTicks(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(1024, ticks);
+}
+
+#pragma endregion
+
+#pragma region GetTimerNanosecondsUntilTick
+
+void test_GetTimerNanosecondsUntilTick_should_returnNegative_when_stopped() {
+  // Arrange
+  Timer timer = InitTimerWithSource(0, 100, InitVirtualTimeSource());
+
+  // Act
+  int64_t nanoseconds = GetTimerNanosecondsUntilTick(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(-1, nanoseconds);
+}
+
+void test_GetTimerNanosecondsUntilTick_should_returnZero_when_holdingTicks() {
+  // Arrange
+  Timer timer = InitTimerWithSource(1024, 100, InitVirtualTimeSource());
+  AdvanceTimeSource(&timer.source, TIMER_NANOSECONDS_PER_SECOND);
+  GetTimerTicks(&timer);
+
+  // Act
+  int64_t nanoseconds = GetTimerNanosecondsUntilTick(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(0, nanoseconds);
+}
+
+void test_GetTimerNanosecondsUntilTick_should_returnTimeWhenNextTickPasses_when_waiting() {
+  // Arrange
+  Timer timer = InitTimerWithSource(3, 100, InitVirtualTimeSource());
+  AdvanceTimeSource(&timer.source, 100);
+  GetTimerTicks(&timer);
+
+  // Act
+  int64_t nanoseconds = GetTimerNanosecondsUntilTick(&timer);
+  AdvanceTimeSource(&timer.source, nanoseconds - 1);
+  int64_t ticksBefore = GetTimerTicks(&timer);
+  AdvanceTimeSource(&timer.source, 1);
+  int64_t ticksAfter = GetTimerTicks(&timer);
+
+  // Assert
+  TEST_ASSERT_EQUAL_INT64(333333334 - 100, nanoseconds);
+  TEST_ASSERT_EQUAL_INT64(0, ticksBefore);
+  TEST_ASSERT_EQUAL_INT64(1, ticksAfter);
+}
+
+#pragma endregion
+
+#pragma region UpdateTickRateMeter
+
+void test_UpdateTickRateMeter_should_measureRate_when_windowHasPassed() {
+  // Arrange
+  TickRateMeter meter = InitTickRateMeter(TIMER_NANOSECONDS_PER_SECOND / 2, InitVirtualTimeSource(), 1000);
+  AdvanceTimeSource(&meter.source, TIMER_NANOSECONDS_PER_SECOND / 4);
+  UpdateTickRateMeter(&meter, 1500);
+  double rateBeforeWindow = meter.ticksPerSec;
+  AdvanceTimeSource(&meter.source, TIMER_NANOSECONDS_PER_SECOND / 4);
+
+  // Act
+  UpdateTickRateMeter(&meter, 2024);
+
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, rateBeforeWindow);
+  TEST_ASSERT_EQUAL_FLOAT(2048.0f, meter.ticksPerSec);
+}
+
+void test_UpdateTickRateMeter_should_startNewWindow_when_countGoesBack() {
+  // Arrange
+  TickRateMeter meter = InitTickRateMeter(TIMER_NANOSECONDS_PER_SECOND, InitVirtualTimeSource(), 5000);
+  AdvanceTimeSource(&meter.source, TIMER_NANOSECONDS_PER_SECOND / 2);
+  UpdateTickRateMeter(&meter, 1000);
+  AdvanceTimeSource(&meter.source, TIMER_NANOSECONDS_PER_SECOND);
+
+  // Act
+  UpdateTickRateMeter(&meter, 1100);
+
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(100.0f, meter.ticksPerSec);
+}
+
+#pragma endregion
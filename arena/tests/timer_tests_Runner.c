@@ -0,0 +1,105 @@
+/* AUTOGENERATED FILE. DO NOT EDIT. */
+
+/*=======Automagically Detected Files To Include=====*/
+#include "unity.h"
+#include "arena/timer.h"
+
+/*=======External Functions This Runner Calls=====*/
+extern void setUp(void);
+extern void tearDown(void);
+extern void test_GetTimerTicks_should_returnZero_when_timeHasNotPassed();
+extern void test_GetTimerTicks_should_returnZero_when_stopped();
+extern void test_GetTimerTicks_should_countTicksAtRate_when_timePasses();
+extern void test_GetTimerTicks_should_notDrift_when_updatedInUnevenSteps();
+extern void test_GetTimerTicks_should_notDrift_when_ticksAreLongerThanSteps();
+extern void test_GetTimerTicks_should_holdAtMostMaxTicks_when_fallingBehind();
+extern void test_GetTimerTicks_should_dropTicksBeyondMaxTicks_when_fallingBehind();
+extern void test_GetTimerTicks_should_returnMaxTicks_when_rateIsUnbounded();
+extern void test_SetTimerTicksPerSec_should_keepTicksAtOldRate_when_rateChanges();
+extern void test_SetTimerTicksPerSec_should_notCountPausedTime_when_resumed();
+extern void test_GetTimerNanosecondsUntilTick_should_returnNegative_when_stopped();
+extern void test_GetTimerNanosecondsUntilTick_should_returnZero_when_holdingTicks();
+extern void test_GetTimerNanosecondsUntilTick_should_returnTimeWhenNextTickPasses_when_waiting();
+extern void test_UpdateTickRateMeter_should_measureRate_when_windowHasPassed();
+extern void test_UpdateTickRateMeter_should_startNewWindow_when_countGoesBack();
+
+
+/*=======Mock Management=====*/
+static void CMock_Init(void)
+{
+}
+static void CMock_Verify(void)
+{
+}
+static void CMock_Destroy(void)
+{
+}
+
+/*=======Test Reset Options=====*/
+void resetTest(void);
+void resetTest(void)
+{
+  tearDown();
+  CMock_Verify();
+  CMock_Destroy();
+  CMock_Init();
+  setUp();
+}
+void verifyTest(void);
+void verifyTest(void)
+{
+  CMock_Verify();
+}
+
+/*=======Test Runner Used To Run Each Test=====*/
+static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE line_num)
+{
+    Unity.CurrentTestName = name;
+    Unity.CurrentTestLineNumber = (UNITY_UINT) line_num;
+#ifdef UNITY_USE_COMMAND_LINE_ARGS
+    if (!UnityTestMatches())
+        return;
+#endif
+    Unity.NumberOfTests++;
+    UNITY_CLR_DETAILS();
+    UNITY_EXEC_TIME_START();
+    CMock_Init();
+    if (TEST_PROTECT())
+    {
+        setUp();
+        func();
+    }
+    if (TEST_PROTECT())
+    {
+        tearDown();
+        CMock_Verify();
+    }
+    CMock_Destroy();
+    UNITY_EXEC_TIME_STOP();
+    UnityConcludeTest();
+}
+
+/*=======Parameterized Test Wrappers=====*/
+
+/*=======MAIN=====*/
+int main(void)
+{
+  UnityBegin("./arena/tests/timer_tests.c");
+  run_test(test_GetTimerTicks_should_returnZero_when_timeHasNotPassed, "test_GetTimerTicks_should_returnZero_when_timeHasNotPassed", 15);
+  run_test(test_GetTimerTicks_should_returnZero_when_stopped, "test_GetTimerTicks_should_returnZero_when_stopped", 26);
+  run_test(test_GetTimerTicks_should_countTicksAtRate_when_timePasses, "test_GetTimerTicks_should_countTicksAtRate_when_timePasses", 38);
+  run_test(test_GetTimerTicks_should_notDrift_when_updatedInUnevenSteps, "test_GetTimerTicks_should_notDrift_when_updatedInUnevenSteps", 50);
+  run_test(test_GetTimerTicks_should_notDrift_when_ticksAreLongerThanSteps, "test_GetTimerTicks_should_notDrift_when_ticksAreLongerThanSteps", 67);
+  run_test(test_GetTimerTicks_should_holdAtMostMaxTicks_when_fallingBehind, "test_GetTimerTicks_should_holdAtMostMaxTicks_when_fallingBehind", 83);
+  run_test(test_GetTimerTicks_should_dropTicksBeyondMaxTicks_when_fallingBehind, "test_GetTimerTicks_should_dropTicksBeyondMaxTicks_when_fallingBehind", 95);
+  run_test(test_GetTimerTicks_should_returnMaxTicks_when_rateIsUnbounded, "test_GetTimerTicks_should_returnMaxTicks_when_rateIsUnbounded", 109);
+  run_test(test_SetTimerTicksPerSec_should_keepTicksAtOldRate_when_rateChanges, "test_SetTimerTicksPerSec_should_keepTicksAtOldRate_when_rateChanges", 127);
+  run_test(test_SetTimerTicksPerSec_should_notCountPausedTime_when_resumed, "test_SetTimerTicksPerSec_should_notCountPausedTime_when_resumed", 141);
+  run_test(test_GetTimerNanosecondsUntilTick_should_returnNegative_when_stopped, "test_GetTimerNanosecondsUntilTick_should_returnNegative_when_stopped", 160);
+  run_test(test_GetTimerNanosecondsUntilTick_should_returnZero_when_holdingTicks, "test_GetTimerNanosecondsUntilTick_should_returnZero_when_holdingTicks", 171);
+  run_test(test_GetTimerNanosecondsUntilTick_should_returnTimeWhenNextTickPasses_when_waiting, "test_GetTimerNanosecondsUntilTick_should_returnTimeWhenNextTickPasses_when_waiting", 184);
+  run_test(test_UpdateTickRateMeter_should_measureRate_when_windowHasPassed, "test_UpdateTickRateMeter_should_measureRate_when_windowHasPassed", 207);
+  run_test(test_UpdateTickRateMeter_should_startNewWindow_when_countGoesBack, "test_UpdateTickRateMeter_should_startNewWindow_when_countGoesBack", 223);
+
+  return UNITY_END();
+}
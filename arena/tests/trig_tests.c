@@ -0,0 +1,133 @@
+#include <unity.h>
+#include <math.h>
+#include "arena/trig.h"
+
+// The largest absolute difference from libm that is accepted from the fast trigonometry functions.
+#define TRIG_TOLERANCE 2e-7f
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+#pragma region FastSinCos
+
+void test_FastSinCos_should_returnExactValues_when_givenZero() {
+  // Arrange
+  float sinValue, cosValue;
+
+  // Act
+  FastSinCos(0.0f, &sinValue, &cosValue);
+
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, sinValue);
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, cosValue);
+}
+
+void test_FastSinCos_should_matchLibm_when_givenAnglesWithinFewTurns() {
+  for (int i = -40000; i <= 40000; i++) {
+    // Arrange
+    float angle = i * 0.000314159f;
+    float sinValue, cosValue;
+
+    // Act
+    FastSinCos(angle, &sinValue, &cosValue);
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(TRIG_TOLERANCE, (float)sin(angle), sinValue);
+    TEST_ASSERT_FLOAT_WITHIN(TRIG_TOLERANCE, (float)cos(angle), cosValue);
+  }
+}
+
+void test_FastSinCos_should_matchLibm_when_givenLargeAngles() {
+  for (int i = -1000; i <= 1000; i++) {
+    // Arrange
+    float angle = i * 0.9973f;
+    float sinValue, cosValue;
+
+    // Act
+    FastSinCos(angle, &sinValue, &cosValue);
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(TRIG_TOLERANCE, (float)sin(angle), sinValue);
+    TEST_ASSERT_FLOAT_WITHIN(TRIG_TOLERANCE, (float)cos(angle), cosValue);
+  }
+}
+
+void test_FastSinCos_should_returnUnitVector_when_givenAnyAngle() {
+  for (int i = -1000; i <= 1000; i++) {
+    // Arrange
+    float angle = i * 0.0123f;
+    float sinValue, cosValue;
+
+    // Act
+    FastSinCos(angle, &sinValue, &cosValue);
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(4 * TRIG_TOLERANCE, 1.0f, sinValue * sinValue + cosValue * cosValue);
+  }
+}
+
+#pragma endregion
+
+#pragma region GetDirectionSinCos
+
+void test_GetDirectionSinCos_should_matchLibm_when_givenAnyDirection() {
+  for (int direction = 0; direction < TRIG_DIRECTION_COUNT; direction++) {
+    // Arrange
+    double angle = direction * (2 * M_PI / TRIG_DIRECTION_COUNT);
+    float sinValue, cosValue;
+
+    // Act
+    GetDirectionSinCos((unsigned char)direction, &sinValue, &cosValue);
+
+    // Assert
+    TEST_ASSERT_FLOAT_WITHIN(TRIG_TOLERANCE, (float)sin(angle), sinValue);
+    TEST_ASSERT_FLOAT_WITHIN(TRIG_TOLERANCE, (float)cos(angle), cosValue);
+  }
+}
+
+void test_GetDirectionSinCos_should_returnExactValues_when_givenQuarterTurns() {
+  // Arrange
+  float sinValues[4], cosValues[4];
+
+  // Act
+  for (int i = 0; i < 4; i++) {
+    GetDirectionSinCos((unsigned char)(i * TRIG_DIRECTION_COUNT / 4), &sinValues[i], &cosValues[i]);
+  }
+
+  // Assert
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, sinValues[0]);
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, cosValues[0]);
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, sinValues[1]);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, cosValues[1]);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, sinValues[2]);
+  TEST_ASSERT_EQUAL_FLOAT(-1.0f, cosValues[2]);
+  TEST_ASSERT_EQUAL_FLOAT(-1.0f, sinValues[3]);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, cosValues[3]);
+}
+
+#pragma endregion
+
+#pragma region FastSinCosWithDirection
+
+void test_FastSinCosWithDirection_should_matchLibm_when_givenAngleAndDirection() {
+  for (int i = -100; i <= 100; i++) {
+    for (int direction = 0; direction < TRIG_DIRECTION_COUNT; direction += 7) {
+      // Arrange
+      float angle = i * 0.0731f;
+      double totalAngle = angle + direction * (2 * M_PI / TRIG_DIRECTION_COUNT);
+      float sinValue, cosValue;
+
+      // Act
+      FastSinCosWithDirection(angle, (unsigned char)direction, &sinValue, &cosValue);
+
+      // Assert
+      TEST_ASSERT_FLOAT_WITHIN(2 * TRIG_TOLERANCE, (float)sin(totalAngle), sinValue);
+      TEST_ASSERT_FLOAT_WITHIN(2 * TRIG_TOLERANCE, (float)cos(totalAngle), cosValue);
+    }
+  }
+}
+
+#pragma endregion
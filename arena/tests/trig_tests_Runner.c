@@ -0,0 +1,90 @@
+/* AUTOGENERATED FILE. DO NOT EDIT. */
+
+/*=======Automagically Detected Files To Include=====*/
+#include "unity.h"
+#include <math.h>
+#include "arena/trig.h"
+
+/*=======External Functions This Runner Calls=====*/
+extern void setUp(void);
+extern void tearDown(void);
+extern void test_FastSinCos_should_returnExactValues_when_givenZero();
+extern void test_FastSinCos_should_matchLibm_when_givenAnglesWithinFewTurns();
+extern void test_FastSinCos_should_matchLibm_when_givenLargeAngles();
+extern void test_FastSinCos_should_returnUnitVector_when_givenAnyAngle();
+extern void test_GetDirectionSinCos_should_matchLibm_when_givenAnyDirection();
+extern void test_GetDirectionSinCos_should_returnExactValues_when_givenQuarterTurns();
+extern void test_FastSinCosWithDirection_should_matchLibm_when_givenAngleAndDirection();
+
+
+/*=======Mock Management=====*/
+static void CMock_Init(void)
+{
+}
+static void CMock_Verify(void)
+{
+}
+static void CMock_Destroy(void)
+{
+}
+
+/*=======Test Reset Options=====*/
+void resetTest(void);
+void resetTest(void)
+{
+  tearDown();
+  CMock_Verify();
+  CMock_Destroy();
+  CMock_Init();
+  setUp();
+}
+void verifyTest(void);
+void verifyTest(void)
+{
+  CMock_Verify();
+}
+
+/*=======Test Runner Used To Run Each Test=====*/
+static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE line_num)
+{
+    Unity.CurrentTestName = name;
+    Unity.CurrentTestLineNumber = (UNITY_UINT) line_num;
+#ifdef UNITY_USE_COMMAND_LINE_ARGS
+    if (!UnityTestMatches())
+        return;
+#endif
+    Unity.NumberOfTests++;
+    UNITY_CLR_DETAILS();
+    UNITY_EXEC_TIME_START();
+    CMock_Init();
+    if (TEST_PROTECT())
+    {
+        setUp();
+        func();
+    }
+    if (TEST_PROTECT())
+    {
+        tearDown();
+        CMock_Verify();
+    }
+    CMock_Destroy();
+    UNITY_EXEC_TIME_STOP();
+    UnityConcludeTest();
+}
+
+/*=======Parameterized Test Wrappers=====*/
+
+/*=======MAIN=====*/
+int main(void)
+{
+  UnityBegin("./arena/tests/trig_tests.c");
+  run_test(test_FastSinCos_should_returnExactValues_when_givenZero, "test_FastSinCos_should_returnExactValues_when_givenZero", 16);
+  run_test(test_FastSinCos_should_matchLibm_when_givenAnglesWithinFewTurns, "test_FastSinCos_should_matchLibm_when_givenAnglesWithinFewTurns", 28);
+  run_test(test_FastSinCos_should_matchLibm_when_givenLargeAngles, "test_FastSinCos_should_matchLibm_when_givenLargeAngles", 43);
+  run_test(test_FastSinCos_should_returnUnitVector_when_givenAnyAngle, "test_FastSinCos_should_returnUnitVector_when_givenAnyAngle", 58);
+  run_test(test_GetDirectionSinCos_should_matchLibm_when_givenAnyDirection, "test_GetDirectionSinCos_should_matchLibm_when_givenAnyDirection", 76);
+  run_test(test_GetDirectionSinCos_should_returnExactValues_when_givenQuarterTurns, "test_GetDirectionSinCos_should_returnExactValues_when_givenQuarterTurns", 91);
+  run_test(test_FastSinCosWithDirection_should_matchLibm_when_givenAngleAndDirection, "test_FastSinCosWithDirection_should_matchLibm_when_givenAngleAndDirection", 115);
+
+  return UNITY_END();
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Reads little-endian values from a buffer of bytes, failing once the end of the buffer is reached.
+typedef struct {
+  // The buffer being read.
+  const uint8_t* bytes;
+  // The number of bytes in the buffer.
+  size_t length;
+  // The offset of the next byte to read.
+  size_t offset;
+} ByteReader;
+
+// Attempts to read the given number of bytes. If successful, outputs a pointer to them within the buffer.
+bool TryReadBytes(ByteReader* reader, size_t count, const uint8_t** bytesOut);
+
+// Attempts to read an unsigned 32-bit integer.
+bool TryReadU32(ByteReader* reader, uint32_t* valueOut);
+
+// Attempts to read an unsigned 64-bit integer.
+bool TryReadU64(ByteReader* reader, uint64_t* valueOut);
+
+// Attempts to read a 32-bit float stored by its bits.
+bool TryReadF32(ByteReader* reader, float* valueOut);
+
+// Attempts to write an unsigned 32-bit integer to the current position of an open file.
+bool TryWriteU32(FILE* file, uint32_t value);
+
+// Attempts to write an unsigned 64-bit integer to the current position of an open file.
+bool TryWriteU64(FILE* file, uint64_t value);
+
+// Attempts to write a 32-bit float by its bits to the current position of an open file.
+bool TryWriteF32(FILE* file, float value);
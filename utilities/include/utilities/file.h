@@ -4,7 +4,25 @@
 #include <string.h>
 #include "utilities/text.h"
 
+// The entire contents of a file, either mapped into memory or read into a dynamically allocated buffer.
+typedef struct {
+  // The bytes of the file, or NULL if the file is empty.
+  const uint8_t* bytes;
+  // The number of bytes in the file.
+  size_t length;
+  // Whether bytes is a mapping of the file rather than an allocated buffer.
+  bool _isMapped;
+} FileBytes;
+
 // Reads the entire contents of a file into a dynamically allocated null-terminated char array.
 // Outputs the length of the char array excluding the null terminator.
 // If an error occurs, returns NULL and sets length to 0.
 char* ReadAllText(const char* filePath, size_t* length);
+
+// Attempts to get the entire contents of a file. The file is mapped into memory rather than read where the platform
+// supports it, so that a large file is loaded with a single copy. If successful, outputs the contents, which must be
+// released with ReleaseFileBytes, and returns true. Otherwise, returns false.
+bool TryReadAllBytes(const char* filePath, FileBytes* contentsOut);
+
+// Releases the contents of a file, unmapping or freeing them.
+void ReleaseFileBytes(FileBytes* contents);
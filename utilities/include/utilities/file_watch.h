@@ -0,0 +1,52 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// The number of files that one file watcher can watch.
+#define FILE_WATCHER_MAX_FILES 8
+
+// The modification time and size of a file, used to tell whether it has changed.
+typedef struct {
+  // Whether the file exists.
+  bool exists;
+  // The time that the file was last modified, in nanoseconds since the epoch. Only as precise as the platform allows.
+  int64_t modifiedTime;
+  // The size of the file in bytes.
+  int64_t size;
+} FileStamp;
+
+// Watches a set of files for changes. Where inotify is available, the directory of each file is watched so that
+// the watcher wakes as soon as the file is written or replaced. Elsewhere, the files' stamps are polled.
+typedef struct {
+  // The number of files being watched.
+  size_t fileCount;
+  // The path of each file being watched. Must outlive the watcher.
+  const char* filePaths[FILE_WATCHER_MAX_FILES];
+  // The stamp of each file as of when it was added or its last change was reported.
+  FileStamp fileStamps[FILE_WATCHER_MAX_FILES];
+  // The inotify instance, or -1 if changes are found by polling alone.
+  int _inotifyFd;
+  // The inotify watch on the directory of each file, or -1 if none.
+  int _watchDescriptors[FILE_WATCHER_MAX_FILES];
+} FileWatcher;
+
+
+// Initializes a file watcher that isn't watching any files.
+FileWatcher InitFileWatcher();
+
+// Destroys a file watcher and cleans up any system resources.
+void DestroyFileWatcher(FileWatcher* watcher);
+
+// Attempts to start watching the file at the given path, which doesn't need to exist yet.
+// If successful, outputs the index of the file in the watcher and returns true.
+// Otherwise, returns false if the watcher is already watching FILE_WATCHER_MAX_FILES files.
+bool TryAddFileToWatcher(FileWatcher* watcher, const char* filePath, size_t* indexOut);
+
+// Waits up to the specified duration in milliseconds for any of the watched files to change, returning early if
+// the platform reports a change. Returns a mask with bit i set for each file i that has changed since it was added
+// or last reported. Files that don't currently exist, such as while being replaced, aren't reported.
+uint32_t WaitForFileChanges(FileWatcher* watcher, unsigned int timeoutMs);
+
+// Reads the stamp of the file at the given path. If the file doesn't exist, the stamp is all zeroes.
+FileStamp ReadFileStamp(const char* filePath);
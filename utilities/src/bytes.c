@@ -0,0 +1,53 @@
+#include "utilities/bytes.h"
+#include <string.h>
+
+bool TryReadBytes(ByteReader* reader, size_t count, const uint8_t** bytesOut) {
+  if (reader->length - reader->offset < count) {
+    return false;
+  }
+  *bytesOut = &reader->bytes[reader->offset];
+  reader->offset += count;
+  return true;
+}
+
+bool TryReadU32(ByteReader* reader, uint32_t* valueOut) {
+  const uint8_t* bytes;
+  if (!TryReadBytes(reader, 4, &bytes)) {
+    return false;
+  }
+  *valueOut = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+  return true;
+}
+
+bool TryReadU64(ByteReader* reader, uint64_t* valueOut) {
+  uint32_t low, high;
+  if (!TryReadU32(reader, &low) || !TryReadU32(reader, &high)) {
+    return false;
+  }
+  *valueOut = (uint64_t)low | ((uint64_t)high << 32);
+  return true;
+}
+
+bool TryReadF32(ByteReader* reader, float* valueOut) {
+  uint32_t bits;
+  if (!TryReadU32(reader, &bits)) {
+    return false;
+  }
+  memcpy(valueOut, &bits, sizeof(*valueOut));
+  return true;
+}
+
+bool TryWriteU32(FILE* file, uint32_t value) {
+  uint8_t bytes[4] = { value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF };
+  return fwrite(bytes, 1, sizeof(bytes), file) == sizeof(bytes);
+}
+
+bool TryWriteU64(FILE* file, uint64_t value) {
+  return TryWriteU32(file, (uint32_t)value) && TryWriteU32(file, (uint32_t)(value >> 32));
+}
+
+bool TryWriteF32(FILE* file, float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return TryWriteU32(file, bits);
+}
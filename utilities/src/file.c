@@ -1,6 +1,14 @@
 #include "utilities/file.h"
 #include <stdio.h>
 #include <stdlib.h>
+#if defined(WIN32) || defined(__EMSCRIPTEN__)
+#define USE_FILE_READ
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 char* ReadAllText(const char* filePath, size_t* length) {
   // Open the file
@@ -35,3 +43,74 @@ char* ReadAllText(const char* filePath, size_t* length) {
   chars[*length] = '\0';
   return chars;
 }
+
+bool TryReadAllBytes(const char* filePath, FileBytes* contentsOut) {
+  *contentsOut = (FileBytes){ 0 };
+
+  #if defined(USE_FILE_READ)
+  FILE* file = fopen(filePath, "rb");
+  if (file == NULL) {
+    return false;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long length = ftell(file);
+  rewind(file);
+  if (length < 0) {
+    fclose(file);
+    return false;
+  }
+  if (length == 0) {
+    fclose(file);
+    return true;
+  }
+
+  uint8_t* bytes = malloc((size_t)length);
+  if (bytes == NULL || fread(bytes, 1, (size_t)length, file) != (size_t)length) {
+    free(bytes);
+    fclose(file);
+    return false;
+  }
+
+  fclose(file);
+  *contentsOut = (FileBytes){ .bytes = bytes, .length = (size_t)length };
+  return true;
+  #else
+  int fileDescriptor = open(filePath, O_RDONLY);
+  if (fileDescriptor < 0) {
+    return false;
+  }
+
+  struct stat fileStat;
+  if (fstat(fileDescriptor, &fileStat) != 0) {
+    close(fileDescriptor);
+    return false;
+  }
+  if (fileStat.st_size == 0) {
+    close(fileDescriptor);
+    return true; // Empty files can't be mapped
+  }
+
+  size_t length = (size_t)fileStat.st_size;
+  void* mapping = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+  close(fileDescriptor);
+  if (mapping == MAP_FAILED) {
+    return false;
+  }
+
+  *contentsOut = (FileBytes){ .bytes = mapping, .length = length, ._isMapped = true };
+  return true;
+  #endif
+}
+
+void ReleaseFileBytes(FileBytes* contents) {
+  #if !defined(USE_FILE_READ)
+  if (contents->_isMapped) {
+    munmap((void*)contents->bytes, contents->length);
+    *contents = (FileBytes){ 0 };
+    return;
+  }
+  #endif
+  free((void*)contents->bytes);
+  *contents = (FileBytes){ 0 };
+}
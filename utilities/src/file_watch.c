@@ -0,0 +1,156 @@
+#include "utilities/file_watch.h"
+#include <string.h>
+#include <sys/stat.h>
+#include "utilities/sleep.h"
+
+#if defined(__linux__) && !defined(__EMSCRIPTEN__)
+#include <limits.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#define USE_INOTIFY
+#endif
+
+
+_Static_assert(FILE_WATCHER_MAX_FILES <= 32, "File watcher masks must fit in 32 bits");
+
+#if defined(USE_INOTIFY)
+// Reads the pending inotify events, returning the mask of watched files that they name.
+uint32_t readFileWatcherEvents(FileWatcher* watcher);
+
+// Gets the part of a file path after its last directory separator.
+const char* getFileName(const char* filePath);
+#endif
+
+bool areFileStampsEqual(FileStamp a, FileStamp b);
+
+
+FileWatcher InitFileWatcher() {
+  FileWatcher watcher = { ._inotifyFd = -1 };
+  #if defined(USE_INOTIFY)
+  watcher._inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  #endif
+  return watcher;
+}
+
+void DestroyFileWatcher(FileWatcher* watcher) {
+  #if defined(USE_INOTIFY)
+  if (watcher->_inotifyFd >= 0) {
+    close(watcher->_inotifyFd);
+  }
+  #endif
+  *watcher = (FileWatcher){ ._inotifyFd = -1 };
+}
+
+bool TryAddFileToWatcher(FileWatcher* watcher, const char* filePath, size_t* indexOut) {
+  if (watcher->fileCount >= FILE_WATCHER_MAX_FILES) { return false; }
+
+  size_t index = watcher->fileCount;
+  watcher->fileCount++;
+  watcher->filePaths[index] = filePath;
+  watcher->fileStamps[index] = ReadFileStamp(filePath);
+  watcher->_watchDescriptors[index] = -1;
+
+  #if defined(USE_INOTIFY)
+  // Watch the file's directory rather than the file, since editors often save by replacing the file
+  if (watcher->_inotifyFd >= 0) {
+    const char* fileName = getFileName(filePath);
+    char directoryPath[PATH_MAX];
+    size_t directoryLength = (size_t)(fileName - filePath);
+    if (directoryLength == 0) {
+      strcpy(directoryPath, ".");
+    } else if (directoryLength < sizeof(directoryPath)) {
+      memcpy(directoryPath, filePath, directoryLength);
+      directoryPath[directoryLength] = '\0';
+    } else {
+      directoryPath[0] = '\0';
+    }
+    if (directoryPath[0] != '\0') {
+      // A failed watch leaves the file to be polled. Creation isn't watched since a new file is still empty or being
+      // written, and is reported once it is closed or moved into place
+      watcher->_watchDescriptors[index] = inotify_add_watch(watcher->_inotifyFd, directoryPath, IN_CLOSE_WRITE | IN_MOVED_TO);
+    }
+  }
+  #endif
+
+  *indexOut = index;
+  return true;
+}
+
+uint32_t WaitForFileChanges(FileWatcher* watcher, unsigned int timeoutMs) {
+  uint32_t changedMask = 0;
+  #if defined(USE_INOTIFY)
+  if (watcher->_inotifyFd >= 0) {
+    struct pollfd pollFd = { .fd = watcher->_inotifyFd, .events = POLLIN };
+    if (poll(&pollFd, 1, (int)timeoutMs) > 0) {
+      changedMask |= readFileWatcherEvents(watcher);
+    }
+  } else {
+    psleep(timeoutMs);
+  }
+  #else
+  psleep(timeoutMs);
+  #endif
+
+  // Compare stamps for files that couldn't be watched. Watched files are only reported through their events, since a
+  // stamp can change while the file is still being written
+  for (size_t i = 0; i < watcher->fileCount; i++) {
+    FileStamp stamp = ReadFileStamp(watcher->filePaths[i]);
+    if (watcher->_watchDescriptors[i] < 0 && !areFileStampsEqual(stamp, watcher->fileStamps[i])) {
+      changedMask |= (uint32_t)1 << i;
+    }
+    if (!stamp.exists) {
+      changedMask &= ~((uint32_t)1 << i);
+    } else if (changedMask & ((uint32_t)1 << i)) {
+      watcher->fileStamps[i] = stamp;
+    }
+  }
+  return changedMask;
+}
+
+FileStamp ReadFileStamp(const char* filePath) {
+  struct stat fileStat;
+  if (stat(filePath, &fileStat) != 0) {
+    return (FileStamp){ 0 };
+  }
+
+  FileStamp stamp = { .exists = true, .size = (int64_t)fileStat.st_size };
+  #if defined(__APPLE__)
+  stamp.modifiedTime = (int64_t)fileStat.st_mtimespec.tv_sec * 1000000000 + fileStat.st_mtimespec.tv_nsec;
+  #elif defined(__linux__) || defined(__EMSCRIPTEN__)
+  stamp.modifiedTime = (int64_t)fileStat.st_mtim.tv_sec * 1000000000 + fileStat.st_mtim.tv_nsec;
+  #else
+  stamp.modifiedTime = (int64_t)fileStat.st_mtime * 1000000000;
+  #endif
+  return stamp;
+}
+
+
+#if defined(USE_INOTIFY)
+uint32_t readFileWatcherEvents(FileWatcher* watcher) {
+  uint32_t changedMask = 0;
+  _Alignas(struct inotify_event) char buffer[4096];
+  ssize_t length;
+  while ((length = read(watcher->_inotifyFd, buffer, sizeof(buffer))) > 0) {
+    for (char* eventPtr = buffer; eventPtr < buffer + length; ) {
+      const struct inotify_event* event = (const struct inotify_event*)eventPtr;
+      for (size_t i = 0; i < watcher->fileCount; i++) {
+        if (event->len > 0 && event->wd == watcher->_watchDescriptors[i] && strcmp(event->name, getFileName(watcher->filePaths[i])) == 0) {
+          changedMask |= (uint32_t)1 << i;
+        }
+      }
+      eventPtr += sizeof(struct inotify_event) + event->len;
+    }
+  }
+  return changedMask;
+}
+
+const char* getFileName(const char* filePath) {
+  const char* separator = strrchr(filePath, '/');
+  return separator != NULL ? separator + 1 : filePath;
+}
+#endif
+
+bool areFileStampsEqual(FileStamp a, FileStamp b) {
+  return a.exists == b.exists && a.modifiedTime == b.modifiedTime && a.size == b.size;
+}